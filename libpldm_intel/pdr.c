@@ -1,22 +1,54 @@
 #include "pdr.h"
 #include "platform.h"
 #include <assert.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 
+#define PDR_TYPE_COUNT (UINT8_MAX + 1)
+#define PDR_HASH_MIN_BITS 6
+#define PDR_ARENA_BLOCK_SIZE 4096
+#define PDR_ARENA_ALIGN(x)                                                     \
+	(((x) + _Alignof(max_align_t) - 1) & ~(_Alignof(max_align_t) - 1))
+
+/* Records and their data are carved out of arena blocks so that a repository
+ * built from a terminus does one allocation per block rather than two per
+ * record, and walks over the repository stay within a few cache lines. A
+ * block is released once every record placed in it has been removed.
+ */
+struct pdr_arena_block {
+	struct pdr_arena_block *next;
+	size_t capacity;
+	size_t used;
+	uint32_t live;
+};
+
 typedef struct pldm_pdr_record {
 	uint32_t record_handle;
 	uint32_t size;
 	uint8_t *data;
 	struct pldm_pdr_record *next;
+	struct pldm_pdr_record *next_of_type;
+	struct pldm_pdr_record *hash_next;
+	struct pdr_arena_block *block;
+	uint8_t type;
 	bool is_remote;
 } pldm_pdr_record;
 
+/* The list through first/last keeps the insertion order the API exposes. On
+ * top of it, records are indexed by handle in a chained hash table and by PDR
+ * type in per-type lists that preserve the same relative order.
+ */
 typedef struct pldm_pdr {
 	uint32_t record_count;
 	uint32_t size;
 	pldm_pdr_record *first;
 	pldm_pdr_record *last;
+	pldm_pdr_record **buckets;
+	uint32_t bucket_bits;
+	pldm_pdr_record *type_first[PDR_TYPE_COUNT];
+	pldm_pdr_record *type_last[PDR_TYPE_COUNT];
+	struct pdr_arena_block *blocks;
 } pldm_pdr;
 
 static inline uint32_t get_next_record_handle(const pldm_pdr *repo,
@@ -31,6 +63,73 @@ static inline uint32_t get_next_record_handle(const pldm_pdr *repo,
 	return record->next->record_handle;
 }
 
+static inline uint32_t hash_record_handle(const pldm_pdr *repo,
+					  uint32_t record_handle)
+{
+	/* Fibonacci hashing spreads the mostly sequential handles evenly */
+	return (uint32_t)(record_handle * 2654435761u) >>
+	       (32 - repo->bucket_bits);
+}
+
+static void hash_insert(pldm_pdr *repo, pldm_pdr_record *record)
+{
+	/* Append to the chain so that, as with the list, the first record
+	 * added with a given handle is the one found for it.
+	 */
+	pldm_pdr_record **slot =
+	    &repo->buckets[hash_record_handle(repo, record->record_handle)];
+	while (*slot != NULL) {
+		slot = &(*slot)->hash_next;
+	}
+	record->hash_next = NULL;
+	*slot = record;
+}
+
+static void type_insert(pldm_pdr *repo, pldm_pdr_record *record)
+{
+	record->next_of_type = NULL;
+	if (repo->type_first[record->type] == NULL) {
+		repo->type_first[record->type] = record;
+	} else {
+		repo->type_last[record->type]->next_of_type = record;
+	}
+	repo->type_last[record->type] = record;
+}
+
+static void rehash(pldm_pdr *repo, uint32_t bucket_bits)
+{
+	assert(repo != NULL);
+
+	if (bucket_bits != repo->bucket_bits) {
+		free(repo->buckets);
+		repo->buckets =
+		    malloc(sizeof(pldm_pdr_record *) << bucket_bits);
+		assert(repo->buckets != NULL);
+		repo->bucket_bits = bucket_bits;
+	}
+	memset(repo->buckets, 0, sizeof(pldm_pdr_record *) << bucket_bits);
+
+	pldm_pdr_record *record = repo->first;
+	while (record != NULL) {
+		hash_insert(repo, record);
+		record = record->next;
+	}
+}
+
+static void rebuild_type_index(pldm_pdr *repo)
+{
+	assert(repo != NULL);
+
+	memset(repo->type_first, 0, sizeof(repo->type_first));
+	memset(repo->type_last, 0, sizeof(repo->type_last));
+
+	pldm_pdr_record *record = repo->first;
+	while (record != NULL) {
+		type_insert(repo, record);
+		record = record->next;
+	}
+}
+
 static void add_record(pldm_pdr *repo, pldm_pdr_record *record)
 {
 	assert(repo != NULL);
@@ -46,6 +145,65 @@ static void add_record(pldm_pdr *repo, pldm_pdr_record *record)
 	}
 	repo->size += record->size;
 	++repo->record_count;
+
+	type_insert(repo, record);
+	/* Keep the load factor at or below one */
+	if (repo->record_count > (UINT32_C(1) << repo->bucket_bits) &&
+	    repo->bucket_bits < 31) {
+		rehash(repo, repo->bucket_bits + 1);
+	} else {
+		hash_insert(repo, record);
+	}
+}
+
+static void *arena_alloc(pldm_pdr *repo, size_t size,
+			 struct pdr_arena_block **block_out)
+{
+	const size_t hdr_size = PDR_ARENA_ALIGN(sizeof(struct pdr_arena_block));
+	size = PDR_ARENA_ALIGN(size);
+
+	struct pdr_arena_block *block = repo->blocks;
+	if (block == NULL || block->capacity - block->used < size) {
+		size_t capacity = PDR_ARENA_BLOCK_SIZE - hdr_size;
+		if (size > capacity) {
+			capacity = size;
+		}
+		block = malloc(hdr_size + capacity);
+		assert(block != NULL);
+		block->capacity = capacity;
+		block->used = 0;
+		block->live = 0;
+		block->next = repo->blocks;
+		repo->blocks = block;
+	}
+
+	void *mem = (uint8_t *)block + hdr_size + block->used;
+	block->used += size;
+	++block->live;
+	*block_out = block;
+
+	return mem;
+}
+
+static void arena_release(pldm_pdr *repo, struct pdr_arena_block *block)
+{
+	assert(block->live != 0);
+	if (--block->live != 0) {
+		return;
+	}
+
+	/* The block currently allocated from is recycled in place */
+	if (block == repo->blocks) {
+		block->used = 0;
+		return;
+	}
+
+	struct pdr_arena_block *prev = repo->blocks;
+	while (prev->next != block) {
+		prev = prev->next;
+	}
+	prev->next = block->next;
+	free(block);
 }
 
 static inline uint32_t get_new_record_handle(const pldm_pdr *repo)
@@ -58,36 +216,47 @@ static inline uint32_t get_new_record_handle(const pldm_pdr *repo)
 	return last_used_hdl + 1;
 }
 
-static pldm_pdr_record *make_new_record(const pldm_pdr *repo,
-					const uint8_t *data, uint32_t size,
-					uint32_t record_handle, bool is_remote)
+static pldm_pdr_record *make_new_record(pldm_pdr *repo, const uint8_t *data,
+					uint32_t size, uint32_t record_handle,
+					bool is_remote)
 {
 	assert(repo != NULL);
 	assert(size != 0);
 
-	pldm_pdr_record *record = malloc(sizeof(pldm_pdr_record));
-	assert(record != NULL);
+	struct pdr_arena_block *block = NULL;
+	pldm_pdr_record *record = arena_alloc(
+	    repo, PDR_ARENA_ALIGN(sizeof(pldm_pdr_record)) + size, &block);
 	record->record_handle =
 	    record_handle == 0 ? get_new_record_handle(repo) : record_handle;
 	record->size = size;
 	record->is_remote = is_remote;
-	if (data != NULL) {
-		record->data = malloc(size);
-		assert(record->data != NULL);
+	record->block = block;
+	record->data =
+	    (uint8_t *)record + PDR_ARENA_ALIGN(sizeof(pldm_pdr_record));
+	/* Without data the record is left zeroed, to be filled in later */
+	record->type = 0;
+	if (data == NULL) {
+		memset(record->data, 0, size);
+	} else {
 		memcpy(record->data, data, size);
-		/* If record handle is 0, that is an indication for this API to
-		 * compute a new handle. For that reason, the computed handle
-		 * needs to be populated in the PDR header. For a case where the
-		 * caller supplied the record handle, it would exist in the
-		 * header already.
-		 */
+	}
+	/* If record handle is 0, that is an indication for this API to
+	 * compute a new handle. For that reason, the computed handle
+	 * needs to be populated in the PDR header. For a case where the
+	 * caller supplied the record handle, it would exist in the
+	 * header already. Records too short for a header have no type.
+	 */
+	if (data != NULL && size >= sizeof(struct pldm_pdr_hdr)) {
+		struct pldm_pdr_hdr *hdr =
+		    (struct pldm_pdr_hdr *)(record->data);
 		if (!record_handle) {
-			struct pldm_pdr_hdr *hdr =
-			    (struct pldm_pdr_hdr *)(record->data);
 			hdr->record_handle = htole32(record->record_handle);
 		}
+		record->type = hdr->type;
 	}
 	record->next = NULL;
+	record->next_of_type = NULL;
+	record->hash_next = NULL;
 
 	return record;
 }
@@ -113,6 +282,11 @@ pldm_pdr *pldm_pdr_init()
 	repo->size = 0;
 	repo->first = NULL;
 	repo->last = NULL;
+	repo->blocks = NULL;
+	repo->buckets = NULL;
+	repo->bucket_bits = 0;
+	rehash(repo, PDR_HASH_MIN_BITS);
+	rebuild_type_index(repo);
 
 	return repo;
 }
@@ -121,16 +295,13 @@ void pldm_pdr_destroy(pldm_pdr *repo)
 {
 	assert(repo != NULL);
 
-	pldm_pdr_record *record = repo->first;
-	while (record != NULL) {
-		pldm_pdr_record *next = record->next;
-		if (record->data) {
-			free(record->data);
-			record->data = NULL;
-		}
-		free(record);
-		record = next;
+	struct pdr_arena_block *block = repo->blocks;
+	while (block != NULL) {
+		struct pdr_arena_block *next = block->next;
+		free(block);
+		block = next;
 	}
+	free(repo->buckets);
 	free(repo);
 }
 
@@ -147,7 +318,8 @@ const pldm_pdr_record *pldm_pdr_find_record(const pldm_pdr *repo,
 	if (!record_handle && (repo->first != NULL)) {
 		record_handle = repo->first->record_handle;
 	}
-	pldm_pdr_record *record = repo->first;
+	pldm_pdr_record *record =
+	    repo->buckets[hash_record_handle(repo, record_handle)];
 	while (record != NULL) {
 		if (record->record_handle == record_handle) {
 			*size = record->size;
@@ -156,7 +328,7 @@ const pldm_pdr_record *pldm_pdr_find_record(const pldm_pdr *repo,
 			    get_next_record_handle(repo, record);
 			return record;
 		}
-		record = record->next;
+		record = record->hash_next;
 	}
 
 	*size = 0;
@@ -195,20 +367,23 @@ pldm_pdr_find_record_by_type(const pldm_pdr *repo, uint8_t pdr_type,
 {
 	assert(repo != NULL);
 
-	pldm_pdr_record *record = repo->first;
-	if (curr_record != NULL) {
+	pldm_pdr_record *record = NULL;
+	if (curr_record == NULL) {
+		record = repo->type_first[pdr_type];
+	} else if (curr_record->type == pdr_type) {
+		record = curr_record->next_of_type;
+	} else {
 		record = curr_record->next;
+		while (record != NULL && record->type != pdr_type) {
+			record = record->next;
+		}
 	}
-	while (record != NULL) {
-		struct pldm_pdr_hdr *hdr = (struct pldm_pdr_hdr *)record->data;
-		if (hdr->type == pdr_type) {
-			if (data && size) {
-				*size = record->size;
-				*data = record->data;
-			}
-			return record;
+	if (record != NULL) {
+		if (data && size) {
+			*size = record->size;
+			*data = record->data;
 		}
-		record = record->next;
+		return record;
 	}
 
 	if (size) {
@@ -621,12 +796,9 @@ void pldm_pdr_remove_remote_pdrs(pldm_pdr *repo)
 			if (repo->last == record) {
 				repo->last = prev;
 			}
-			if (record->data) {
-				free(record->data);
-			}
 			--repo->record_count;
 			repo->size -= record->size;
-			free(record);
+			arena_release(repo, record->block);
 			removed = true;
 		} else {
 			prev = record;
@@ -639,14 +811,13 @@ void pldm_pdr_remove_remote_pdrs(pldm_pdr *repo)
 		uint32_t record_handle = 0;
 		while (record != NULL) {
 			record->record_handle = ++record_handle;
-			if (record->data != NULL) {
-				struct pldm_pdr_hdr *hdr =
-				    (struct pldm_pdr_hdr *)(record->data);
-				hdr->record_handle =
-				    htole32(record->record_handle);
-			}
+			struct pldm_pdr_hdr *hdr =
+			    (struct pldm_pdr_hdr *)(record->data);
+			hdr->record_handle = htole32(record->record_handle);
 			record = record->next;
 		}
+		rehash(repo, repo->bucket_bits);
+		rebuild_type_index(repo);
 	}
 }
 
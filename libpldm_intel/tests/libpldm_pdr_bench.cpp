@@ -0,0 +1,231 @@
+#include <array>
+#include <cstdlib>
+#include <cstring>
+
+#include "../pdr.h"
+#include "../platform.h"
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+
+// Reference copy of the linked list repository that pdr.c used before it was
+// indexed, kept here so lookup and insert costs can be compared side by side
+struct ListRecord
+{
+    uint32_t recordHandle;
+    uint32_t size;
+    uint8_t* data;
+    ListRecord* next;
+};
+
+struct ListRepo
+{
+    ListRecord* first = nullptr;
+    ListRecord* last = nullptr;
+
+    ~ListRepo()
+    {
+        while (first != nullptr)
+        {
+            ListRecord* next = first->next;
+            std::free(first->data);
+            std::free(first);
+            first = next;
+        }
+    }
+
+    void add(const uint8_t* data, uint32_t size)
+    {
+        auto record = static_cast<ListRecord*>(std::malloc(sizeof(ListRecord)));
+        record->recordHandle = last != nullptr ? last->recordHandle + 1 : 1;
+        record->size = size;
+        record->data = static_cast<uint8_t*>(std::malloc(size));
+        std::memcpy(record->data, data, size);
+        reinterpret_cast<pldm_pdr_hdr*>(record->data)->record_handle =
+            htole32(record->recordHandle);
+        record->next = nullptr;
+        if (first == nullptr)
+        {
+            first = record;
+        }
+        else
+        {
+            last->next = record;
+        }
+        last = record;
+    }
+
+    const ListRecord* find(uint32_t recordHandle) const
+    {
+        for (auto record = first; record != nullptr; record = record->next)
+        {
+            if (record->recordHandle == recordHandle)
+            {
+                return record;
+            }
+        }
+        return nullptr;
+    }
+
+    const ListRecord* findByType(uint8_t type, const ListRecord* curr) const
+    {
+        auto record = curr != nullptr ? curr->next : first;
+        for (; record != nullptr; record = record->next)
+        {
+            if (reinterpret_cast<pldm_pdr_hdr*>(record->data)->type == type)
+            {
+                return record;
+            }
+        }
+        return nullptr;
+    }
+};
+
+// Mix of PDR types roughly matching a terminus with many sensors
+constexpr std::array<uint8_t, 4> pdrTypes = {
+    PLDM_NUMERIC_SENSOR_PDR, PLDM_STATE_SENSOR_PDR,
+    PLDM_SENSOR_AUXILIARY_NAMES_PDR, PLDM_PDR_ENTITY_ASSOCIATION};
+
+using PDRData = std::array<uint8_t, sizeof(pldm_pdr_hdr) + 80>;
+
+PDRData makePDR(uint32_t index)
+{
+    PDRData data{};
+    auto hdr = reinterpret_cast<pldm_pdr_hdr*>(data.data());
+    hdr->version = 1;
+    hdr->type = pdrTypes[index % pdrTypes.size()];
+    return data;
+}
+
+void fillRepo(ListRepo& repo, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        auto data = makePDR(i);
+        repo.add(data.data(), data.size());
+    }
+}
+
+void fillRepo(pldm_pdr* repo, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        auto data = makePDR(i);
+        pldm_pdr_add(repo, data.data(), data.size(), 0, true);
+    }
+}
+
+void BM_ListInsert(benchmark::State& state)
+{
+    auto count = static_cast<uint32_t>(state.range(0));
+    for (auto _ : state)
+    {
+        ListRepo repo;
+        fillRepo(repo, count);
+        benchmark::DoNotOptimize(repo.last);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+void BM_RepoInsert(benchmark::State& state)
+{
+    auto count = static_cast<uint32_t>(state.range(0));
+    for (auto _ : state)
+    {
+        auto repo = pldm_pdr_init();
+        fillRepo(repo, count);
+        benchmark::DoNotOptimize(pldm_pdr_get_record_count(repo));
+        pldm_pdr_destroy(repo);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+void BM_ListFindByHandle(benchmark::State& state)
+{
+    auto count = static_cast<uint32_t>(state.range(0));
+    ListRepo repo;
+    fillRepo(repo, count);
+    uint32_t handle = 0;
+    for (auto _ : state)
+    {
+        handle = handle % count + 1;
+        benchmark::DoNotOptimize(repo.find(handle));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_RepoFindByHandle(benchmark::State& state)
+{
+    auto count = static_cast<uint32_t>(state.range(0));
+    auto repo = pldm_pdr_init();
+    fillRepo(repo, count);
+    uint8_t* data = nullptr;
+    uint32_t size{};
+    uint32_t nextRecHdl{};
+    uint32_t handle = 0;
+    for (auto _ : state)
+    {
+        handle = handle % count + 1;
+        benchmark::DoNotOptimize(
+            pldm_pdr_find_record(repo, handle, &data, &size, &nextRecHdl));
+    }
+    state.SetItemsProcessed(state.iterations());
+    pldm_pdr_destroy(repo);
+}
+
+// Walks every record of each type, as PDRManager does when parsing a repo
+void BM_ListFindByType(benchmark::State& state)
+{
+    auto count = static_cast<uint32_t>(state.range(0));
+    ListRepo repo;
+    fillRepo(repo, count);
+    for (auto _ : state)
+    {
+        for (auto type : pdrTypes)
+        {
+            auto record = repo.findByType(type, nullptr);
+            while (record != nullptr)
+            {
+                record = repo.findByType(type, record);
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+void BM_RepoFindByType(benchmark::State& state)
+{
+    auto count = static_cast<uint32_t>(state.range(0));
+    auto repo = pldm_pdr_init();
+    fillRepo(repo, count);
+    uint8_t* data = nullptr;
+    uint32_t size{};
+    for (auto _ : state)
+    {
+        for (auto type : pdrTypes)
+        {
+            auto record = pldm_pdr_find_record_by_type(repo, type, nullptr,
+                                                       &data, &size);
+            while (record != nullptr)
+            {
+                record = pldm_pdr_find_record_by_type(repo, type, record,
+                                                      &data, &size);
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    pldm_pdr_destroy(repo);
+}
+
+} // namespace
+
+BENCHMARK(BM_ListInsert)->RangeMultiplier(8)->Range(64, 4096);
+BENCHMARK(BM_RepoInsert)->RangeMultiplier(8)->Range(64, 4096);
+BENCHMARK(BM_ListFindByHandle)->RangeMultiplier(8)->Range(64, 4096);
+BENCHMARK(BM_RepoFindByHandle)->RangeMultiplier(8)->Range(64, 4096);
+BENCHMARK(BM_ListFindByType)->RangeMultiplier(8)->Range(64, 4096);
+BENCHMARK(BM_RepoFindByType)->RangeMultiplier(8)->Range(64, 4096);
+
+BENCHMARK_MAIN();
@@ -36,6 +36,26 @@ TEST(PDRUpdate, testAdd)
     pldm_pdr_destroy(repo);
 }
 
+TEST(PDRUpdate, testAddShortRecord)
+{
+    auto repo = pldm_pdr_init();
+
+    // Shorter than a PDR header, kept as it is without a type
+    std::array<uint8_t, 3> data{0x11, 0x22, 0x33};
+    auto handle = pldm_pdr_add(repo, data.data(), data.size(), 0, false);
+    EXPECT_EQ(handle, 1u);
+
+    uint8_t* outData = nullptr;
+    uint32_t size = 0;
+    uint32_t nextRecHdl = 0;
+    ASSERT_NE(pldm_pdr_find_record(repo, handle, &outData, &size, &nextRecHdl),
+              nullptr);
+    EXPECT_EQ(size, data.size());
+    EXPECT_EQ(memcmp(outData, data.data(), data.size()), 0);
+
+    pldm_pdr_destroy(repo);
+}
+
 TEST(PDRUpdate, testRemove)
 {
     std::array<uint8_t, 10> data{};
@@ -407,6 +427,89 @@ TEST(PDRAccess, testFindByType)
     pldm_pdr_destroy(repo);
 }
 
+TEST(PDRAccess, testFindLargeRepo)
+{
+    auto repo = pldm_pdr_init();
+
+    constexpr uint32_t recordCount = 5000;
+    std::array<uint8_t, sizeof(pldm_pdr_hdr) + 600> data{};
+    pldm_pdr_hdr* hdr = reinterpret_cast<pldm_pdr_hdr*>(data.data());
+    for (uint32_t i = 1; i <= recordCount; i++)
+    {
+        hdr->type = static_cast<uint8_t>(i % 4);
+        // Odd records are remote so that removal leaves gaps in the arena
+        pldm_pdr_add(repo, data.data(), data.size(), 0, i % 2);
+    }
+    EXPECT_EQ(pldm_pdr_get_record_count(repo), recordCount);
+
+    uint8_t* outData = nullptr;
+    uint32_t size{};
+    uint32_t nextRecHdl{};
+    for (uint32_t i = 1; i <= recordCount; i++)
+    {
+        auto rec =
+            pldm_pdr_find_record(repo, i, &outData, &size, &nextRecHdl);
+        ASSERT_NE(rec, nullptr);
+        EXPECT_EQ(size, data.size());
+        EXPECT_EQ(nextRecHdl, i == recordCount ? 0 : i + 1);
+        hdr = reinterpret_cast<pldm_pdr_hdr*>(outData);
+        EXPECT_EQ(le32toh(hdr->record_handle), i);
+        EXPECT_EQ(hdr->type, i % 4);
+    }
+    EXPECT_EQ(pldm_pdr_find_record(repo, recordCount + 1, &outData, &size,
+                                   &nextRecHdl),
+              nullptr);
+
+    uint32_t typeCount = 0;
+    auto rec = pldm_pdr_find_record_by_type(repo, 3, nullptr, &outData, &size);
+    while (rec != nullptr)
+    {
+        EXPECT_EQ(pldm_pdr_get_record_handle(repo, rec) % 4, 3u);
+        typeCount++;
+        rec = pldm_pdr_find_record_by_type(repo, 3, rec, &outData, &size);
+    }
+    EXPECT_EQ(typeCount, recordCount / 4);
+
+    pldm_pdr_remove_remote_pdrs(repo);
+    EXPECT_EQ(pldm_pdr_get_record_count(repo), recordCount / 2);
+    EXPECT_EQ(pldm_pdr_get_repo_size(repo), data.size() * (recordCount / 2));
+
+    // Handles are renumbered after removal and the index follows them
+    for (uint32_t i = 1; i <= recordCount / 2; i++)
+    {
+        auto found =
+            pldm_pdr_find_record(repo, i, &outData, &size, &nextRecHdl);
+        ASSERT_NE(found, nullptr);
+        hdr = reinterpret_cast<pldm_pdr_hdr*>(outData);
+        EXPECT_EQ(le32toh(hdr->record_handle), i);
+        EXPECT_EQ(hdr->type, (i * 2) % 4);
+    }
+    EXPECT_EQ(pldm_pdr_find_record(repo, recordCount / 2 + 1, &outData, &size,
+                                   &nextRecHdl),
+              nullptr);
+    EXPECT_EQ(pldm_pdr_find_record_by_type(repo, 3, nullptr, &outData, &size),
+              nullptr);
+    typeCount = 0;
+    rec = pldm_pdr_find_record_by_type(repo, 2, nullptr, &outData, &size);
+    while (rec != nullptr)
+    {
+        typeCount++;
+        rec = pldm_pdr_find_record_by_type(repo, 2, rec, &outData, &size);
+    }
+    EXPECT_EQ(typeCount, recordCount / 4);
+
+    // Records added after removal reuse the freed space and stay findable
+    hdr = reinterpret_cast<pldm_pdr_hdr*>(data.data());
+    hdr->type = 3;
+    auto handle = pldm_pdr_add(repo, data.data(), data.size(), 0, true);
+    EXPECT_EQ(handle, recordCount / 2 + 1);
+    rec = pldm_pdr_find_record_by_type(repo, 3, nullptr, &outData, &size);
+    ASSERT_NE(rec, nullptr);
+    EXPECT_EQ(pldm_pdr_get_record_handle(repo, rec), handle);
+
+    pldm_pdr_destroy(repo);
+}
+
 TEST(PDRUpdate, testAddFruRecordSet)
 {
     auto repo = pldm_pdr_init();
@@ -376,6 +376,9 @@ static int receive_cb(sd_bus_message* m, void* userdata,
             return 0;
         }
 
+        /* Signals addressed to this connection are checked as well, since
+         * the MCTP service sends one copy per connection and other clients
+         * on the same connection may have registered other vendor fields */
         if (messageType == VDPCI)
         {
             struct VendorHeader
@@ -408,6 +411,33 @@ static int receive_cb(sd_bus_message* m, void* userdata,
     return 0;
 }
 
+static void register_message_subscriber(clientContext* ctx)
+{
+    /* receive_cb keeps messages with
+     * (vendor message type & mask) == vendor message type */
+    uint16_t mask = be16toh(ctx->vendor_message_type_mask);
+    uint16_t msg_type = be16toh(ctx->vendor_message_type);
+    bool registered = false;
+    try
+    {
+        call_method(static_cast<sdbusplus::bus::bus&>(*(ctx->connection)),
+                    ctx->service_h->second.c_str(), "/xyz/openbmc_project/mctp",
+                    "xyz.openbmc_project.MCTP.Base",
+                    "RegisterMessageSubscriber", registered,
+                    static_cast<uint8_t>(ctx->type),
+                    be16toh(ctx->vendor_id), msg_type, mask);
+    }
+    catch (std::exception& e)
+    {
+        phosphor::logging::log<phosphor::logging::level::INFO>(e.what());
+    }
+    if (!registered)
+    {
+        phosphor::logging::log<phosphor::logging::level::INFO>(
+            "Message subscriber not registered, using broadcast messages");
+    }
+}
+
 int mctpw_register_client(void* mctpw_bus_handle, mctpw_message_type_t type,
                           uint16_t vendor_id, bool receive_requests,
                           uint16_t vendor_message_type,
@@ -467,6 +497,7 @@ int mctpw_register_client(void* mctpw_bus_handle, mctpw_message_type_t type,
                 static_cast<sdbusplus::bus::bus&>(*ctx->connection), receive_cb,
                 static_cast<void*>(ctx.get()), "xyz.openbmc_project.MCTP.Base",
                 "MessageReceivedSignal", ctx->service_h->second, ""));
+            register_message_subscriber(ctx.get());
         }
     }
     catch (std::exception& e)
@@ -1,16 +1,29 @@
 #pragma once
 
 #include "utils/Configuration.hpp"
+#include "utils/data_socket.hpp"
 #include "utils/device_watcher.hpp"
 #include "utils/eid_pool.hpp"
+#include "utils/endpoint_snapshot.hpp"
+#include "utils/instance_id_pool.hpp"
+#include "utils/message_buffer.hpp"
+#include "utils/message_subscribers.hpp"
 #include "utils/transmission_queue.hpp"
 #include "utils/types.hpp"
 
 #include <libmctp-cmds.h>
 #include <libmctp.h>
 
+#include <array>
 #include <boost/asio/steady_timer.hpp>
+#include <chrono>
+#include <functional>
+#include <map>
 #include <numeric>
+#include <optional>
+#include <queue>
+#include <sdbusplus/bus/match.hpp>
+#include <tuple>
 #include <unordered_set>
 
 class SMBusBinding;
@@ -99,6 +112,21 @@ enum class PacketState : uint8_t
     noResponse
 };
 
+// Outstanding MCTP control request waiting for its response
+struct CtrlTxRequest
+{
+    PacketState state;
+    uint8_t retryCount;
+    // Time of the next retry, or of giving up once retries are exhausted
+    std::chrono::steady_clock::time_point deadline;
+    uint64_t id;
+    mctp_eid_t destEid;
+    uint8_t msgTag;
+    std::vector<uint8_t> bindingPrivate;
+    std::vector<uint8_t> req;
+    std::function<void(PacketState, std::vector<uint8_t>&)> callback;
+};
+
 struct InternalVdmSetDatabase
 {
     uint8_t vendorIdFormat;
@@ -135,6 +163,8 @@ class MctpBinding
     uint8_t busOwnerEid;
     bool rsvBWActive = false;
     mctp_eid_t reservedEID = 0;
+    // Inbound messages are copied once into this pool and shared from there
+    mctpd::MessageBufferPool rxBufferPool;
     mctpd::MctpTransmissionQueue transmissionQueue;
     mctpd::DeviceWatcher deviceWatcher{};
     mctpd::EidPool eidPool;
@@ -145,10 +175,20 @@ class MctpBinding
     // vendor PCI Msg Interface
     endpointInterfaceMap vendorIdInterface;
 
+    std::unique_ptr<mctpd::DataSocketServer> dataSocket;
+
+    // Clients that get received messages as directed signals
+    mctpd::MessageSubscribers messageSubscribers;
+    std::unordered_map<std::string,
+                       std::unique_ptr<sdbusplus::bus::match::match>>
+        subscriberWatches;
+
     void initializeMctp();
     void initializeLogging(void);
-    virtual std::optional<std::vector<uint8_t>>
-        getBindingPrivateData(uint8_t dstEid);
+    // Null for unknown EIDs, otherwise valid until the EID's routing changes
+    virtual const std::vector<uint8_t>* getBindingPrivateData(uint8_t dstEid);
+    // Endpoints on the same segment share its transmission budget
+    virtual uint32_t getTransmitSegment(mctp_eid_t dstEid);
     virtual bool isReceivedPrivateDataCorrect(const void* bindingPrivate);
     virtual bool handlePrepareForEndpointDiscovery(
         mctp_eid_t destEid, void* bindingPrivate, std::vector<uint8_t>& request,
@@ -180,6 +220,18 @@ class MctpBinding
                                      std::vector<uint8_t>& response);
     virtual void addUnknownEIDToDeviceTable(const mctp_eid_t eid,
                                             void* bindingPrivate);
+    // Address of an endpoint in the snapshot, which unlike the binding
+    // private data stays valid across restarts. Endpoints without one are
+    // left out of the snapshot.
+    virtual std::optional<std::string> getEndpointAddress(mctp_eid_t eid);
+    // Adds an endpoint from the snapshot to the binding's tables
+    virtual bool restoreEndpointAddress(mctp_eid_t eid,
+                                        const std::string& address);
+    // Removes a restored endpoint which didn't answer from those tables
+    virtual void forgetEndpointAddress(mctp_eid_t eid);
+    // Publishes the endpoints of the last snapshot right away, a bus owner
+    // then checks they are still there with Get Endpoint ID
+    void restoreEndpointSnapshot();
     bool getEidCtrlCmd(boost::asio::yield_context& yield,
                        const std::vector<uint8_t>& bindingPrivate,
                        const mctp_eid_t destEid, std::vector<uint8_t>& resp);
@@ -201,6 +253,14 @@ class MctpBinding
         uint8_t msgTypeNo,
         MctpVersionSupportCtrlResp* mctpVersionSupportCtrlResp);
 
+    int sendMctpMessage(mctp_eid_t dstEid, uint8_t msgTag, bool tagOwner,
+                        std::vector<uint8_t> payload);
+    mctpd::MessageBuffer
+        sendReceiveMctpMessage(boost::asio::yield_context yield,
+                               mctp_eid_t dstEid, std::vector<uint8_t> payload,
+                               uint16_t timeout);
+    void createDataSocket();
+
     bool registerUpperLayerResponder(uint8_t typeNo,
                                      std::vector<uint8_t>& list);
     bool manageVersionInfo(uint8_t typeNo, std::vector<uint8_t>& list);
@@ -213,6 +273,15 @@ class MctpBinding
 
     bool manageVdpciVersionInfo(uint16_t vendorId, uint16_t cmdSetType);
 
+    bool registerMessageSubscriber(
+        const std::string& client,
+        const mctpd::MessageSubscribers::Filter& filter);
+    bool unregisterMessageSubscriber(
+        const std::string& client,
+        const mctpd::MessageSubscribers::Filter& filter);
+    void deliverMessage(uint8_t msgType, mctp_eid_t srcEid, uint8_t msgTag,
+                        bool tagOwner, const mctpd::MessageBuffer& msg);
+
     bool discoveryNotifyCtrlCmd(boost::asio::yield_context& yield,
                                 const std::vector<uint8_t>& bindingPrivate,
                                 const mctp_eid_t destEid);
@@ -227,9 +296,19 @@ class MctpBinding
                          mctp_server::BindingModeTypes bindingMode =
                              mctp_server::BindingModeTypes::Endpoint);
     void unregisterEndpoint(mctp_eid_t eid);
+    // Completes the matching control requests as not responded, for example
+    // the ones whose link is gone, without waiting for their retries
+    void cancelCtrlTx(
+        const std::function<bool(const CtrlTxRequest&)>& isCancelled);
+    // Runs each step in a coroutine of its own and returns once all are done
+    void runConcurrently(
+        boost::asio::yield_context yield,
+        const std::vector<std::function<void(boost::asio::yield_context)>>&
+            steps);
 
     // MCTP Callbacks
-    bool handleCtrlResp(void* msg, const size_t len);
+    bool handleCtrlResp(mctp_eid_t srcEid, uint8_t msgTag,
+                        const mctpd::MessageBuffer& response);
     static void rxMessage(uint8_t srcEid, void* data, void* msg, size_t len,
                           bool tagOwner, uint8_t msgTag, void* bindingPrivate);
     static void handleMCTPControlRequests(uint8_t srcEid, void* data, void* msg,
@@ -266,25 +345,69 @@ class MctpBinding
     endpointInterfaceMap msgTypeInterface;
     endpointInterfaceMap uuidInterface;
 
+    // Armed for the earliest deadline in ctrlTxDeadlines, idle otherwise
     boost::asio::steady_timer ctrlTxTimer;
-
-    bool ctrlTxTimerExpired = true;
-    // <state, retryCount, maxRespDelay, destEid, BindingPrivate, ReqPacket,
-    //  Callback>
-    std::vector<
-        std::tuple<PacketState, uint8_t, unsigned int, mctp_eid_t,
-                   std::vector<uint8_t>, std::vector<uint8_t>,
-                   std::function<void(PacketState, std::vector<uint8_t>&)>>>
-        ctrlTxQueue;
+    std::optional<std::chrono::steady_clock::time_point> ctrlTxTimerDeadline;
+    // <deadline, request id, instance ID>. Entries of requests that have
+    // completed or moved to a later deadline are skipped when popped.
+    using CtrlTxDeadline =
+        std::tuple<std::chrono::steady_clock::time_point, uint64_t, uint8_t>;
+    std::priority_queue<CtrlTxDeadline, std::vector<CtrlTxDeadline>,
+                        std::greater<CtrlTxDeadline>>
+        ctrlTxDeadlines;
+    uint64_t ctrlTxNextId = 0;
+    // Outstanding control requests indexed by instance ID. A slot holds more
+    // than one request only when the same instance ID is in flight to
+    // several endpoints, requests within a slot are told apart by EID and tag.
+    // Requests outstanding to one destination have distinct tags.
+    std::array<std::vector<CtrlTxRequest>, MCTP_CTRL_HDR_INSTANCE_ID_MASK + 1>
+        ctrlTxTable;
+    size_t ctrlTxCount = 0;
+    // Instance IDs of the requests in ctrlTxTable, by destination EID
+    mctpd::InstanceIdPool ctrlInstanceIds;
     // <eid, uuid>
     std::vector<std::pair<mctp_eid_t, std::string>> uuidTable;
+    // Registered endpoints, written to snapshotFile shortly after a change
+    std::map<mctp_eid_t, EndpointProperties> endpointProperties;
+    std::filesystem::path snapshotFile;
+    boost::asio::steady_timer snapshotTimer;
+    bool snapshotPending = false;
+    static constexpr std::chrono::seconds snapshotDelay{1};
+    // Bumped whenever an endpoint is registered or removed. Starts from the
+    // time mctpd started, so generations seen before a restart are older
+    // than any change kept in endpointChanges.
+    uint64_t firstEndpointGeneration;
+    uint64_t endpointGeneration;
+    // Generation each EID was last registered or removed at
+    std::map<mctp_eid_t, uint64_t> endpointChanges;
+
+    // <EID, UUID, mode, network ID, message types, VDPCI vendor ID, VDPCI
+    // vendor message types>
+    using EndpointEntry =
+        std::tuple<uint8_t, std::string, std::string, uint16_t,
+                   std::vector<uint8_t>, std::string, std::vector<uint16_t>>;
 
     void createUuid();
+    void endpointChanged(mctp_eid_t eid);
+    std::optional<EndpointEntry> getEndpointEntry(mctp_eid_t eid,
+                                                  uint8_t msgType) const;
+    std::tuple<uint64_t, std::vector<EndpointEntry>>
+        getEndpoints(uint8_t msgType) const;
+    std::tuple<uint64_t, bool, std::vector<EndpointEntry>, std::vector<uint8_t>>
+        getEndpointsSince(uint64_t generation, uint8_t msgType) const;
+    void scheduleSnapshot();
+    void writeSnapshot();
+    void validateRestoredEndpoints(boost::asio::yield_context yield,
+                                   const std::vector<mctp_eid_t>& eids);
     bool sendMctpCtrlMessage(mctp_eid_t destEid, std::vector<uint8_t> req,
                              bool tagOwner, uint8_t msgTag,
                              std::vector<uint8_t> bindingPrivate);
-    void processCtrlTxQueue();
-    void pushToCtrlTxQueue(
+    void armCtrlTxTimer();
+    void processCtrlTxDeadlines();
+    std::optional<uint8_t>
+        allocateCtrlMsgTag(mctp_eid_t destEid,
+                           const std::vector<uint8_t>& bindingPrivate) const;
+    bool pushToCtrlTxQueue(
         PacketState pktState, const mctp_eid_t destEid,
         const std::vector<uint8_t>& bindingPrivate,
         const std::vector<uint8_t>& req,
@@ -3,11 +3,14 @@
 #include "MCTPBinding.hpp"
 #include "hw/DeviceMonitor.hpp"
 #include "hw/PCIeDriver.hpp"
+#include "utils/binding_private_table.hpp"
 
 #include <libmctp-nupcie.h>
 #include <libmctp-cmds.h>
 
+#include <bitset>
 #include <boost/asio/deadline_timer.hpp>
+#include <unordered_map>
 #include <xyz/openbmc_project/MCTP/Binding/PCIe/server.hpp>
 
 using pcie_binding =
@@ -50,6 +53,12 @@ class PCIeBinding : public MctpBinding,
     bool handleGetVdmSupport(mctp_eid_t endpointEid, void* bindingPrivate,
                              std::vector<uint8_t>& request,
                              std::vector<uint8_t>& response) override;
+    void addUnknownEIDToDeviceTable(const mctp_eid_t eid,
+                                    void* bindingPrivate) override;
+    std::optional<std::string> getEndpointAddress(mctp_eid_t eid) override;
+    bool restoreEndpointAddress(mctp_eid_t eid,
+                                const std::string& address) override;
+    void forgetEndpointAddress(mctp_eid_t eid) override;
 
     void deviceReadyNotify(bool ready) override;
 
@@ -59,45 +68,55 @@ class PCIeBinding : public MctpBinding,
   private:
     using routingTableEntry_t =
         std::tuple<uint8_t /*eid*/, uint16_t /*bdf*/, uint8_t /*entryType*/>;
-    using calledBridgeEntry_t = std::tuple<uint8_t /*eid*/, uint16_t /*bdf*/>;
     uint16_t bdf;
     uint16_t busOwnerBdf;
     std::shared_ptr<dbus_interface> pcieInterface;
     pcie_binding::DiscoveryFlags discoveredFlag{};
     boost::posix_time::seconds getRoutingInterval;
+    // Grows while the routing table stays the same, polling is only a
+    // fallback for changes no event announced
+    boost::posix_time::seconds currentRoutingInterval;
     boost::asio::deadline_timer getRoutingTableTimer;
     std::vector<routingTableEntry_t> routingTable;
+    // Syncs reusing the tables of unchanged bridges between two full syncs
+    static constexpr size_t maxIncrementalRoutingSyncs = 3;
+    static constexpr long maxRoutingIntervalFactor = 8;
+    size_t incrementalRoutingSyncs{0};
+    bool routingSyncInProgress{false};
+    bool routingSyncRequested{false};
+    bool fullRoutingSyncRequested{false};
+    // Entries each bridge reported at the last sync, by bridge EID and BDF
+    std::unordered_map<uint32_t, std::vector<routingTableEntry_t>>
+        bridgeTables;
+    // EIDs messages came from which already triggered a sync without
+    // showing up in the routing table
+    std::bitset<256> unknownEidsSynced;
+    // What is sent to each EID in routingTable, by BDF
+    mctpd::BindingPrivateTable<uint16_t> bindingPrivateTable;
+    void setRoutingTable(const std::vector<routingTableEntry_t>& newTable);
     void endpointDiscoveryFlow();
+    void requestRoutingTableSync(bool fullSync);
+    void scheduleRoutingTableSync();
     void updateRoutingTable();
     void processRoutingTableChanges(
         const std::vector<routingTableEntry_t>& newTable,
         boost::asio::yield_context& yield, const std::vector<uint8_t>& prvData);
-    void processBridgeEntries(std::vector<routingTableEntry_t>& rt,
-                              std::vector<calledBridgeEntry_t>& calledBridges,
-                              boost::asio::yield_context& yield);
-    void readRoutingTable(std::vector<routingTableEntry_t>& rt,
-                          std::vector<calledBridgeEntry_t>& calledBridges,
-                          std::vector<uint8_t> prvData,
+    bool readNetworkRoutingTable(std::vector<routingTableEntry_t>& rt,
+                                 const std::vector<uint8_t>& prvData,
+                                 boost::asio::yield_context& yield,
+                                 bool fullSync);
+    bool readRoutingTable(std::vector<routingTableEntry_t>& rt,
+                          const std::vector<uint8_t>& prvData,
                           boost::asio::yield_context& yield, uint8_t eid,
-                          uint16_t physAddr, long entryIndex = 0);
+                          uint16_t physAddr);
     uint16_t getRoutingEntryPhysAddr(
         const std::vector<uint8_t>& getRoutingTableEntryResp,
         size_t entryOffset);
-    bool isEntryInRoutingTable(get_routing_table_entry* routingEntry,
-                               const std::vector<routingTableEntry_t>& rt);
     bool isEndOfGetRoutingTableResp(uint8_t entryHandle,
                                     uint8_t& responseCount);
-    bool isActiveEntryBehindBridge(get_routing_table_entry* routingEntry,
-                                   const std::vector<routingTableEntry_t>& rt);
     bool isEntryBridge(const routingTableEntry_t& routingEntry);
-    bool isBridgeCalled(const routingTableEntry_t& routingEntry,
-                        const std::vector<calledBridgeEntry_t>& calledBridges);
-    bool
-        allBridgesCalled(const std::vector<routingTableEntry_t>& rt,
-                         const std::vector<calledBridgeEntry_t>& calledBridges);
     bool setDriverEndpointMap(const std::vector<routingTableEntry_t>& newTable);
-    std::optional<std::vector<uint8_t>>
-        getBindingPrivateData(uint8_t dstEid) override;
+    const std::vector<uint8_t>* getBindingPrivateData(uint8_t dstEid) override;
     bool isReceivedPrivateDataCorrect(const void* bindingPrivate) override;
     mctp_server::BindingModeTypes
         getBindingMode(const routingTableEntry_t& routingEntry);
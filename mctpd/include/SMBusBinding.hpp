@@ -1,8 +1,13 @@
 #pragma once
 
 #include "MCTPBinding.hpp"
+#include "utils/binding_private_table.hpp"
+#include "utils/blocking_worker.hpp"
+#include "utils/latency_histogram.hpp"
+#include "utils/mux_topology.hpp"
 
 #include <libmctp-smbus.h>
+#include <libudev.h>
 
 enum class DiscoveryFlags : uint8_t
 {
@@ -27,8 +32,8 @@ class SMBusBinding : public MctpBinding
                  boost::asio::io_context& ioc);
     ~SMBusBinding() override;
     void initializeBinding() override;
-    std::optional<std::vector<uint8_t>>
-        getBindingPrivateData(uint8_t dstEid) override;
+    const std::vector<uint8_t>* getBindingPrivateData(uint8_t dstEid) override;
+    uint32_t getTransmitSegment(mctp_eid_t dstEid) override;
     bool handleGetEndpointId(mctp_eid_t destEid, void* bindingPrivate,
                              std::vector<uint8_t>& request,
                              std::vector<uint8_t>& response) override;
@@ -46,6 +51,10 @@ class SMBusBinding : public MctpBinding
                              std::vector<uint8_t>& response) override;
     void addUnknownEIDToDeviceTable(const mctp_eid_t eid,
                                     void* bindingPrivate) override;
+    std::optional<std::string> getEndpointAddress(mctp_eid_t eid) override;
+    bool restoreEndpointAddress(mctp_eid_t eid,
+                                const std::string& address) override;
+    void forgetEndpointAddress(mctp_eid_t eid) override;
 
   private:
     using DeviceTableEntry_t =
@@ -53,7 +62,10 @@ class SMBusBinding : public MctpBinding
                   struct mctp_smbus_pkt_private /*binding prv data*/>;
     std::string SMBusInit();
     void readResponse();
-    void initEndpointDiscovery(boost::asio::yield_context& yield);
+    size_t initEndpointDiscovery(boost::asio::yield_context& yield,
+                                 bool fullScan);
+    mctp_eid_t discoverDevice(boost::asio::yield_context& yield,
+                              const std::pair<int, uint8_t>& device);
     bool reserveBandwidth(const mctp_eid_t eid,
                           const uint16_t timeout) override;
     void startTimerAndReleaseBW(const uint16_t interval,
@@ -64,6 +76,8 @@ class SMBusBinding : public MctpBinding
     bool arpMasterSupport;
     uint8_t bmcSlaveAddr;
     std::set<uint8_t> supportedEndpointSlaveAddress;
+    // Muxes whose channels may be discovered alongside other traffic
+    std::set<uint8_t> concurrentMuxAddresses;
     struct mctp_binding_smbus* smbus = nullptr;
     int inFd{-1};  // in_fd for the smbus binding
     int outFd{-1}; // out_fd for the root bus
@@ -73,18 +87,52 @@ class SMBusBinding : public MctpBinding
     std::shared_ptr<dbus_interface> smbusInterface;
     bool isMuxFd(const int fd);
     std::vector<DeviceTableEntry_t> smbusDeviceTable;
+    // What is sent to each EID in smbusDeviceTable, by (fd, slave address)
+    mctpd::BindingPrivateTable<std::pair<int, uint8_t>> bindingPrivateTable;
+    void indexDeviceTableEntry(const DeviceTableEntry_t& entry);
+    void addDeviceTableEntry(const DeviceTableEntry_t& entry);
+    void setDeviceTable(const std::vector<DeviceTableEntry_t>& table);
+    // Scans registering only new devices between two full scans
+    static constexpr size_t maxIncrementalScans = 3;
+    // Shortest scan interval while devices change, as a part of scanInterval
+    static constexpr uint64_t scanIntervalDivisor = 8;
     uint64_t scanInterval;
+    // Shortened while devices come and go, back to scanInterval once stable
+    uint64_t currentScanInterval;
     boost::asio::steady_timer scanTimer;
+    // Probes the buses so the io_context isn't blocked for a whole scan
+    mctpd::BlockingWorker probeWorker;
+    // How long handlers, received messages included, wait to run during scans
+    mctpd::LatencyHistogram scanRxLatency;
+    boost::asio::steady_timer scanLatencyTimer;
+    bool scanInProgress{false};
+    static constexpr std::chrono::milliseconds scanLatencySamplePeriod{10};
+    // Mux devices present at the last scan with their EID, MCTP_EID_NULL for
+    // devices which didn't register
+    std::map<std::pair<int, uint8_t>, mctp_eid_t> knownDevices;
+    size_t incrementalScans{0};
+    bool fullScanRequested{false};
     std::map<int, int> muxPortMap;
+    int rootBus{-1};
+    mctpd::MuxTopology muxTopology;
+    // Reports I2C buses coming and going, so the topology is read again
+    udev* udevContext{nullptr};
+    udev_monitor* i2cMonitor{nullptr};
+    boost::asio::posix::stream_descriptor i2cEvents;
+    boost::asio::steady_timer topologyRefreshTimer;
+    bool topologyRefreshPending{false};
+    static constexpr std::chrono::milliseconds topologyRefreshDelay{500};
     std::set<std::pair<int, uint8_t>> rootDeviceMap;
     bool addRootDevices;
-    std::unordered_map<std::string, std::string> muxIdleModeMap{};
     uint8_t smbusRoutingInterval;
     std::unique_ptr<boost::asio::steady_timer> smbusRoutingTableTimer;
     uint8_t busOwnerSlaveAddr;
     int busOwnerFd;
     void scanDevices();
-    std::map<int, int> getMuxFds(const std::string& rootPort);
+    void sampleScanLatency();
+    void watchMuxTopology();
+    void waitForTopologyEvent();
+    void refreshMuxTopology();
     void scanPort(const int scanFd,
                   std::set<std::pair<int, uint8_t>>& deviceMap);
     void scanMuxBus(std::set<std::pair<int, uint8_t>>& deviceMap);
@@ -93,7 +141,6 @@ class SMBusBinding : public MctpBinding
     void removeDeviceTableEntry(const mctp_eid_t eid);
     void updateDiscoveredFlag(DiscoveryFlags flag);
     std::string convertToString(DiscoveryFlags flag);
-    void restoreMuxIdleMode();
     mctp_server::BindingModeTypes
         getBindingMode(const DeviceTableEntry_t& deviceTableEntry);
     bool isDeviceEntryPresent(
@@ -107,6 +154,5 @@ class SMBusBinding : public MctpBinding
     void processRoutingTableChanges(
         const std::vector<DeviceTableEntry_t>& newTable,
         boost::asio::yield_context& yield, const std::vector<uint8_t>& prvData);
-    void setMuxIdleMode(const MuxIdleModes mode);
     size_t ret = 0;
 };
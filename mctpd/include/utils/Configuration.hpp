@@ -13,6 +13,10 @@ struct Configuration
     uint8_t defaultEid;
     unsigned int reqToRespTime;
     uint8_t reqRetryCount;
+    // Registered endpoints are kept here across restarts, if not empty
+    std::filesystem::path snapshotFile;
+    // Received messages of these types go only to registered subscribers
+    std::set<uint8_t> directedOnlyMsgTypes;
 
     virtual ~Configuration();
 };
@@ -20,10 +24,13 @@ struct Configuration
 struct SMBusConfiguration : Configuration
 {
     std::set<uint8_t> eidPool;
+    // Keeps the EIDs assigned to device UUIDs across restarts, if not empty
+    std::filesystem::path eidAffinityFile;
     std::string bus;
     bool arpMasterSupport;
     uint8_t bmcSlaveAddr;
     std::set<uint8_t> supportedEndpointSlaveAddress;
+    std::set<uint8_t> concurrentMuxAddresses;
     uint8_t routingIntervalSec;
     uint64_t scanInterval;
 
@@ -0,0 +1,32 @@
+/*
+// Copyright (c) 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <ostream>
+
+namespace mctpd
+{
+
+// Replaces the file with what the writer puts into the stream. The content
+// is written aside and renamed, so a crash never leaves half a file. Missing
+// parent directories are created. Failures are logged.
+bool writeFileAtomically(const std::filesystem::path& file,
+                         const std::function<void(std::ostream&)>& writer);
+
+} // namespace mctpd
@@ -0,0 +1,112 @@
+/*
+// Copyright (c) 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+#pragma once
+
+#include <libmctp.h>
+
+#include <array>
+#include <map>
+#include <optional>
+#include <set>
+#include <vector>
+
+namespace mctpd
+{
+
+// Binding private data ready to hand to libmctp for each EID, so sending a
+// message looks it up by index instead of searching the routing table and
+// building it again. Each entry also keeps the physical address it was built
+// for, which indexes the EIDs the other way round.
+template <typename Address>
+class BindingPrivateTable
+{
+  public:
+    void set(mctp_eid_t eid, const Address& address,
+             std::vector<uint8_t> privateData)
+    {
+        erase(eid);
+        auto& entry = entries[eid];
+        entry.address = address;
+        entry.privateData = std::move(privateData);
+        eidsByAddress[address].emplace(eid);
+    }
+
+    void erase(mctp_eid_t eid)
+    {
+        auto& entry = entries[eid];
+        if (!entry.address)
+        {
+            return;
+        }
+        auto eids = eidsByAddress.find(*entry.address);
+        eids->second.erase(eid);
+        if (eids->second.empty())
+        {
+            eidsByAddress.erase(eids);
+        }
+        entry.address.reset();
+        entry.privateData.clear();
+    }
+
+    void clear()
+    {
+        for (auto& entry : entries)
+        {
+            entry.address.reset();
+            entry.privateData.clear();
+        }
+        eidsByAddress.clear();
+    }
+
+    bool contains(mctp_eid_t eid) const
+    {
+        return entries[eid].address.has_value();
+    }
+
+    // Null for EIDs without an entry
+    const std::vector<uint8_t>* getPrivateData(mctp_eid_t eid) const
+    {
+        const auto& entry = entries[eid];
+        return entry.address ? &entry.privateData : nullptr;
+    }
+
+    const std::optional<Address>& getAddress(mctp_eid_t eid) const
+    {
+        return entries[eid].address;
+    }
+
+    // Lowest EID at the address, when several share it behind a bridge
+    std::optional<mctp_eid_t> getEid(const Address& address) const
+    {
+        auto eids = eidsByAddress.find(address);
+        if (eids == eidsByAddress.end())
+        {
+            return std::nullopt;
+        }
+        return *eids->second.begin();
+    }
+
+  private:
+    struct Entry
+    {
+        std::optional<Address> address{};
+        std::vector<uint8_t> privateData{};
+    };
+
+    std::array<Entry, 256> entries{};
+    std::map<Address, std::set<mctp_eid_t>> eidsByAddress{};
+};
+} // namespace mctpd
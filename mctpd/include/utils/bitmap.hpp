@@ -0,0 +1,65 @@
+/*
+// Copyright (c) 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mctpd
+{
+// Bitmaps are arrays of 64 bit words, bit 0 being the lowest bit of the
+// first word
+constexpr size_t bitmapWordBits = 64;
+
+template <typename Bitmap>
+bool testBit(const Bitmap& bitmap, size_t bit)
+{
+    return (bitmap[bit / bitmapWordBits] >> (bit % bitmapWordBits)) & 1;
+}
+
+template <typename Bitmap>
+void setBit(Bitmap& bitmap, size_t bit, bool value)
+{
+    auto mask = uint64_t{1} << (bit % bitmapWordBits);
+    if (value)
+    {
+        bitmap[bit / bitmapWordBits] |= mask;
+    }
+    else
+    {
+        bitmap[bit / bitmapWordBits] &= ~mask;
+    }
+}
+
+// Returns the first set bit at or after 'from', or the bitmap size if none
+template <typename Bitmap>
+size_t nextSetBit(const Bitmap& bitmap, size_t from)
+{
+    const size_t size = bitmap.size() * bitmapWordBits;
+    while (from < size)
+    {
+        uint64_t word =
+            bitmap[from / bitmapWordBits] >> (from % bitmapWordBits);
+        if (word != 0)
+        {
+            return from + static_cast<size_t>(__builtin_ctzll(word));
+        }
+        from = (from / bitmapWordBits + 1) * bitmapWordBits;
+    }
+    return size;
+}
+} // namespace mctpd
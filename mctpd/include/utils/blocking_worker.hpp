@@ -0,0 +1,56 @@
+/*
+// Copyright (c) 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+#pragma once
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/spawn.hpp>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace mctpd
+{
+
+// Runs blocking calls, such as I2C probing, on a thread of its own so the
+// io_context keeps handling MCTP traffic meanwhile. Jobs run one at a time in
+// the order they were submitted.
+class BlockingWorker
+{
+  public:
+    explicit BlockingWorker(boost::asio::io_context& ioc);
+    ~BlockingWorker();
+
+    BlockingWorker(const BlockingWorker&) = delete;
+    BlockingWorker& operator=(const BlockingWorker&) = delete;
+
+    // Suspends the calling coroutine until the job has run on the worker
+    // thread. Exceptions thrown by the job are rethrown here.
+    void run(boost::asio::yield_context yield,
+             const std::function<void()>& job);
+
+  private:
+    void loop();
+
+    boost::asio::io_context& ioc;
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::deque<std::function<void()>> jobs;
+    bool stopping = false;
+    std::thread thread;
+};
+} // namespace mctpd
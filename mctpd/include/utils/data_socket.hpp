@@ -0,0 +1,118 @@
+/*
+// Copyright (c) 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+
+#include "utils/message_buffer.hpp"
+
+#include <libmctp.h>
+
+#include <boost/asio/basic_socket_acceptor.hpp>
+#include <boost/asio/generic/seq_packet_protocol.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mctpd
+{
+
+// Every packet on the data socket is one header followed by an MCTP message,
+// message type byte first. Replies echo the id of the request they answer.
+struct DataSocketHeader
+{
+    uint32_t id;
+    uint8_t op;
+    uint8_t eid;
+    uint8_t msgTag;
+    uint8_t tagOwner;
+    // Response timeout in milliseconds, SendReceive only
+    uint16_t timeout;
+    // Replies only: MctpStatus for Send, 0 or -errno for SendReceive
+    int16_t status;
+} __attribute__((packed));
+
+enum class DataSocketOp : uint8_t
+{
+    send = 1,
+    sendReceive = 2,
+};
+
+// Local SEQPACKET socket carrying the same requests as the
+// SendMctpMessagePayload and SendReceiveMctpMessagePayload D-Bus methods,
+// without serializing payloads through the D-Bus broker. Each client has its
+// own connection and every request is served in its own coroutine, so a slow
+// endpoint only delays the requests waiting for it. Only root and the user
+// mctpd runs as may connect, the same callers the D-Bus policy lets through.
+class DataSocketServer
+{
+  public:
+    using SendHandler = std::function<int(
+        mctp_eid_t dstEid, uint8_t msgTag, bool tagOwner,
+        std::vector<uint8_t> payload)>;
+    using SendReceiveHandler = std::function<MessageBuffer(
+        boost::asio::yield_context yield, mctp_eid_t dstEid,
+        std::vector<uint8_t> payload, uint16_t timeout)>;
+
+    static constexpr size_t maxPacketSize = 64 * 1024;
+    // Further requests stay in the socket until one of these completes
+    static constexpr size_t maxRequestsInFlight = 16;
+
+    // Binds to the given name in the abstract socket namespace
+    DataSocketServer(boost::asio::io_context& ioc, const std::string& name,
+                     SendHandler&& sendHandler,
+                     SendReceiveHandler&& sendReceiveHandler);
+    ~DataSocketServer();
+
+    const std::string& getName() const
+    {
+        return socketName;
+    }
+
+  private:
+    using Protocol = boost::asio::generic::seq_packet_protocol;
+
+    struct Connection
+    {
+        explicit Connection(boost::asio::io_context& ioc) :
+            socket(ioc), slotFreed(ioc)
+        {
+        }
+
+        Protocol::socket socket;
+        size_t inFlight{0};
+        // Cancelled whenever a request completes
+        boost::asio::steady_timer slotFreed;
+    };
+
+    void acceptClients(boost::asio::yield_context yield);
+    bool isPeerAllowed(Protocol::socket& client);
+    void serveClient(std::shared_ptr<Connection> client,
+                     boost::asio::yield_context yield);
+    void handleRequest(std::shared_ptr<Connection> client,
+                       DataSocketHeader header, std::vector<uint8_t> payload,
+                       boost::asio::yield_context yield);
+
+    boost::asio::io_context& io;
+    std::string socketName;
+    boost::asio::basic_socket_acceptor<Protocol> acceptor;
+    SendHandler send;
+    SendReceiveHandler sendReceive;
+};
+} // namespace mctpd
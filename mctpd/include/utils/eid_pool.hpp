@@ -16,21 +16,51 @@
 
 #pragma once
 
+#include "utils/bitmap.hpp"
+
 #include <libmctp.h>
 
+#include <array>
+#include <filesystem>
+#include <optional>
 #include <set>
-#include <vector>
+#include <string>
+#include <unordered_map>
 
 namespace mctpd
 {
+// EIDs are handed out round robin, so a released EID is the last one to be
+// reused. The EID last assigned to each UUID is kept for that UUID while
+// other EIDs are free, and in the affinity file if one is given, so a device
+// coming back after a reset, or after mctpd restarts, gets its EID again.
 class EidPool
 {
   public:
-    void initializeEidPool(const std::set<mctp_eid_t>& pool);
+    void initializeEidPool(const std::set<mctp_eid_t>& pool,
+                           const std::filesystem::path& affinityFile = {});
     void updateEidStatus(const mctp_eid_t endpointId, const bool assigned);
-    mctp_eid_t getAvailableEidFromPool();
+    mctp_eid_t getAvailableEidFromPool(const std::string& uuid = {});
+    // Called once the endpoint accepted the EID
+    void setEidAffinity(const std::string& uuid, const mctp_eid_t endpointId);
+    std::optional<mctp_eid_t> getEidAffinity(const std::string& uuid) const;
 
   private:
-    std::vector<std::pair<mctp_eid_t, bool>> eidPool;
+    static constexpr size_t maxEids = 256;
+    using EidBitmap = std::array<uint64_t, maxEids / bitmapWordBits>;
+
+    std::optional<mctp_eid_t> findFree(const EidBitmap& candidates) const;
+    void allocate(mctp_eid_t eid);
+    void loadAffinity();
+    void storeAffinity() const;
+
+    EidBitmap poolEids{};
+    EidBitmap freeEids{};
+    // EIDs some UUID is waiting to get again
+    EidBitmap claimedEids{};
+    // Where the round robin search for a free EID starts
+    size_t nextEid{0};
+    std::unordered_map<std::string, mctp_eid_t> uuidToEid;
+    std::array<std::string, maxEids> eidToUuid{};
+    std::filesystem::path affinityFile;
 };
 } // namespace mctpd
\ No newline at end of file
@@ -0,0 +1,51 @@
+/*
+// Copyright (c) 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace mctpd
+{
+
+// What mctpd knows about a registered endpoint, kept in a file so endpoints
+// can be published again right after a restart
+struct EndpointRecord
+{
+    uint8_t eid{0u};
+    std::string uuid{};
+    std::string mode{};
+    uint16_t networkId{0u};
+    std::vector<uint8_t> msgTypes{};
+    std::string vendorIdFormat{};
+    std::vector<uint16_t> vendorIdCapabilitySets{};
+    // Written and read back by the binding, stable across restarts unlike
+    // the binding private data
+    std::string address{};
+
+    bool operator==(const EndpointRecord&) const = default;
+};
+
+// Endpoints are stored one per line. A missing file, or a line which can't be
+// read, yields no endpoint rather than an error.
+std::vector<EndpointRecord>
+    readEndpointSnapshot(const std::filesystem::path& file);
+bool writeEndpointSnapshot(const std::filesystem::path& file,
+                           const std::vector<EndpointRecord>& endpoints);
+} // namespace mctpd
@@ -0,0 +1,54 @@
+/*
+// Copyright (c) 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+
+#include <libmctp.h>
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+namespace mctpd
+{
+// Instance IDs of MCTP control requests, allocated per destination EID. An ID
+// stays in use until its request gets a response or times out, so responses
+// to several requests outstanding to one endpoint are matched correctly. IDs
+// are handed out round robin, so a late response to a released ID doesn't
+// match the next request right away.
+class InstanceIdPool
+{
+  public:
+    static constexpr size_t idCount = 32;
+
+    // Empty once idCount requests are outstanding to the EID
+    std::optional<uint8_t> allocate(mctp_eid_t eid);
+    void release(mctp_eid_t eid, uint8_t instanceId);
+    size_t inUse(mctp_eid_t eid) const;
+
+  private:
+    static constexpr size_t maxEids = 256;
+
+    struct Endpoint
+    {
+        uint32_t used{0};
+        // Where the round robin search for a free ID starts
+        uint8_t next{0};
+    };
+
+    std::array<Endpoint, maxEids> endpoints{};
+};
+} // namespace mctpd
@@ -0,0 +1,45 @@
+/*
+// Copyright (c) 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace mctpd
+{
+
+// Counts latencies in decade wide buckets from 100us up to 1s
+class LatencyHistogram
+{
+  public:
+    void record(std::chrono::steady_clock::duration latency);
+
+    // Bucket counts by upper bound, e.g. "<1ms", plus "Max" in microseconds
+    std::map<std::string, uint64_t> get() const;
+
+  private:
+    static constexpr std::array<std::chrono::microseconds, 5> bounds = {
+        std::chrono::microseconds(100), std::chrono::milliseconds(1),
+        std::chrono::milliseconds(10), std::chrono::milliseconds(100),
+        std::chrono::seconds(1)};
+
+    std::array<uint64_t, bounds.size() + 1> counts{};
+    std::chrono::microseconds max{0};
+};
+} // namespace mctpd
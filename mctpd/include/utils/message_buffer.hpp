@@ -0,0 +1,80 @@
+/*
+// Copyright (c) 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace mctpd
+{
+
+class MessageBufferPool;
+
+// Reference counted handle to a pooled message buffer. Copies of a handle
+// share the buffer, which goes back to its pool once the last one is gone.
+class MessageBuffer
+{
+  public:
+    MessageBuffer() = default;
+    MessageBuffer(const MessageBuffer& other);
+    MessageBuffer(MessageBuffer&& other) noexcept;
+    MessageBuffer& operator=(MessageBuffer other) noexcept;
+    ~MessageBuffer();
+
+    explicit operator bool() const
+    {
+        return block != nullptr;
+    }
+    std::vector<uint8_t>& operator*() const;
+    std::vector<uint8_t>* operator->() const;
+
+  private:
+    friend class MessageBufferPool;
+    struct Block;
+
+    explicit MessageBuffer(Block* blockIn);
+
+    Block* block = nullptr;
+};
+
+// Recycles the storage of received messages, so in steady state receiving a
+// message costs one copy out of the libmctp buffer and no allocation.
+class MessageBufferPool
+{
+  public:
+    struct Counters
+    {
+        uint64_t acquired{0u};
+        // Buffers created or grown because no free one was large enough
+        uint64_t allocations{0u};
+        uint64_t bytesCopied{0u};
+    };
+
+    explicit MessageBufferPool(size_t maxFreeBuffers = 32);
+
+    // Copies the message into a free buffer
+    MessageBuffer acquire(const void* data, size_t len);
+    const Counters& getCounters() const;
+
+  private:
+    friend class MessageBuffer;
+    struct State;
+
+    std::shared_ptr<State> state;
+};
+} // namespace mctpd
@@ -0,0 +1,76 @@
+/*
+// Copyright (c) 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace mctpd
+{
+
+// Registration table of D-Bus clients that want received MCTP messages
+// delivered to them directly instead of picking them out of a broadcast.
+// Clients which do not register only see the broadcast, so it is skipped
+// only for message types configured as directed only.
+class MessageSubscribers
+{
+  public:
+    struct Filter
+    {
+        uint8_t msgType;
+        // Only used for VDPCI messages, in CPU byte order
+        uint16_t vendorId{0u};
+        uint16_t vendorMsgType{0u};
+        uint16_t vendorMsgTypeMask{0u};
+
+        bool operator==(const Filter& other) const;
+        bool matches(const std::vector<uint8_t>& msg) const;
+    };
+
+    struct Delivery
+    {
+        // Clients the message is addressed to
+        std::vector<std::string> recipients{};
+        bool broadcast{true};
+    };
+
+    bool subscribe(const std::string& client, const Filter& filter);
+    bool unsubscribe(const std::string& client, const Filter& filter);
+    void removeClient(const std::string& client);
+    bool hasClient(const std::string& client) const;
+
+    // Returns the clients subscribed to the message and counts the delivery
+    std::vector<std::string> getRecipients(const std::vector<uint8_t>& msg);
+    // Broadcast unless the message type is directed only and has recipients
+    Delivery getDelivery(const std::vector<uint8_t>& msg);
+    void setDirectedOnlyTypes(const std::set<uint8_t>& msgTypes);
+    std::map<std::string, uint64_t> getDeliveryCounters() const;
+
+  private:
+    struct Client
+    {
+        std::vector<Filter> filters{};
+        uint64_t delivered{0u};
+    };
+
+    std::map<std::string, Client> clients{};
+    std::set<uint8_t> directedOnlyTypes{};
+};
+} // namespace mctpd
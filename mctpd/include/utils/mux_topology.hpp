@@ -0,0 +1,86 @@
+/*
+// Copyright (c) 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mctpd
+{
+
+// The I2C muxes on a root bus and their channels, read from sysfs once and
+// then only when the bus topology changes. Channel device nodes and the muxes'
+// idle_state attributes are kept open, so changing the idle state of a mux is a
+// single write.
+class MuxTopology
+{
+  public:
+    struct Mux
+    {
+        uint8_t address{0u};
+        int idleStateFd{-1};
+        std::string originalIdleState{};
+        std::string idleState{};
+    };
+
+    struct Channel
+    {
+        int bus{-1};
+        // Name of the mux device in sysfs, e.g. 5-0070
+        std::string mux{};
+    };
+
+    explicit MuxTopology(
+        const std::filesystem::path& sysfsDir = "/sys/bus/i2c/devices",
+        const std::filesystem::path& devDir = "/dev");
+    ~MuxTopology();
+
+    MuxTopology(const MuxTopology&) = delete;
+    MuxTopology& operator=(const MuxTopology&) = delete;
+
+    // Reads the muxes on the root bus. Channels and muxes found before keep
+    // their fds, muxes found for the first time get the given idle state.
+    // Returns the fds of channels which are gone. Those stay open till the
+    // next refresh, so traffic still on its way to them can't reach a new
+    // channel which got the same fd number.
+    std::vector<int> refresh(int rootBus, const std::string& newIdleState);
+
+    // Channel fd to its bus number
+    std::map<int, int> getChannelBuses() const;
+    const Mux* getMux(int channelFd) const;
+    std::optional<std::string> getMuxName(int channelFd) const;
+
+    bool setIdleState(int channelFd, const std::string& state);
+    void setIdleStates(const std::string& state);
+    void restoreIdleStates();
+
+  private:
+    bool writeIdleState(const std::string& name, Mux& mux,
+                        const std::string& state);
+
+    std::filesystem::path sysfsDir;
+    std::filesystem::path devDir;
+    std::map<std::string, Mux> muxes;
+    // By channel fd
+    std::map<int, Channel> channels;
+    // Fds of channels removed by the last refresh
+    std::vector<int> retiredFds;
+};
+} // namespace mctpd
@@ -16,45 +16,109 @@
 
 #pragma once
 
+#include "utils/message_buffer.hpp"
+
 #include <libmctp.h>
 
+#include <array>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/steady_timer.hpp>
+#include <chrono>
 #include <map>
+#include <memory>
 #include <optional>
 #include <vector>
 
 namespace mctpd
 {
 
+// Messages queued for different endpoints are transmitted in weighted round
+// robin order across priority classes and endpoints. Endpoints on the same
+// physical segment share a budget of requests in flight, so one busy endpoint
+// can't occupy a shared bus on its own.
+//
+// Messages live in preallocated slots which are reused once disposed, and
+// endpoint state is indexed by EID and tag, so sending a request doesn't
+// allocate unless every slot is in use.
 class MctpTransmissionQueue
 {
   public:
+    enum class Priority : uint8_t
+    {
+        control = 0,
+        normal = 1,
+        bulk = 2,
+    };
+    static constexpr size_t priorityCount = 3;
+
     struct Message
     {
-        Message(size_t index_, std::vector<uint8_t>&& payload_,
-                std::vector<uint8_t>&& privateData_,
-                boost::asio::io_context& ioc);
+        explicit Message(boost::asio::io_context& ioc);
 
-        size_t index{0};
         std::optional<uint8_t> tag;
         std::vector<uint8_t> payload{};
         std::vector<uint8_t> privateData{};
         boost::asio::steady_timer timer;
-        std::optional<std::vector<uint8_t>> response{};
+        // Shares the receive buffer, empty until a response arrives
+        MessageBuffer response{};
+        // Set when libmctp refused the message, no response will come
+        bool failed{false};
+        Priority priority{Priority::normal};
+        uint32_t segment{0u};
+        std::chrono::steady_clock::time_point queuedAt{};
+
+      private:
+        friend class MctpTransmissionQueue;
+
+        mctp_eid_t destEid{0u};
+        bool queued{false};
+        // Links of the endpoint's queue for this message's priority
+        Message* prev{nullptr};
+        Message* next{nullptr};
+    };
+
+    struct EndpointStats
+    {
+        size_t queueDepth{0u};
+        size_t inFlight{0u};
+        uint64_t transmitted{0u};
+        std::chrono::microseconds totalWait{0};
+        std::chrono::microseconds maxWait{0};
     };
 
-    std::shared_ptr<Message> transmit(struct mctp* mctp, mctp_eid_t destEid,
-                                      std::vector<uint8_t>&& payload,
-                                      std::vector<uint8_t>&& privateData,
-                                      boost::asio::io_context& ioc);
+    static constexpr size_t defaultSegmentBudget = 8;
+    static constexpr size_t initialSlots = 32;
+
+    explicit MctpTransmissionQueue(
+        boost::asio::io_context& ioc,
+        size_t segmentBudget = defaultSegmentBudget);
+
+    // The message belongs to the queue until it is passed to dispose, which
+    // has to be done once the caller is done waiting for it
+    Message& transmit(struct mctp* mctp, mctp_eid_t destEid,
+                      std::vector<uint8_t>&& payload,
+                      const std::vector<uint8_t>& privateData,
+                      uint32_t segment = 0u);
 
     bool receive(struct mctp* mctp, mctp_eid_t srcEid, uint8_t msgTag,
-                 std::vector<uint8_t>&& response, boost::asio::io_context& ioc);
+                 const MessageBuffer& response);
 
-    void dispose(mctp_eid_t destEid, const std::shared_ptr<Message>& message);
+    void dispose(struct mctp* mctp, Message& message);
+
+    std::map<mctp_eid_t, EndpointStats> getStats() const;
+
+    size_t getSlotCount() const
+    {
+        return slots.size();
+    }
+
+    // Control messages go first, PLDM firmware update data last
+    static Priority classify(const std::vector<uint8_t>& payload);
 
   private:
+    static constexpr size_t maxEndpoints = 256;
+    static constexpr size_t maxTags = 8;
+
     struct Tags
     {
         std::optional<uint8_t> next() const;
@@ -64,16 +128,49 @@ class MctpTransmissionQueue
         uint8_t bits{0xff};
     };
 
+    struct MessageList
+    {
+        void push(Message& message);
+        Message& pop();
+        void erase(Message& message);
+
+        Message* head{nullptr};
+        Message* tail{nullptr};
+    };
+
     struct Endpoint
     {
         Tags availableTags;
-        std::map<uint8_t, std::shared_ptr<Message>> transmittedMessages{};
-        std::map<size_t, std::shared_ptr<Message>> queuedMessages{};
+        std::array<Message*, maxTags> transmittedMessages{};
+        std::array<MessageList, priorityCount> queuedMessages{};
 
-        size_t msgCounter{0u};
-        void transmitQueuedMessages(struct mctp* mctp, mctp_eid_t destEid);
+        bool used{false};
+        EndpointStats stats{};
     };
 
-    std::map<mctp_eid_t, Endpoint> endpoints{};
+    // One bit per EID with messages queued in a priority class
+    using EidBitmap = std::array<uint64_t, maxEndpoints / 64>;
+
+    // Consecutive turns each priority class gets per scheduling round
+    static constexpr std::array<uint8_t, priorityCount> priorityWeights = {
+        4, 2, 1};
+
+    Message& allocate();
+    bool transmitNext(struct mctp* mctp, Priority priority);
+    bool transmitTo(struct mctp* mctp, mctp_eid_t destEid, Priority priority);
+    void schedule(struct mctp* mctp);
+    void release(Endpoint& endpoint, const Message& message);
+
+    boost::asio::io_context& ioc;
+    size_t segmentBudget;
+    std::vector<std::unique_ptr<Message>> slots{};
+    std::vector<Message*> freeSlots{};
+    std::array<Endpoint, maxEndpoints> endpoints{};
+    std::array<EidBitmap, priorityCount> pending{};
+    std::map<uint32_t, size_t> segmentsInFlight{};
+    std::array<uint8_t, priorityCount> credits = priorityWeights;
+    std::array<size_t, priorityCount> queued{};
+    // Last endpoint served in each priority class
+    std::array<std::optional<mctp_eid_t>, priorityCount> lastServed{};
 };
 } // namespace mctpd
\ No newline at end of file
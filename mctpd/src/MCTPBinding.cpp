@@ -4,7 +4,10 @@
 #include "SMBusBinding.hpp"
 
 #include <systemd/sd-id128.h>
+#include <unistd.h>
 
+#include <boost/asio/post.hpp>
+#include <boost/asio/spawn.hpp>
 #include <phosphor-logging/log.hpp>
 
 #include "libmctp-cmds.h"
@@ -17,7 +20,6 @@ static const std::string nullUUID = "00000000-0000-0000-0000-000000000000";
 
 constexpr sd_id128_t mctpdAppId = SD_ID128_MAKE(c4, e4, d9, 4a, 88, 43, 4d, f0,
                                                 94, 9d, bb, 0a, af, 53, 4e, 6d);
-constexpr unsigned int ctrlTxPollInterval = 5;
 constexpr size_t minCmdRespSize = 4;
 constexpr int completionCodeIndex = 3;
 
@@ -105,55 +107,80 @@ static uint8_t getInstanceId(const uint8_t msg)
     return msg & MCTP_CTRL_HDR_INSTANCE_ID_MASK;
 }
 
-bool MctpBinding::handleCtrlResp(void* msg, const size_t len)
+// A response normally comes from the EID the request was sent to. Requests to
+// the null EID, sent before an endpoint has an EID, and Set Endpoint ID, which
+// is answered from the newly assigned EID, accept any source.
+static bool isCtrlRespSource(const CtrlTxRequest& ctrlTx,
+                             const mctp_eid_t srcEid)
 {
-    mctp_ctrl_msg_hdr* respHeader = reinterpret_cast<mctp_ctrl_msg_hdr*>(msg);
-
-    auto reqItr =
-        std::find_if(ctrlTxQueue.begin(), ctrlTxQueue.end(), [&](auto& ctrlTx) {
-            auto& [state, retryCount, maxRespDelay, destEid, bindingPrivate,
-                   req, callback] = ctrlTx;
-
-            mctp_ctrl_msg_hdr* reqHeader =
-                reinterpret_cast<mctp_ctrl_msg_hdr*>(req.data());
-
-            if (!reqHeader)
-            {
-                phosphor::logging::log<phosphor::logging::level::DEBUG>(
-                    "MCTP Control Request Header is null");
-                return false;
-            }
+    if (ctrlTx.destEid == srcEid || ctrlTx.destEid == MCTP_EID_NULL)
+    {
+        return true;
+    }
+    auto reqHeader =
+        reinterpret_cast<const mctp_ctrl_msg_hdr*>(ctrlTx.req.data());
+    return ctrlTx.req.size() >= sizeof(mctp_ctrl_msg_hdr) &&
+           reqHeader->command_code == MCTP_CTRL_CMD_SET_ENDPOINT_ID;
+}
 
-            // TODO: Check Message terminus with Instance ID
-            // (EID, TO, Msg Tag) + Instance ID
-            if (getInstanceId(reqHeader->rq_dgram_inst) ==
-                getInstanceId(respHeader->rq_dgram_inst))
-            {
-                phosphor::logging::log<phosphor::logging::level::DEBUG>(
-                    "Matching Control command request found");
+// Removes a request from its instance ID slot in O(1), order is not kept
+static CtrlTxRequest takeCtrlTx(std::vector<CtrlTxRequest>& slot,
+                                const size_t index)
+{
+    CtrlTxRequest ctrlTx = std::move(slot[index]);
+    if (index + 1 != slot.size())
+    {
+        slot[index] = std::move(slot.back());
+    }
+    slot.pop_back();
+    return ctrlTx;
+}
 
-                uint8_t* tmp = reinterpret_cast<uint8_t*>(msg);
-                std::vector<uint8_t> resp =
-                    std::vector<uint8_t>(tmp, tmp + len);
-                state = PacketState::receivedResponse;
+bool MctpBinding::handleCtrlResp(mctp_eid_t srcEid, uint8_t msgTag,
+                                 const mctpd::MessageBuffer& response)
+{
+    mctp_ctrl_msg_hdr* respHeader =
+        reinterpret_cast<mctp_ctrl_msg_hdr*>(response->data());
+    auto& slot = ctrlTxTable[getInstanceId(respHeader->rq_dgram_inst)];
 
-                // Call Callback function
-                callback(state, resp);
-                return true;
-            }
-            return false;
+    auto reqItr =
+        std::find_if(slot.begin(), slot.end(), [&](const auto& ctrlTx) {
+            return ctrlTx.msgTag == msgTag && ctrlTx.destEid == srcEid;
         });
+    if (reqItr == slot.end())
+    {
+        reqItr =
+            std::find_if(slot.begin(), slot.end(), [&](const auto& ctrlTx) {
+                return ctrlTx.msgTag == msgTag &&
+                       isCtrlRespSource(ctrlTx, srcEid);
+            });
+    }
+    if (reqItr == slot.end())
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "No matching Control command request found for the response",
+            phosphor::logging::entry("EID=%d", srcEid));
+        return false;
+    }
+
+    phosphor::logging::log<phosphor::logging::level::DEBUG>(
+        "Matching Control command request found");
 
-    if (reqItr != ctrlTxQueue.end())
+    // Delete the entry from the table before calling back. Its deadline is
+    // skipped when popped, or dropped here if nothing else is in flight.
+    CtrlTxRequest ctrlTx =
+        takeCtrlTx(slot, static_cast<size_t>(reqItr - slot.begin()));
+    ctrlInstanceIds.release(ctrlTx.destEid,
+                            getInstanceId(respHeader->rq_dgram_inst));
+    if (--ctrlTxCount == 0)
     {
-        // Delete the entry from queue after receiving response
-        ctrlTxQueue.erase(reqItr);
-        return true;
+        ctrlTxDeadlines = {};
+        armCtrlTxTimer();
     }
 
-    phosphor::logging::log<phosphor::logging::level::WARNING>(
-        "No matching Control command request found for the response");
-    return false;
+    ctrlTx.state = PacketState::receivedResponse;
+    ctrlTx.callback(ctrlTx.state, *response);
+    return true;
 }
 
 /*
@@ -179,24 +206,22 @@ void MctpBinding::rxMessage(uint8_t srcEid, void* data, void* msg, size_t len,
 
     uint8_t* payload = reinterpret_cast<uint8_t*>(msg);
     uint8_t msgType = payload[0]; // Always the first byte
-    std::vector<uint8_t> response;
-
-    response.assign(payload, payload + len);
-
     auto& binding = *static_cast<MctpBinding*>(data);
 
+    // The only copy of the message, every consumer below shares the buffer
+    auto response = binding.rxBufferPool.acquire(msg, len);
+
     if (binding.bindingModeType == mctp_server::BindingModeTypes::Endpoint)
     {
         binding.addUnknownEIDToDeviceTable(srcEid, bindingPrivate);
     }
 
-    // TODO: Take into account the msgTags too when we verify control messages.
     if (!tagOwner && mctp_is_mctp_ctrl_msg(msg, len) &&
         !mctp_ctrl_msg_is_req(msg, len))
     {
         phosphor::logging::log<phosphor::logging::level::DEBUG>(
             "MCTP Control packet response received!!");
-        if (binding.handleCtrlResp(msg, len))
+        if (binding.handleCtrlResp(srcEid, msgTag, response))
         {
             return;
         }
@@ -204,16 +229,98 @@ void MctpBinding::rxMessage(uint8_t srcEid, void* data, void* msg, size_t len,
 
     if (!tagOwner &&
         binding.transmissionQueue.receive(binding.mctp, srcEid, msgTag,
-                                          std::move(response), binding.io))
+                                          response))
     {
         return;
     }
 
-    auto msgSignal = binding.connection->new_signal("/xyz/openbmc_project/mctp",
-                                                    mctp_server::interface,
-                                                    "MessageReceivedSignal");
-    msgSignal.append(msgType, srcEid, msgTag, tagOwner, response);
-    msgSignal.signal_send();
+    binding.deliverMessage(msgType, srcEid, msgTag, tagOwner, response);
+}
+
+void MctpBinding::deliverMessage(uint8_t msgType, mctp_eid_t srcEid,
+                                 uint8_t msgTag, bool tagOwner,
+                                 const mctpd::MessageBuffer& msg)
+{
+    auto delivery = messageSubscribers.getDelivery(*msg);
+
+    // Clients which did not register filter the broadcast themselves.
+    // Registered clients get it as well, so it is never sent twice.
+    if (delivery.broadcast)
+    {
+        auto msgSignal = connection->new_signal("/xyz/openbmc_project/mctp",
+                                                mctp_server::interface,
+                                                "MessageReceivedSignal");
+        msgSignal.append(msgType, srcEid, msgTag, tagOwner, *msg);
+        msgSignal.signal_send();
+        return;
+    }
+
+    for (const auto& recipient : delivery.recipients)
+    {
+        auto msgSignal = connection->new_signal("/xyz/openbmc_project/mctp",
+                                                mctp_server::interface,
+                                                "MessageReceivedSignal");
+        if (sd_bus_message_set_destination(msgSignal.get(),
+                                           recipient.c_str()) < 0)
+        {
+            phosphor::logging::log<phosphor::logging::level::ERR>(
+                "Failed to set message signal destination",
+                phosphor::logging::entry("CLIENT=%s", recipient.c_str()));
+            continue;
+        }
+        msgSignal.append(msgType, srcEid, msgTag, tagOwner, *msg);
+        msgSignal.signal_send();
+    }
+}
+
+bool MctpBinding::registerMessageSubscriber(
+    const std::string& client, const mctpd::MessageSubscribers::Filter& filter)
+{
+    if (!messageSubscribers.subscribe(client, filter))
+    {
+        return false;
+    }
+
+    if (subscriberWatches.find(client) == subscriberWatches.end())
+    {
+        // Unique names are never reused, so any owner change means the client
+        // has left the bus
+        subscriberWatches.emplace(
+            client,
+            std::make_unique<sdbusplus::bus::match::match>(
+                static_cast<sdbusplus::bus::bus&>(*connection),
+                sdbusplus::bus::match::rules::nameOwnerChanged(client),
+                [this, client](sdbusplus::message::message&) {
+                    messageSubscribers.removeClient(client);
+                    // The match can't be destroyed from its own callback
+                    boost::asio::post(io, [this, client]() {
+                        subscriberWatches.erase(client);
+                    });
+                    phosphor::logging::log<phosphor::logging::level::INFO>(
+                        "Message subscriber left",
+                        phosphor::logging::entry("CLIENT=%s", client.c_str()));
+                }));
+    }
+
+    phosphor::logging::log<phosphor::logging::level::INFO>(
+        "Message subscriber registered",
+        phosphor::logging::entry("CLIENT=%s", client.c_str()),
+        phosphor::logging::entry("MSG_TYPE=%d", filter.msgType));
+    return true;
+}
+
+bool MctpBinding::unregisterMessageSubscriber(
+    const std::string& client, const mctpd::MessageSubscribers::Filter& filter)
+{
+    if (!messageSubscribers.unsubscribe(client, filter))
+    {
+        return false;
+    }
+    if (!messageSubscribers.hasClient(client))
+    {
+        subscriberWatches.erase(client);
+    }
+    return true;
 }
 
 void MctpBinding::handleMCTPControlRequests(uint8_t srcEid, void* data,
@@ -255,11 +362,18 @@ void MctpBinding::handleMCTPControlRequests(uint8_t srcEid, void* data,
     binding.handleCtrlReq(srcEid, bindingPrivate, msg, len, msgTag);
 }
 
-std::optional<std::vector<uint8_t>>
+const std::vector<uint8_t>*
     MctpBinding::getBindingPrivateData(uint8_t /*dstEid*/)
 {
     // No Binding data by default
-    return std::vector<uint8_t>();
+    static const std::vector<uint8_t> noPrivateData;
+    return &noPrivateData;
+}
+
+uint32_t MctpBinding::getTransmitSegment(mctp_eid_t /*dstEid*/)
+{
+    // All endpoints share one medium by default
+    return 0;
 }
 
 bool MctpBinding::reserveBandwidth(const mctp_eid_t /*eid*/,
@@ -288,7 +402,13 @@ MctpBinding::MctpBinding(std::shared_ptr<sdbusplus::asio::connection> conn,
                          boost::asio::io_context& ioc,
                          const mctp_server::BindingTypes bindingType) :
     connection(conn),
-    io(ioc), objectServer(objServer), bindingID(bindingType), ctrlTxTimer(io)
+    io(ioc), objectServer(objServer), transmissionQueue(io),
+    bindingID(bindingType), ctrlTxTimer(io), snapshotTimer(io),
+    firstEndpointGeneration(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count())),
+    endpointGeneration(firstEndpointGeneration)
 {
     objServer->add_manager(objPath);
     mctpInterface = objServer->add_interface(objPath, mctp_server::interface);
@@ -309,6 +429,8 @@ MctpBinding::MctpBinding(std::shared_ptr<sdbusplus::asio::connection> conn,
 
         ctrlTxRetryDelay = conf.reqToRespTime;
         ctrlTxRetryCount = conf.reqRetryCount;
+        snapshotFile = conf.snapshotFile;
+        messageSubscribers.setDirectedOnlyTypes(conf.directedOnlyMsgTypes);
 
         createUuid();
         registerProperty(mctpInterface, "Eid", ownEid);
@@ -338,42 +460,8 @@ MctpBinding::MctpBinding(std::shared_ptr<sdbusplus::asio::connection> conn,
             "SendMctpMessagePayload",
             [this](uint8_t dstEid, uint8_t msgTag, bool tagOwner,
                    std::vector<uint8_t> payload) {
-                if (payload.size() > 0)
-                {
-                    uint8_t msgType = payload[0]; // Always the first byte
-                    if (msgType == MCTP_MESSAGE_TYPE_MCTP_CTRL)
-                    {
-                        phosphor::logging::log<
-                            phosphor::logging::level::WARNING>(
-                            "Transmiting control messages");
-                    }
-                }
-
-                if (rsvBWActive && dstEid != reservedEID)
-                {
-                    phosphor::logging::log<phosphor::logging::level::WARNING>(
-                        (("SendMctpMessagePayload is not allowed. "
-                          "ReserveBandwidth is active "
-                          "for EID: ") +
-                         std::to_string(reservedEID))
-                            .c_str());
-                    return static_cast<int>(mctpErrorRsvBWIsNotActive);
-                }
-                std::optional<std::vector<uint8_t>> pvtData =
-                    getBindingPrivateData(dstEid);
-                if (!pvtData)
-                {
-                    phosphor::logging::log<phosphor::logging::level::ERR>(
-                        "SendMctpMessagePayload: Invalid destination EID");
-                    return static_cast<int>(mctpInternalError);
-                }
-                if (mctp_message_tx(mctp, dstEid, payload.data(),
-                                    payload.size(), tagOwner, msgTag,
-                                    pvtData->data()) < 0)
-                {
-                    return static_cast<int>(mctpInternalError);
-                }
-                return static_cast<int>(mctpSuccess);
+                return sendMctpMessage(dstEid, msgTag, tagOwner,
+                                       std::move(payload));
             });
 
         mctpInterface->register_method(
@@ -412,73 +500,11 @@ MctpBinding::MctpBinding(std::shared_ptr<sdbusplus::asio::connection> conn,
             [this](boost::asio::yield_context yield, uint8_t dstEid,
                    std::vector<uint8_t> payload,
                    uint16_t timeout) -> std::vector<uint8_t> {
-                if (rsvBWActive && dstEid != reservedEID)
-                {
-                    phosphor::logging::log<phosphor::logging::level::WARNING>(
-                        (("SendReceiveMctpMessagePayload is not allowed. "
-                          "ReserveBandwidth is "
-                          "active for EID: ") +
-                         std::to_string(reservedEID))
-                            .c_str());
-                    throw std::system_error(
-                        std::make_error_code(std::errc::invalid_argument));
-                }
-
-                if (payload.size() > 0)
-                {
-                    uint8_t msgType = payload[0]; // Always the first byte
-                    if (msgType == MCTP_MESSAGE_TYPE_MCTP_CTRL)
-                    {
-                        phosphor::logging::log<
-                            phosphor::logging::level::WARNING>(
-                            "Transmiting control message");
-                    }
-                }
-
-                std::optional<std::vector<uint8_t>> pvtData =
-                    getBindingPrivateData(dstEid);
-                if (!pvtData)
-                {
-                    phosphor::logging::log<phosphor::logging::level::ERR>(
-                        "SendReceiveMctpMessagePayload: Invalid destination "
-                        "EID");
-                    throw std::system_error(
-                        std::make_error_code(std::errc::invalid_argument));
-                }
-
-                boost::system::error_code ec;
-                auto message =
-                    transmissionQueue.transmit(mctp, dstEid, std::move(payload),
-                                               std::move(pvtData).value(), io);
-
-                message->timer.expires_after(
-                    std::chrono::milliseconds(timeout));
-                message->timer.async_wait(yield[ec]);
-
-                if (ec && ec != boost::asio::error::operation_aborted)
-                {
-                    transmissionQueue.dispose(dstEid, message);
-                    phosphor::logging::log<phosphor::logging::level::ERR>(
-                        "Timer failed");
-                    throw std::system_error(
-                        std::make_error_code(std::errc::connection_aborted));
-                }
-                if (!message->response)
-                {
-                    transmissionQueue.dispose(dstEid, message);
-                    phosphor::logging::log<phosphor::logging::level::ERR>(
-                        "No response");
-                    throw std::system_error(
-                        std::make_error_code(std::errc::timed_out));
-                }
-                if (message->response->empty())
-                {
-                    phosphor::logging::log<phosphor::logging::level::ERR>(
-                        "Empty response");
-                    throw std::system_error(
-                        std::make_error_code(std::errc::no_message_available));
-                }
-                return std::move(message->response).value();
+                auto response = sendReceiveMctpMessage(
+                    yield, dstEid, std::move(payload), timeout);
+                // Nothing else holds the response by now, hand its storage
+                // over instead of copying. The pool allocates a new one.
+                return std::move(*response);
             });
 
         mctpInterface->register_signal<uint8_t, uint8_t, uint8_t, bool,
@@ -492,6 +518,55 @@ MctpBinding::MctpBinding(std::shared_ptr<sdbusplus::asio::connection> conn,
                 return registerUpperLayerResponder(msgTypeName, inputVersion);
             });
 
+        mctpInterface->register_method(
+            "RegisterMessageSubscriber",
+            [this](sdbusplus::message::message& msg, uint8_t msgType,
+                   uint16_t vendorId, uint16_t vendorMsgType,
+                   uint16_t vendorMsgTypeMask) -> bool {
+                return registerMessageSubscriber(
+                    msg.get_sender(),
+                    {msgType, vendorId, vendorMsgType, vendorMsgTypeMask});
+            });
+
+        mctpInterface->register_method(
+            "UnregisterMessageSubscriber",
+            [this](sdbusplus::message::message& msg, uint8_t msgType,
+                   uint16_t vendorId, uint16_t vendorMsgType,
+                   uint16_t vendorMsgTypeMask) -> bool {
+                return unregisterMessageSubscriber(
+                    msg.get_sender(),
+                    {msgType, vendorId, vendorMsgType, vendorMsgTypeMask});
+            });
+
+        mctpInterface->register_method(
+            "GetMessageDeliveryCounters",
+            [this]() { return messageSubscribers.getDeliveryCounters(); });
+
+        mctpInterface->register_method("GetRxBufferCounters", [this]() {
+            const auto& counters = rxBufferPool.getCounters();
+            return std::map<std::string, uint64_t>{
+                {"Acquired", counters.acquired},
+                {"Allocations", counters.allocations},
+                {"BytesCopied", counters.bytesCopied}};
+        });
+
+        mctpInterface->register_method("GetTransmissionQueueStats", [this]() {
+            std::map<uint8_t, std::map<std::string, uint64_t>> result;
+            for (const auto& [eid, stats] : transmissionQueue.getStats())
+            {
+                result.emplace(
+                    eid, std::map<std::string, uint64_t>{
+                             {"QueueDepth", stats.queueDepth},
+                             {"InFlight", stats.inFlight},
+                             {"Transmitted", stats.transmitted},
+                             {"TotalWaitUs", static_cast<uint64_t>(
+                                                 stats.totalWait.count())},
+                             {"MaxWaitUs", static_cast<uint64_t>(
+                                               stats.maxWait.count())}});
+            }
+            return result;
+        });
+
         // register VDPCI responder with MCTP for upper layers
         mctpInterface->register_method(
             "RegisterVdpciResponder",
@@ -499,9 +574,23 @@ MctpBinding::MctpBinding(std::shared_ptr<sdbusplus::asio::connection> conn,
                 return manageVdpciVersionInfo(vendorIdx, cmdSetType);
             });
 
+        mctpInterface->register_method(
+            "GetEndpoints",
+            [this](uint8_t msgType) { return getEndpoints(msgType); });
+
+        mctpInterface->register_method(
+            "GetEndpointsSince", [this](uint64_t generation, uint8_t msgType) {
+                return getEndpointsSince(generation, msgType);
+            });
+
         mctpInterface->register_method("TriggerDeviceDiscovery",
                                        [this]() { triggerDeviceDiscovery(); });
 
+        createDataSocket();
+        registerProperty(mctpInterface, "DataSocket",
+                         dataSocket ? dataSocket->getName() : std::string(),
+                         sdbusplus::asio::PropertyPermission::readOnly);
+
         if (mctpInterface->initialize() == false)
         {
             throw std::system_error(
@@ -517,6 +606,157 @@ MctpBinding::MctpBinding(std::shared_ptr<sdbusplus::asio::connection> conn,
     }
 }
 
+int MctpBinding::sendMctpMessage(mctp_eid_t dstEid, uint8_t msgTag,
+                                 bool tagOwner, std::vector<uint8_t> payload)
+{
+    if (payload.size() > 0)
+    {
+        uint8_t msgType = payload[0]; // Always the first byte
+        if (msgType == MCTP_MESSAGE_TYPE_MCTP_CTRL)
+        {
+            phosphor::logging::log<phosphor::logging::level::WARNING>(
+                "Transmiting control messages");
+        }
+    }
+
+    if (rsvBWActive && dstEid != reservedEID)
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            ("SendMctpMessagePayload is not allowed. ReserveBandwidth is "
+             "active for EID: " +
+             std::to_string(reservedEID))
+                .c_str());
+        return static_cast<int>(mctpErrorRsvBWIsNotActive);
+    }
+    const std::vector<uint8_t>* pvtData = getBindingPrivateData(dstEid);
+    if (!pvtData)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "SendMctpMessagePayload: Invalid destination EID");
+        return static_cast<int>(mctpInternalError);
+    }
+    // libmctp copies the binding private data into the packets
+    if (mctp_message_tx(mctp, dstEid, payload.data(), payload.size(),
+                        tagOwner, msgTag,
+                        const_cast<uint8_t*>(pvtData->data())) < 0)
+    {
+        return static_cast<int>(mctpInternalError);
+    }
+    return static_cast<int>(mctpSuccess);
+}
+
+mctpd::MessageBuffer
+    MctpBinding::sendReceiveMctpMessage(boost::asio::yield_context yield,
+                                        mctp_eid_t dstEid,
+                                        std::vector<uint8_t> payload,
+                                        uint16_t timeout)
+{
+    if (rsvBWActive && dstEid != reservedEID)
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            ("SendReceiveMctpMessagePayload is not allowed. ReserveBandwidth "
+             "is active for EID: " +
+             std::to_string(reservedEID))
+                .c_str());
+        throw std::system_error(
+            std::make_error_code(std::errc::invalid_argument));
+    }
+
+    if (payload.size() > 0)
+    {
+        uint8_t msgType = payload[0]; // Always the first byte
+        if (msgType == MCTP_MESSAGE_TYPE_MCTP_CTRL)
+        {
+            phosphor::logging::log<phosphor::logging::level::WARNING>(
+                "Transmiting control message");
+        }
+    }
+
+    const std::vector<uint8_t>* pvtData = getBindingPrivateData(dstEid);
+    if (!pvtData)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "SendReceiveMctpMessagePayload: Invalid destination EID");
+        throw std::system_error(
+            std::make_error_code(std::errc::invalid_argument));
+    }
+
+    boost::system::error_code ec;
+    auto& message =
+        transmissionQueue.transmit(mctp, dstEid, std::move(payload), *pvtData,
+                                   getTransmitSegment(dstEid));
+
+    // The message may have failed already while being queued, before there
+    // was a wait to wake up
+    if (!message.failed)
+    {
+        message.timer.expires_after(std::chrono::milliseconds(timeout));
+        message.timer.async_wait(yield[ec]);
+    }
+
+    // The message slot goes back to the queue whatever the outcome
+    auto response = std::move(message.response);
+    bool failed = message.failed;
+    transmissionQueue.dispose(mctp, message);
+
+    if (ec && ec != boost::asio::error::operation_aborted)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>("Timer failed");
+        throw std::system_error(
+            std::make_error_code(std::errc::connection_aborted));
+    }
+    if (failed)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Failed to transmit");
+        throw std::system_error(std::make_error_code(std::errc::io_error));
+    }
+    if (!response)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>("No response");
+        throw std::system_error(std::make_error_code(std::errc::timed_out));
+    }
+    if (response->empty())
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Empty response");
+        throw std::system_error(
+            std::make_error_code(std::errc::no_message_available));
+    }
+    return response;
+}
+
+void MctpBinding::createDataSocket()
+{
+    // Abstract socket names need no cleanup and the pid keeps the name of
+    // every mctpd instance unique. Clients read it from DataSocket property.
+    // Abstract sockets have no file mode, the server checks the peer
+    // credentials of every connection instead.
+    std::string name = "mctpd." + std::to_string(getpid());
+    try
+    {
+        dataSocket = std::make_unique<mctpd::DataSocketServer>(
+            io, name,
+            [this](mctp_eid_t dstEid, uint8_t msgTag, bool tagOwner,
+                   std::vector<uint8_t> payload) {
+                return sendMctpMessage(dstEid, msgTag, tagOwner,
+                                       std::move(payload));
+            },
+            [this](boost::asio::yield_context yield, mctp_eid_t dstEid,
+                   std::vector<uint8_t> payload, uint16_t timeout) {
+                return sendReceiveMctpMessage(yield, dstEid,
+                                              std::move(payload), timeout);
+            });
+    }
+    catch (const std::exception& e)
+    {
+        // D-Bus methods remain available to every client
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "Failed to create data socket",
+            phosphor::logging::entry("ERROR=%s", e.what()));
+    }
+}
+
 bool MctpBinding::registerUpperLayerResponder(uint8_t typeNo,
                                               std::vector<uint8_t>& versionData)
 {
@@ -693,10 +933,29 @@ bool MctpBinding::sendMctpCtrlMessage(mctp_eid_t destEid,
     return true;
 }
 
-void MctpBinding::processCtrlTxQueue()
+void MctpBinding::armCtrlTxTimer()
 {
-    ctrlTxTimerExpired = false;
-    ctrlTxTimer.expires_after(std::chrono::milliseconds(ctrlTxPollInterval));
+    if (ctrlTxDeadlines.empty())
+    {
+        if (ctrlTxTimerDeadline)
+        {
+            ctrlTxTimer.cancel();
+            ctrlTxTimerDeadline.reset();
+            phosphor::logging::log<phosphor::logging::level::DEBUG>(
+                "ctrlTxTable empty, canceling timer");
+        }
+        return;
+    }
+
+    auto deadline = std::get<0>(ctrlTxDeadlines.top());
+    if (ctrlTxTimerDeadline == deadline)
+    {
+        return;
+    }
+
+    // Rearming aborts the wait for the previous deadline
+    ctrlTxTimerDeadline = deadline;
+    ctrlTxTimer.expires_at(deadline);
     ctrlTxTimer.async_wait([this](const boost::system::error_code& ec) {
         if (ec == boost::asio::error::operation_aborted)
         {
@@ -705,72 +964,73 @@ void MctpBinding::processCtrlTxQueue()
                 "ctrlTxTimer operation_aborted");
             return;
         }
-        else if (ec)
+        ctrlTxTimerDeadline.reset();
+        if (ec)
         {
             phosphor::logging::log<phosphor::logging::level::ERR>(
                 "ctrlTxTimer failed");
-            return;
         }
+        processCtrlTxDeadlines();
+    });
+}
 
-        // Discard the packet if retry count exceeded
-
-        ctrlTxQueue.erase(
-            std::remove_if(
-                ctrlTxQueue.begin(), ctrlTxQueue.end(),
-                [this](auto& ctrlTx) {
-                    auto& [state, retryCount, maxRespDelay, destEid,
-                           bindingPrivate, req, callback] = ctrlTx;
-
-                    maxRespDelay -= ctrlTxPollInterval;
-
-                    // If no reponse:
-                    // Retry the packet on every ctrlTxRetryDelay
-                    // Total no of tries = 1 + ctrlTxRetryCount
-                    if (maxRespDelay > 0 &&
-                        state != PacketState::receivedResponse)
-                    {
-                        if (retryCount > 0 &&
-                            maxRespDelay <= retryCount * ctrlTxRetryDelay)
-                        {
-                            if (sendMctpCtrlMessage(destEid, req, true, 0,
-                                                    bindingPrivate))
-                            {
-                                phosphor::logging::log<
-                                    phosphor::logging::level::DEBUG>(
-                                    "Packet transmited");
-                                state = PacketState::transmitted;
-                            }
-
-                            // Decrement retry count
-                            retryCount--;
-                        }
-
-                        return false;
-                    }
-
-                    state = PacketState::noResponse;
-                    std::vector<uint8_t> resp1 = {};
-                    phosphor::logging::log<phosphor::logging::level::DEBUG>(
-                        "Retry timed out, No response");
-
-                    // Call Callback function
-                    callback(state, resp1);
-                    return true;
-                }),
-            ctrlTxQueue.end());
-
-        if (ctrlTxQueue.empty())
+void MctpBinding::processCtrlTxDeadlines()
+{
+    auto now = std::chrono::steady_clock::now();
+    while (!ctrlTxDeadlines.empty() &&
+           std::get<0>(ctrlTxDeadlines.top()) <= now)
+    {
+        auto [deadline, id, instanceId] = ctrlTxDeadlines.top();
+        ctrlTxDeadlines.pop();
+
+        auto& slot = ctrlTxTable[instanceId];
+        auto reqItr = std::find_if(
+            slot.begin(), slot.end(),
+            [id = id](const auto& ctrlTx) { return ctrlTx.id == id; });
+        if (reqItr == slot.end() || reqItr->deadline != deadline)
         {
-            ctrlTxTimer.cancel();
-            ctrlTxTimerExpired = true;
-            phosphor::logging::log<phosphor::logging::level::DEBUG>(
-                "ctrlTxQueue empty, canceling timer");
+            continue;
         }
-        else
+
+        // If no reponse:
+        // Retry the packet on every ctrlTxRetryDelay
+        // Total no of tries = 1 + ctrlTxRetryCount
+        if (reqItr->retryCount > 0)
         {
-            processCtrlTxQueue();
+            if (sendMctpCtrlMessage(reqItr->destEid, reqItr->req, true,
+                                    reqItr->msgTag, reqItr->bindingPrivate))
+            {
+                phosphor::logging::log<phosphor::logging::level::DEBUG>(
+                    "Packet transmited");
+                reqItr->state = PacketState::transmitted;
+            }
+            reqItr->retryCount--;
+            reqItr->deadline =
+                deadline + std::chrono::milliseconds(ctrlTxRetryDelay);
+            ctrlTxDeadlines.emplace(reqItr->deadline, id, instanceId);
+            continue;
         }
-    });
+
+        // Discard the packet if retry count exceeded
+        CtrlTxRequest timedOut =
+            takeCtrlTx(slot, static_cast<size_t>(reqItr - slot.begin()));
+        ctrlInstanceIds.release(timedOut.destEid, instanceId);
+        --ctrlTxCount;
+
+        timedOut.state = PacketState::noResponse;
+        std::vector<uint8_t> resp1 = {};
+        phosphor::logging::log<phosphor::logging::level::DEBUG>(
+            "Retry timed out, No response");
+
+        // Call Callback function
+        timedOut.callback(timedOut.state, resp1);
+    }
+
+    if (ctrlTxCount == 0)
+    {
+        ctrlTxDeadlines = {};
+    }
+    armCtrlTxTimer();
 }
 
 void MctpBinding::handleCtrlReq(uint8_t destEid, void* bindingPrivate,
@@ -791,8 +1051,8 @@ void MctpBinding::handleCtrlReq(uint8_t destEid, void* bindingPrivate,
 
     std::vector<uint8_t> response = {};
     bool sendResponse = false;
-    auto reqPtr = reinterpret_cast<const uint8_t*>(req);
-    std::vector<uint8_t> request(reqPtr, reqPtr + len);
+    auto requestBuffer = rxBufferPool.acquire(req, len);
+    std::vector<uint8_t>& request = *requestBuffer;
     mctp_ctrl_msg_hdr* reqHeader =
         reinterpret_cast<mctp_ctrl_msg_hdr*>(request.data());
 
@@ -975,25 +1235,126 @@ bool MctpBinding::handleGetVdmSupport(
     return false;
 }
 
-void MctpBinding::pushToCtrlTxQueue(
+// Requests outstanding to one destination must not share a tag, endpoints
+// would drop or mismatch them otherwise. Endpoints without an EID yet all sit
+// behind the null EID, those are told apart by their physical address.
+std::optional<uint8_t> MctpBinding::allocateCtrlMsgTag(
+    const mctp_eid_t destEid, const std::vector<uint8_t>& bindingPrivate) const
+{
+    uint32_t usedTags = 0;
+    for (const auto& slot : ctrlTxTable)
+    {
+        for (const auto& ctrlTx : slot)
+        {
+            if (ctrlTx.destEid == destEid &&
+                (destEid != MCTP_EID_NULL ||
+                 ctrlTx.bindingPrivate == bindingPrivate))
+            {
+                usedTags |= uint32_t{1} << ctrlTx.msgTag;
+            }
+        }
+    }
+    for (uint8_t tag = 0; tag <= MCTP_HDR_TAG_MASK; tag++)
+    {
+        if ((usedTags & (uint32_t{1} << tag)) == 0)
+        {
+            return tag;
+        }
+    }
+    return std::nullopt;
+}
+
+bool MctpBinding::pushToCtrlTxQueue(
     PacketState state, const mctp_eid_t destEid,
     const std::vector<uint8_t>& bindingPrivate, const std::vector<uint8_t>& req,
     std::function<void(PacketState, std::vector<uint8_t>&)>& callback)
 {
-    ctrlTxQueue.push_back(std::make_tuple(
-        state, ctrlTxRetryCount, ((ctrlTxRetryCount + 1) * ctrlTxRetryDelay),
-        destEid, bindingPrivate, req, callback));
+    if (req.size() < sizeof(mctp_ctrl_msg_hdr))
+    {
+        return false;
+    }
+    std::optional<uint8_t> ctrlMsgTag =
+        allocateCtrlMsgTag(destEid, bindingPrivate);
+    if (!ctrlMsgTag)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "No free control message tag",
+            phosphor::logging::entry("EID=%d", destEid));
+        return false;
+    }
+    std::optional<uint8_t> instanceId = ctrlInstanceIds.allocate(destEid);
+    if (!instanceId)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "No free control instance ID",
+            phosphor::logging::entry("EID=%d", destEid));
+        return false;
+    }
 
-    if (sendMctpCtrlMessage(destEid, req, true, 0, bindingPrivate))
+    std::vector<uint8_t> instanceReq = req;
+    auto reqHeader = reinterpret_cast<mctp_ctrl_msg_hdr*>(instanceReq.data());
+    reqHeader->rq_dgram_inst =
+        static_cast<uint8_t>((reqHeader->rq_dgram_inst &
+                              ~MCTP_CTRL_HDR_INSTANCE_ID_MASK) |
+                             *instanceId);
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(ctrlTxRetryDelay);
+    uint64_t id = ctrlTxNextId++;
+    auto& ctrlTx = ctrlTxTable[*instanceId].emplace_back(
+        CtrlTxRequest{state, ctrlTxRetryCount, deadline, id, destEid,
+                      *ctrlMsgTag, bindingPrivate, std::move(instanceReq),
+                      callback});
+    ++ctrlTxCount;
+    ctrlTxDeadlines.emplace(deadline, id, *instanceId);
+
+    if (sendMctpCtrlMessage(destEid, ctrlTx.req, true, *ctrlMsgTag,
+                            bindingPrivate))
     {
         phosphor::logging::log<phosphor::logging::level::DEBUG>(
             "Packet transmited");
         state = PacketState::transmitted;
     }
 
-    if (ctrlTxTimerExpired)
+    armCtrlTxTimer();
+    return true;
+}
+
+void MctpBinding::cancelCtrlTx(
+    const std::function<bool(const CtrlTxRequest&)>& isCancelled)
+{
+    std::vector<CtrlTxRequest> cancelled;
+    for (size_t instanceId = 0; instanceId < ctrlTxTable.size(); instanceId++)
+    {
+        auto& slot = ctrlTxTable[instanceId];
+        for (size_t index = 0; index < slot.size();)
+        {
+            if (!isCancelled(slot[index]))
+            {
+                index++;
+                continue;
+            }
+            // Its deadline is skipped when popped
+            cancelled.emplace_back(takeCtrlTx(slot, index));
+            ctrlInstanceIds.release(cancelled.back().destEid,
+                                    static_cast<uint8_t>(instanceId));
+            --ctrlTxCount;
+        }
+    }
+    if (cancelled.empty())
+    {
+        return;
+    }
+    if (ctrlTxCount == 0)
     {
-        processCtrlTxQueue();
+        ctrlTxDeadlines = {};
+        armCtrlTxTimer();
+    }
+
+    for (auto& ctrlTx : cancelled)
+    {
+        ctrlTx.state = PacketState::noResponse;
+        std::vector<uint8_t> resp = {};
+        ctrlTx.callback(ctrlTx.state, resp);
     }
 }
 
@@ -1017,6 +1378,8 @@ PacketState MctpBinding::sendAndRcvMctpCtrl(
             phosphor::logging::log<phosphor::logging::level::DEBUG>(
                 "Callback triggered");
 
+            // The response may live in a pooled receive buffer, which must
+            // keep its storage when it goes back to the pool
             resp = response;
             pktState = state;
             timer.cancel();
@@ -1026,14 +1389,18 @@ PacketState MctpBinding::sendAndRcvMctpCtrl(
                     .c_str());
         };
 
-    pushToCtrlTxQueue(pktState, destEid, bindingPrivate, req, callback);
+    if (!pushToCtrlTxQueue(pktState, destEid, bindingPrivate, req, callback))
+    {
+        return PacketState::invalidPacket;
+    }
 
-    // Wait for the state to change
+    // Wait for the state to change. The callback cancels the timer once the
+    // response is received or the request has timed out.
+    timer.expires_at(boost::asio::steady_timer::time_point::max());
     while (pktState == PacketState::pushedForTransmission)
     {
-        timer.expires_after(std::chrono::milliseconds(ctrlTxRetryDelay));
         phosphor::logging::log<phosphor::logging::level::DEBUG>(
-            "sendAndRcvMctpCtrl: Timer created, ctrl cmd waiting");
+            "sendAndRcvMctpCtrl: ctrl cmd waiting");
         timer.async_wait(yield[ec]);
         if (ec && ec != boost::asio::error::operation_aborted)
         {
@@ -1045,19 +1412,10 @@ PacketState MctpBinding::sendAndRcvMctpCtrl(
     return pktState;
 }
 
-static uint8_t createInstanceId()
-{
-    static uint8_t instanceId = 0x00;
-
-    instanceId = (instanceId + 1) & MCTP_CTRL_HDR_INSTANCE_ID_MASK;
-    return instanceId;
-}
-
+// The instance ID is filled in per destination EID once the request is queued
 static uint8_t getRqDgramInst()
 {
-    uint8_t instanceID = createInstanceId();
-    uint8_t rqDgramInst = instanceID | MCTP_CTRL_HDR_FLAG_REQUEST;
-    return rqDgramInst;
+    return MCTP_CTRL_HDR_FLAG_REQUEST;
 }
 
 template <int cmd, typename... Args>
@@ -1738,6 +2096,9 @@ bool MctpBinding::populateEndpointProperties(
         vendorIdInterface.emplace(epProperties.endpointEid,
                                   std::move(vendorIdIntf));
     }
+    endpointProperties.insert_or_assign(epProperties.endpointEid,
+                                        epProperties);
+    endpointChanged(epProperties.endpointEid);
     phosphor::logging::log<phosphor::logging::level::WARNING>(
         ("Device Registered: EID = " + std::to_string(epProperties.endpointEid))
             .c_str());
@@ -1934,9 +2295,31 @@ std::optional<mctp_eid_t> MctpBinding::busOwnerRegisterEndpoint(
     const std::vector<uint8_t>& bindingPrivate, mctp_eid_t eid)
 {
     MctpVersionSupportCtrlResp getMctpControlVersion = {};
-    if (!(getMctpVersionSupportCtrlCmd(yield, bindingPrivate, MCTP_EID_NULL,
-                                       MCTP_MESSAGE_TYPE_MCTP_CTRL,
-                                       &getMctpControlVersion)))
+    std::vector<uint8_t> getEidResp = {};
+    std::vector<uint8_t> getUuidResp = {};
+    bool versionReceived = false;
+    bool eidReceived = false;
+    bool uuidReceived = false;
+
+    // None of these depends on another, so they are in flight together
+    // instead of costing a round trip each
+    runConcurrently(
+        yield,
+        {[&](boost::asio::yield_context stepYield) {
+             versionReceived = getMctpVersionSupportCtrlCmd(
+                 stepYield, bindingPrivate, MCTP_EID_NULL,
+                 MCTP_MESSAGE_TYPE_MCTP_CTRL, &getMctpControlVersion);
+         },
+         [&](boost::asio::yield_context stepYield) {
+             eidReceived = getEidCtrlCmd(stepYield, bindingPrivate,
+                                         MCTP_EID_NULL, getEidResp);
+         },
+         [&](boost::asio::yield_context stepYield) {
+             uuidReceived = getUuidCtrlCmd(stepYield, bindingPrivate,
+                                           MCTP_EID_NULL, getUuidResp);
+         }});
+
+    if (!versionReceived)
     {
         phosphor::logging::log<phosphor::logging::level::DEBUG>(
             "Get MCTP Control Version failed");
@@ -1945,8 +2328,7 @@ std::optional<mctp_eid_t> MctpBinding::busOwnerRegisterEndpoint(
 
     // TODO: Validate MCTP Control message version supported
 
-    std::vector<uint8_t> getEidResp = {};
-    if (!(getEidCtrlCmd(yield, bindingPrivate, MCTP_EID_NULL, getEidResp)))
+    if (!eidReceived)
     {
         phosphor::logging::log<phosphor::logging::level::DEBUG>(
             "Get EID failed");
@@ -1964,8 +2346,7 @@ std::optional<mctp_eid_t> MctpBinding::busOwnerRegisterEndpoint(
 
     logUnsupportedMCTPVersion(getMctpControlVersion.verNoEntry, eid);
 
-    std::vector<uint8_t> getUuidResp = {};
-    if (!(getUuidCtrlCmd(yield, bindingPrivate, MCTP_EID_NULL, getUuidResp)))
+    if (!uuidReceived)
     {
         phosphor::logging::log<phosphor::logging::level::DEBUG>(
             "Get UUID failed");
@@ -2001,7 +2382,7 @@ std::optional<mctp_eid_t> MctpBinding::busOwnerRegisterEndpoint(
     {
         try
         {
-            eid = eidPool.getAvailableEidFromPool();
+            eid = eidPool.getAvailableEidFromPool(destUUID);
         }
         catch (const std::exception&)
         {
@@ -2034,6 +2415,7 @@ std::optional<mctp_eid_t> MctpBinding::busOwnerRegisterEndpoint(
         return std::nullopt;
     }
     eidPool.updateEidStatus(eid, true);
+    eidPool.setEidAffinity(destUUID, eid);
 
     // Get Message Type Support
     MsgTypeSupportCtrlResp msgTypeSupportResp;
@@ -2185,6 +2567,32 @@ bool MctpBinding::removeInterface(mctp_eid_t eid,
     return false;
 }
 
+void MctpBinding::runConcurrently(
+    boost::asio::yield_context yield,
+    const std::vector<std::function<void(boost::asio::yield_context)>>& steps)
+{
+    size_t pending = steps.size();
+    // Never expires, the last step to finish cancels it
+    boost::asio::steady_timer done(
+        io, boost::asio::steady_timer::time_point::max());
+    for (const auto& step : steps)
+    {
+        boost::asio::spawn(
+            io, [&step, &pending, &done](boost::asio::yield_context stepYield) {
+                step(stepYield);
+                if (--pending == 0)
+                {
+                    done.cancel();
+                }
+            });
+    }
+    while (pending != 0)
+    {
+        boost::system::error_code ec;
+        done.async_wait(yield[ec]);
+    }
+}
+
 void MctpBinding::unregisterEndpoint(mctp_eid_t eid)
 {
     bool epIntf = removeInterface(eid, endpointInterface);
@@ -2192,6 +2600,10 @@ void MctpBinding::unregisterEndpoint(mctp_eid_t eid)
     bool uuidIntf = removeInterface(eid, uuidInterface);
     // Vendor ID interface is optional thus not considering return status
     removeInterface(eid, vendorIdInterface);
+    if (endpointProperties.erase(eid) != 0)
+    {
+        endpointChanged(eid);
+    }
 
     if (epIntf && msgTypeIntf && uuidIntf)
     {
@@ -2233,3 +2645,275 @@ void MctpBinding::addUnknownEIDToDeviceTable(const mctp_eid_t, void*)
 {
     // Do nothing
 }
+
+std::optional<std::string> MctpBinding::getEndpointAddress(mctp_eid_t)
+{
+    return std::nullopt;
+}
+
+bool MctpBinding::restoreEndpointAddress(mctp_eid_t, const std::string&)
+{
+    return false;
+}
+
+void MctpBinding::forgetEndpointAddress(mctp_eid_t)
+{
+}
+
+static std::vector<uint8_t> getMsgTypeList(const MsgTypes& msgTypes)
+{
+    std::vector<uint8_t> list;
+    for (auto [supported, msgType] :
+         {std::pair{msgTypes.mctpControl, MCTP_MESSAGE_TYPE_MCTP_CTRL},
+          std::pair{msgTypes.pldm, MCTP_MESSAGE_TYPE_PLDM},
+          std::pair{msgTypes.ncsi, MCTP_MESSAGE_TYPE_NCSI},
+          std::pair{msgTypes.ethernet, MCTP_MESSAGE_TYPE_ETHERNET},
+          std::pair{msgTypes.nvmeMgmtMsg, MCTP_MESSAGE_TYPE_NVME},
+          std::pair{msgTypes.spdm, MCTP_MESSAGE_TYPE_SPDM},
+          std::pair{msgTypes.vdpci, MCTP_MESSAGE_TYPE_VDPCI},
+          std::pair{msgTypes.vdiana, MCTP_MESSAGE_TYPE_VDIANA}})
+    {
+        if (supported)
+        {
+            list.push_back(static_cast<uint8_t>(msgType));
+        }
+    }
+    return list;
+}
+
+void MctpBinding::endpointChanged(mctp_eid_t eid)
+{
+    endpointChanges.insert_or_assign(eid, ++endpointGeneration);
+    scheduleSnapshot();
+}
+
+std::optional<MctpBinding::EndpointEntry>
+    MctpBinding::getEndpointEntry(mctp_eid_t eid, uint8_t msgType) const
+{
+    auto epProperties = endpointProperties.find(eid);
+    if (epProperties == endpointProperties.end())
+    {
+        return std::nullopt;
+    }
+    const auto& [endpointEid, uuid, mode, networkId, endpointMsgTypes,
+                 vendorIdCapabilitySets, vendorIdFormat] =
+        epProperties->second;
+    std::vector<uint8_t> msgTypes = getMsgTypeList(endpointMsgTypes);
+    if (std::find(msgTypes.begin(), msgTypes.end(), msgType) ==
+        msgTypes.end())
+    {
+        return std::nullopt;
+    }
+    return EndpointEntry{endpointEid,
+                         uuid,
+                         mctp_server::convertBindingModeTypesToString(mode),
+                         networkId,
+                         std::move(msgTypes),
+                         vendorIdFormat,
+                         vendorIdCapabilitySets};
+}
+
+std::tuple<uint64_t, std::vector<MctpBinding::EndpointEntry>>
+    MctpBinding::getEndpoints(uint8_t msgType) const
+{
+    std::vector<EndpointEntry> endpoints;
+    endpoints.reserve(endpointProperties.size());
+    for (const auto& epProperties : endpointProperties)
+    {
+        if (auto entry = getEndpointEntry(epProperties.first, msgType))
+        {
+            endpoints.emplace_back(std::move(*entry));
+        }
+    }
+    return {endpointGeneration, std::move(endpoints)};
+}
+
+std::tuple<uint64_t, bool, std::vector<MctpBinding::EndpointEntry>,
+           std::vector<uint8_t>>
+    MctpBinding::getEndpointsSince(uint64_t generation, uint8_t msgType) const
+{
+    // A generation from before mctpd started can't be followed, the caller
+    // gets all endpoints instead and drops those it knew of
+    if (generation < firstEndpointGeneration || generation > endpointGeneration)
+    {
+        auto [currentGeneration, endpoints] = getEndpoints(msgType);
+        return {currentGeneration, true, std::move(endpoints), {}};
+    }
+
+    // Endpoints which changed and no longer support the message type are
+    // reported as removed
+    std::vector<EndpointEntry> changed;
+    std::vector<uint8_t> removed;
+    for (const auto& [eid, changedAt] : endpointChanges)
+    {
+        if (changedAt <= generation)
+        {
+            continue;
+        }
+        if (auto entry = getEndpointEntry(eid, msgType))
+        {
+            changed.emplace_back(std::move(*entry));
+        }
+        else
+        {
+            removed.push_back(eid);
+        }
+    }
+    return {endpointGeneration, false, std::move(changed), std::move(removed)};
+}
+
+void MctpBinding::scheduleSnapshot()
+{
+    // Endpoints come and go in bursts during a scan, write once it settles
+    if (snapshotFile.empty() || snapshotPending)
+    {
+        return;
+    }
+    snapshotPending = true;
+    snapshotTimer.expires_after(snapshotDelay);
+    snapshotTimer.async_wait([this](const boost::system::error_code& ec) {
+        if (ec == boost::asio::error::operation_aborted)
+        {
+            return;
+        }
+        snapshotPending = false;
+        writeSnapshot();
+    });
+}
+
+void MctpBinding::writeSnapshot()
+{
+    std::vector<mctpd::EndpointRecord> endpoints;
+    endpoints.reserve(endpointProperties.size());
+    for (const auto& [eid, epProperties] : endpointProperties)
+    {
+        std::optional<std::string> address = getEndpointAddress(eid);
+        if (!address)
+        {
+            continue;
+        }
+        mctpd::EndpointRecord& endpoint = endpoints.emplace_back();
+        endpoint.eid = eid;
+        endpoint.uuid = epProperties.uuid;
+        endpoint.mode =
+            mctp_server::convertBindingModeTypesToString(epProperties.mode);
+        endpoint.networkId = epProperties.networkId;
+        endpoint.msgTypes = getMsgTypeList(epProperties.endpointMsgTypes);
+        endpoint.vendorIdFormat = epProperties.vendorIdFormat;
+        endpoint.vendorIdCapabilitySets = epProperties.vendorIdCapabilitySets;
+        endpoint.address = std::move(*address);
+    }
+    mctpd::writeEndpointSnapshot(snapshotFile, endpoints);
+}
+
+void MctpBinding::restoreEndpointSnapshot()
+{
+    if (snapshotFile.empty())
+    {
+        return;
+    }
+
+    static constexpr std::array<mctp_server::BindingModeTypes, 3>
+        bindingModes = {mctp_server::BindingModeTypes::BusOwner,
+                        mctp_server::BindingModeTypes::Endpoint,
+                        mctp_server::BindingModeTypes::Bridge};
+    std::vector<mctp_eid_t> restored;
+    for (const auto& endpoint : mctpd::readEndpointSnapshot(snapshotFile))
+    {
+        auto mode = std::find_if(
+            bindingModes.begin(), bindingModes.end(), [&endpoint](auto m) {
+                return mctp_server::convertBindingModeTypesToString(m) ==
+                       endpoint.mode;
+            });
+        if (mode == bindingModes.end() || endpoint.eid == ownEid ||
+            endpoint.eid == MCTP_EID_NULL ||
+            endpointProperties.count(endpoint.eid) != 0 ||
+            !restoreEndpointAddress(endpoint.eid, endpoint.address))
+        {
+            continue;
+        }
+
+        EndpointProperties epProperties;
+        epProperties.endpointEid = endpoint.eid;
+        epProperties.mode = *mode;
+        epProperties.uuid = endpoint.uuid;
+        epProperties.networkId = endpoint.networkId;
+        epProperties.endpointMsgTypes = getMsgTypes(endpoint.msgTypes);
+        epProperties.vendorIdFormat = endpoint.vendorIdFormat;
+        epProperties.vendorIdCapabilitySets = endpoint.vendorIdCapabilitySets;
+        if (!populateEndpointProperties(epProperties))
+        {
+            forgetEndpointAddress(endpoint.eid);
+            continue;
+        }
+        if (endpoint.uuid != nullUUID)
+        {
+            uuidTable.push_back(std::make_pair(endpoint.eid, endpoint.uuid));
+        }
+        if (bindingModeType == mctp_server::BindingModeTypes::BusOwner)
+        {
+            eidPool.updateEidStatus(endpoint.eid, true);
+        }
+        restored.push_back(endpoint.eid);
+    }
+
+    phosphor::logging::log<phosphor::logging::level::INFO>(
+        ("Restored " + std::to_string(restored.size()) +
+         " endpoints from the snapshot")
+            .c_str());
+
+    // Without bus ownership the next routing table from the bus owner tells
+    // which of the restored endpoints are still there
+    if (bindingModeType == mctp_server::BindingModeTypes::BusOwner &&
+        !restored.empty())
+    {
+        boost::asio::spawn(io, [this, restored](
+                                   boost::asio::yield_context yield) {
+            validateRestoredEndpoints(yield, restored);
+        });
+    }
+}
+
+void MctpBinding::validateRestoredEndpoints(
+    boost::asio::yield_context yield, const std::vector<mctp_eid_t>& eids)
+{
+    size_t removed = 0;
+    for (mctp_eid_t eid : eids)
+    {
+        // Discovery may have replaced the endpoint meanwhile
+        const std::vector<uint8_t>* pvtData = getBindingPrivateData(eid);
+        if (endpointProperties.count(eid) == 0 || !pvtData)
+        {
+            continue;
+        }
+
+        // The table may change while waiting for the response
+        const std::vector<uint8_t> bindingPrivate = *pvtData;
+        std::vector<uint8_t> getEidResp = {};
+        if (getEidCtrlCmd(yield, bindingPrivate, eid, getEidResp) &&
+            reinterpret_cast<mctp_ctrl_resp_get_eid*>(getEidResp.data())
+                    ->eid == eid)
+        {
+            continue;
+        }
+
+        phosphor::logging::log<phosphor::logging::level::INFO>(
+            ("Restored endpoint " + std::to_string(eid) +
+             " is gone or has a different EID")
+                .c_str());
+        uuidTable.erase(std::remove_if(uuidTable.begin(), uuidTable.end(),
+                                       [eid](const auto& uuidEntry) {
+                                           return uuidEntry.first == eid;
+                                       }),
+                        uuidTable.end());
+        unregisterEndpoint(eid);
+        forgetEndpointAddress(eid);
+        eidPool.updateEidStatus(eid, false);
+        removed++;
+    }
+
+    phosphor::logging::log<phosphor::logging::level::INFO>(
+        ("Validated " + std::to_string(eids.size()) +
+         " restored endpoints, removed " + std::to_string(removed))
+            .c_str());
+}
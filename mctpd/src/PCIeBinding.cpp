@@ -1,6 +1,22 @@
 #include "PCIeBinding.hpp"
 
 #include <phosphor-logging/log.hpp>
+#include <sstream>
+#include <unordered_set>
+
+namespace
+{
+uint32_t routingEntryKey(uint8_t eid, uint16_t bdf, uint8_t entryType)
+{
+    return static_cast<uint32_t>(eid) << 24 | static_cast<uint32_t>(bdf) << 8 |
+           entryType;
+}
+
+uint32_t bridgeKey(uint8_t eid, uint16_t bdf)
+{
+    return static_cast<uint32_t>(eid) << 16 | bdf;
+}
+} // namespace
 
 PCIeBinding::~PCIeBinding()
 {
@@ -18,7 +34,7 @@ PCIeBinding::PCIeBinding(std::shared_ptr<sdbusplus::asio::connection> conn,
                 mctp_server::BindingTypes::MctpOverPcieVdm),
     hw{std::move(hwParam)}, hwMonitor{std::move(hwMonitorParam)},
     getRoutingInterval(conf.getRoutingInterval),
-    getRoutingTableTimer(ioc, getRoutingInterval)
+    currentRoutingInterval(getRoutingInterval), getRoutingTableTimer(ioc)
 {
     pcieInterface = objServer->add_interface(objPath, pcie_binding::interface);
 
@@ -44,8 +60,7 @@ PCIeBinding::PCIeBinding(std::shared_ptr<sdbusplus::asio::connection> conn,
 
         if (bindingModeType != mctp_server::BindingModeTypes::BusOwner)
         {
-            getRoutingTableTimer.async_wait(
-                std::bind(&PCIeBinding::updateRoutingTable, this));
+            scheduleRoutingTableSync();
         }
     }
     catch (std::exception& e)
@@ -104,26 +119,6 @@ uint16_t PCIeBinding::getRoutingEntryPhysAddr(
          << 8)));
 }
 
-bool PCIeBinding::isEntryInRoutingTable(
-    get_routing_table_entry* routingEntry,
-    const std::vector<routingTableEntry_t>& rt)
-{
-    return std::find_if(rt.begin(), rt.end(),
-                        [&routingEntry](const auto& entry) {
-                            const auto& [eid, endpointBdf, entryType] = entry;
-                            return routingEntry->starting_eid == eid;
-                        }) != rt.end();
-}
-
-bool PCIeBinding::isActiveEntryBehindBridge(
-    get_routing_table_entry* routingEntry,
-    const std::vector<routingTableEntry_t>& rt)
-{
-    return !isEntryInRoutingTable(routingEntry, rt) &&
-           routingEntry->eid_range_size == 1 &&
-           routingEntry->phys_transport_binding_id == MCTP_BINDING_PCIE;
-}
-
 bool PCIeBinding::isEndOfGetRoutingTableResp(uint8_t entryHandle,
                                              uint8_t& responseCount)
 {
@@ -141,51 +136,23 @@ bool PCIeBinding::isEntryBridge(const routingTableEntry_t& routingEntry)
                MCTP_ROUTING_ENTRY_BRIDGE_AND_ENDPOINTS;
 }
 
-bool PCIeBinding::allBridgesCalled(
-    const std::vector<routingTableEntry_t>& rt,
-    const std::vector<calledBridgeEntry_t>& calledBridges)
-{
-    for (auto entry : rt)
-    {
-        if (isEntryBridge(entry) && !isBridgeCalled(entry, calledBridges))
-            return false;
-    }
-    return true;
-}
-
-bool PCIeBinding::isBridgeCalled(
-    const routingTableEntry_t& routingEntry,
-    const std::vector<calledBridgeEntry_t>& calledBridges)
-{
-    return std::find_if(calledBridges.begin(), calledBridges.end(),
-                        [&routingEntry](const auto& bridge) {
-                            const auto& [eid, physAddr] = bridge;
-                            return std::get<0>(routingEntry) == eid &&
-                                   std::get<1>(routingEntry) == physAddr;
-                        }) != calledBridges.end();
-}
-
-void PCIeBinding::readRoutingTable(
-    std::vector<routingTableEntry_t>& rt,
-    std::vector<calledBridgeEntry_t>& calledBridges,
-    std::vector<uint8_t> prvData, boost::asio::yield_context& yield,
-    uint8_t eid, uint16_t physAddr, long entryIndex)
+bool PCIeBinding::readRoutingTable(std::vector<routingTableEntry_t>& rt,
+                                   const std::vector<uint8_t>& prvData,
+                                   boost::asio::yield_context& yield,
+                                   uint8_t eid, uint16_t physAddr)
 {
     std::vector<uint8_t> getRoutingTableEntryResp = {};
     uint8_t entryHandle = 0x00;
     uint8_t responseCount = 0;
-    long insertIndex = entryIndex + 1;
 
     while (!isEndOfGetRoutingTableResp(entryHandle, responseCount))
     {
-        calledBridges.push_back(std::make_tuple(eid, physAddr));
-
         if (!getRoutingTableCtrlCmd(yield, prvData, eid, entryHandle,
                                     getRoutingTableEntryResp))
         {
             phosphor::logging::log<phosphor::logging::level::ERR>(
                 "Get Routing Table failed");
-            return;
+            return false;
         }
 
         auto routingTableHdr =
@@ -227,56 +194,131 @@ void PCIeBinding::readRoutingTable(
                                              routingTableEntry->entry_type));
             }
             else if (eid != busOwnerEid &&
-                     isActiveEntryBehindBridge(routingTableEntry, rt))
+                     routingTableEntry->eid_range_size == 1)
             {
-                rt.insert(rt.begin() + insertIndex,
-                          std::make_tuple(routingTableEntry->starting_eid,
-                                          physAddr,
-                                          routingTableEntry->entry_type));
-                insertIndex++;
+                // Endpoints behind a bridge are reached through the bridge
+                rt.push_back(std::make_tuple(routingTableEntry->starting_eid,
+                                             physAddr,
+                                             routingTableEntry->entry_type));
             }
         }
         entryHandle = routingTableHdr->next_entry_handle;
     }
+    return true;
 }
 
-void PCIeBinding::processBridgeEntries(
-    std::vector<routingTableEntry_t>& rt,
-    std::vector<calledBridgeEntry_t>& calledBridges,
-    boost::asio::yield_context& yield)
+/* Reads the bus owner's routing table and adds the endpoints behind each
+ * bridge after the bridge's entry. Between full syncs only bridges which
+ * weren't in the previous table are asked for their routing table.
+ */
+bool PCIeBinding::readNetworkRoutingTable(std::vector<routingTableEntry_t>& rt,
+                                          const std::vector<uint8_t>& prvData,
+                                          boost::asio::yield_context& yield,
+                                          bool fullSync)
 {
-    std::vector<routingTableEntry_t> rtCopy = rt;
+    if (!readRoutingTable(rt, prvData, yield, busOwnerEid, busOwnerBdf))
+    {
+        return false;
+    }
+
+    std::bitset<256> eids;
+    for (const auto& [eid, endpointBdf, entryType] : rt)
+    {
+        eids.set(eid);
+    }
+    std::unordered_set<uint32_t> calledBridges = {
+        bridgeKey(busOwnerEid, busOwnerBdf)};
+    std::unordered_map<uint32_t, std::vector<routingTableEntry_t>>
+        newBridgeTables;
 
-    for (auto entry = rt.begin(); entry != rt.end(); entry++)
+    // Entries added behind a bridge are visited later on, which takes care
+    // of bridges behind bridges
+    for (size_t index = 0; index < rt.size(); index++)
     {
-        if (!isEntryBridge(*entry) || isBridgeCalled(*entry, calledBridges))
+        const auto [bridgeEid, bridgeBdf, entryType] = rt[index];
+        const uint32_t key = bridgeKey(bridgeEid, bridgeBdf);
+        if (!isEntryBridge(rt[index]) || !calledBridges.emplace(key).second)
+        {
             continue;
+        }
 
-        mctp_nupcie_pkt_private pktPrv;
-        pktPrv.routing = PCIE_ROUTE_BY_ID;
-        pktPrv.remote_id = std::get<1>(*entry);
-        uint8_t* pktPrvPtr = reinterpret_cast<uint8_t*>(&pktPrv);
-        std::vector<uint8_t> prvData = std::vector<uint8_t>(
-            pktPrvPtr, pktPrvPtr + sizeof(mctp_nupcie_pkt_private));
+        std::vector<routingTableEntry_t> bridgeTable;
+        auto cached = bridgeTables.find(key);
+        if (fullSync || cached == bridgeTables.end())
+        {
+            mctp_nupcie_pkt_private pktPrv;
+            pktPrv.routing = PCIE_ROUTE_BY_ID;
+            pktPrv.remote_id = bridgeBdf;
+            uint8_t* pktPrvPtr = reinterpret_cast<uint8_t*>(&pktPrv);
+            std::vector<uint8_t> bridgePrvData = std::vector<uint8_t>(
+                pktPrvPtr, pktPrvPtr + sizeof(mctp_nupcie_pkt_private));
+
+            if (readRoutingTable(bridgeTable, bridgePrvData, yield, bridgeEid,
+                                 bridgeBdf))
+            {
+                newBridgeTables.emplace(key, bridgeTable);
+            }
+            else if (cached != bridgeTables.end())
+            {
+                // Keep the endpoints behind the bridge until it answers
+                bridgeTable = cached->second;
+                newBridgeTables.emplace(key, bridgeTable);
+            }
+        }
+        else
+        {
+            bridgeTable = cached->second;
+            newBridgeTables.emplace(key, bridgeTable);
+        }
 
-        long entryIndex = std::distance(rt.begin(), entry);
-        readRoutingTable(rtCopy, calledBridges, prvData, yield,
-                         std::get<0>(*entry), std::get<1>(*entry), entryIndex);
+        auto insertAt = rt.begin() + static_cast<long>(index) + 1;
+        for (const auto& entry : bridgeTable)
+        {
+            if (eids.test(std::get<0>(entry)))
+            {
+                continue;
+            }
+            eids.set(std::get<0>(entry));
+            insertAt = rt.insert(insertAt, entry) + 1;
+        }
     }
-    rt = rtCopy;
+    bridgeTables = std::move(newBridgeTables);
+    return true;
 }
 
-void PCIeBinding::updateRoutingTable()
+void PCIeBinding::requestRoutingTableSync(bool fullSync)
 {
-    struct mctp_nupcie_pkt_private pktPrv;
-    getRoutingTableTimer.expires_from_now(getRoutingInterval);
+    fullRoutingSyncRequested |= fullSync;
+    routingSyncRequested = true;
+    currentRoutingInterval = getRoutingInterval;
+    // A sync in progress schedules the next one right away once it is done
+    if (!routingSyncInProgress)
+    {
+        getRoutingTableTimer.expires_from_now(boost::posix_time::seconds{0});
+    }
+}
+
+void PCIeBinding::scheduleRoutingTableSync()
+{
+    getRoutingTableTimer.expires_from_now(
+        routingSyncRequested ? boost::posix_time::seconds{0}
+                             : currentRoutingInterval);
     getRoutingTableTimer.async_wait(
         std::bind(&PCIeBinding::updateRoutingTable, this));
+}
+
+void PCIeBinding::updateRoutingTable()
+{
+    struct mctp_nupcie_pkt_private pktPrv;
 
     if (discoveredFlag != pcie_binding::DiscoveryFlags::Discovered)
     {
         phosphor::logging::log<phosphor::logging::level::DEBUG>(
             "Get Routing Table failed, undiscovered");
+        // A pending request would reschedule at once and spin until the
+        // endpoint is discovered, which requests a full sync anyway
+        routingSyncRequested = false;
+        scheduleRoutingTableSync();
         return;
     }
     pktPrv.routing = PCIE_ROUTE_BY_ID;
@@ -285,19 +327,23 @@ void PCIeBinding::updateRoutingTable()
     std::vector<uint8_t> prvData = std::vector<uint8_t>(
         pktPrvPtr, pktPrvPtr + sizeof(mctp_nupcie_pkt_private));
 
-    boost::asio::spawn(io, [prvData, this](boost::asio::yield_context yield) {
+    // Bridges which stayed in the table are read again by every few syncs
+    // only, to notice endpoints coming and going behind them
+    bool fullSync = fullRoutingSyncRequested ||
+                    incrementalRoutingSyncs >= maxIncrementalRoutingSyncs;
+    fullRoutingSyncRequested = false;
+    routingSyncRequested = false;
+    incrementalRoutingSyncs = fullSync ? 0 : incrementalRoutingSyncs + 1;
+    routingSyncInProgress = true;
+
+    boost::asio::spawn(io, [prvData, fullSync,
+                            this](boost::asio::yield_context yield) {
         std::vector<routingTableEntry_t> routingTableTmp;
-        std::vector<calledBridgeEntry_t> calledBridges;
+        bool changed = false;
 
-        readRoutingTable(routingTableTmp, calledBridges, prvData, yield,
-                         busOwnerEid, busOwnerBdf);
-
-        while (!allBridgesCalled(routingTableTmp, calledBridges))
-        {
-            processBridgeEntries(routingTableTmp, calledBridges, yield);
-        }
-
-        if (routingTableTmp != routingTable)
+        if (readNetworkRoutingTable(routingTableTmp, prvData, yield,
+                                    fullSync) &&
+            routingTableTmp != routingTable)
         {
 	    //nu todo
             //if (!setDriverEndpointMap(routingTableTmp))
@@ -307,8 +353,20 @@ void PCIeBinding::updateRoutingTable()
             //}
 
             processRoutingTableChanges(routingTableTmp, yield, prvData);
-            routingTable = routingTableTmp;
+            setRoutingTable(routingTableTmp);
+            unknownEidsSynced.reset();
+            changed = true;
         }
+
+        // Poll again soon after a change and back off while nothing changes
+        currentRoutingInterval =
+            changed || routingSyncRequested ? getRoutingInterval
+                    : boost::posix_time::seconds(std::min(
+                          currentRoutingInterval.total_seconds() * 2,
+                          getRoutingInterval.total_seconds() *
+                              maxRoutingIntervalFactor));
+        routingSyncInProgress = false;
+        scheduleRoutingTableSync();
     });
 }
 
@@ -319,19 +377,28 @@ void PCIeBinding::processRoutingTableChanges(
     const std::vector<routingTableEntry_t>& newTable,
     boost::asio::yield_context& yield, const std::vector<uint8_t>& prvData)
 {
-    struct mctp_nupcie_pkt_private pktPrv;
-    memcpy(&pktPrv, prvData.data(), sizeof(pktPrv));
+    std::unordered_set<uint32_t> oldEntries;
+    std::unordered_set<uint32_t> newEntries;
+    oldEntries.reserve(routingTable.size());
+    newEntries.reserve(newTable.size());
+    for (const auto& [eid, endpointBdf, entryType] : routingTable)
+    {
+        oldEntries.emplace(routingEntryKey(eid, endpointBdf, entryType));
+    }
+    for (const auto& [eid, endpointBdf, entryType] : newTable)
+    {
+        newEntries.emplace(routingEntryKey(eid, endpointBdf, entryType));
+    }
 
     /* find removed endpoints, in case entry is not present
      * in the newly read routing table remove dbus interface
      * for this device
      */
-    for (auto& routingEntry : routingTable)
+    for (const auto& [eid, endpointBdf, entryType] : routingTable)
     {
-        if (find(newTable.begin(), newTable.end(), routingEntry) ==
-            newTable.end())
+        if (!newEntries.contains(routingEntryKey(eid, endpointBdf, entryType)))
         {
-            unregisterEndpoint(std::get<0>(routingEntry));
+            unregisterEndpoint(eid);
         }
     }
 
@@ -341,8 +408,9 @@ void PCIeBinding::processRoutingTableChanges(
      */
     for (auto& routingEntry : newTable)
     {
-        if (find(routingTable.begin(), routingTable.end(), routingEntry) ==
-            routingTable.end())
+        if (!oldEntries.contains(routingEntryKey(std::get<0>(routingEntry),
+                                                 std::get<1>(routingEntry),
+                                                 std::get<2>(routingEntry))))
         {
             mctp_eid_t remoteEid = std::get<0>(routingEntry);
 
@@ -629,6 +697,7 @@ void PCIeBinding::initializeBinding()
             std::make_error_code(std::errc::function_not_supported));
     }
 
+    restoreEndpointSnapshot();
     hw->pollRx();
 
     if (bindingModeType == mctp_server::BindingModeTypes::Endpoint)
@@ -688,27 +757,101 @@ void PCIeBinding::deviceReadyNotify(bool ready)
     pcieInterface->set_property("BDF", bdf);
 }
 
-std::optional<std::vector<uint8_t>>
-    PCIeBinding::getBindingPrivateData(uint8_t dstEid)
+void PCIeBinding::setRoutingTable(
+    const std::vector<routingTableEntry_t>& newTable)
 {
-    mctp_nupcie_pkt_private pktPrv = {};
+    routingTable = newTable;
+    bindingPrivateTable.clear();
+    for (const auto& [eid, endpointBdf, entryType] : routingTable)
+    {
+        // The first entry of an EID is the one messages are routed by
+        if (bindingPrivateTable.contains(eid))
+        {
+            continue;
+        }
+        mctp_nupcie_pkt_private pktPrv = {};
+        pktPrv.routing = PCIE_ROUTE_BY_ID;
+        pktPrv.remote_id = endpointBdf;
+        uint8_t* pktPrvPtr = reinterpret_cast<uint8_t*>(&pktPrv);
+        bindingPrivateTable.set(
+            eid, endpointBdf,
+            std::vector<uint8_t>(pktPrvPtr, pktPrvPtr + sizeof(pktPrv)));
+    }
+}
 
-    pktPrv.routing = PCIE_ROUTE_BY_ID;
-    auto it = find_if(routingTable.begin(), routingTable.end(),
-                      [&dstEid](const auto& entry) {
-                          const auto& [eid, endpointBdf, entryType] = entry;
-                          return eid == dstEid;
-                      });
-    if (it == routingTable.end())
+void PCIeBinding::addUnknownEIDToDeviceTable(const mctp_eid_t eid, void*)
+{
+    // The bus owner assigned the EID since the last sync, each unknown EID
+    // triggers one sync until the routing table changes. The endpoint may
+    // sit behind a bridge whose table is otherwise reused, so all bridges
+    // are read again.
+    if (discoveredFlag != pcie_binding::DiscoveryFlags::Discovered ||
+        eid == MCTP_EID_NULL || bindingPrivateTable.contains(eid) ||
+        unknownEidsSynced.test(eid))
+    {
+        return;
+    }
+    unknownEidsSynced.set(eid);
+    requestRoutingTableSync(true);
+}
+
+std::optional<std::string> PCIeBinding::getEndpointAddress(mctp_eid_t eid)
+{
+    auto entry = std::find_if(
+        routingTable.begin(), routingTable.end(),
+        [eid](const auto& routingEntry) {
+            return std::get<0>(routingEntry) == eid;
+        });
+    if (entry == routingTable.end())
+    {
+        return std::nullopt;
+    }
+    std::stringstream stream;
+    stream << std::hex << std::get<1>(*entry) << ':'
+           << static_cast<unsigned>(std::get<2>(*entry));
+    return stream.str();
+}
+
+bool PCIeBinding::restoreEndpointAddress(mctp_eid_t eid,
+                                         const std::string& address)
+{
+    // Kept until the first routing table sync, which drops the endpoints
+    // missing from the bus owner's table
+    unsigned endpointBdf = 0;
+    unsigned entryType = 0;
+    char separator = 0;
+    std::istringstream stream(address);
+    if (!(stream >> std::hex >> endpointBdf >> separator >> entryType) ||
+        separator != ':' || endpointBdf > 0xffff || entryType > 0xff)
+    {
+        return false;
+    }
+    std::vector<routingTableEntry_t> newTable = routingTable;
+    newTable.emplace_back(eid, static_cast<uint16_t>(endpointBdf),
+                          static_cast<uint8_t>(entryType));
+    setRoutingTable(newTable);
+    return true;
+}
+
+void PCIeBinding::forgetEndpointAddress(mctp_eid_t eid)
+{
+    std::vector<routingTableEntry_t> newTable = routingTable;
+    std::erase_if(newTable, [eid](const auto& routingEntry) {
+        return std::get<0>(routingEntry) == eid;
+    });
+    setRoutingTable(newTable);
+}
+
+const std::vector<uint8_t>* PCIeBinding::getBindingPrivateData(uint8_t dstEid)
+{
+    const std::vector<uint8_t>* pktPrv =
+        bindingPrivateTable.getPrivateData(dstEid);
+    if (!pktPrv)
     {
         phosphor::logging::log<phosphor::logging::level::INFO>(
             "Eid not found in routing table");
-        return std::nullopt;
     }
-    const auto& [eid, endpointBdf, entryType] = *it;
-    pktPrv.remote_id = endpointBdf;
-    uint8_t* pktPrvPtr = reinterpret_cast<uint8_t*>(&pktPrv);
-    return std::vector<uint8_t>(pktPrvPtr, pktPrvPtr + sizeof(pktPrv));
+    return pktPrv;
 }
 
 void PCIeBinding::changeDiscoveredFlag(pcie_binding::DiscoveryFlags flag)
@@ -721,6 +864,6 @@ void PCIeBinding::changeDiscoveredFlag(pcie_binding::DiscoveryFlags flag)
     {
 	//nu todo
         //mctp_nupcie_free(pcie);
-        getRoutingTableTimer.expires_from_now(boost::posix_time::seconds{0});
+        requestRoutingTableSync(true);
     }
 }
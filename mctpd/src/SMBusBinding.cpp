@@ -10,10 +10,8 @@ extern "C" {
 }
 
 #include <boost/algorithm/string.hpp>
-#include <filesystem>
 #include <fstream>
 #include <phosphor-logging/log.hpp>
-#include <regex>
 #include <string>
 #include <xyz/openbmc_project/MCTP/Binding/SMBus/server.hpp>
 
@@ -22,7 +20,6 @@ extern "C" {
 using smbus_server =
     sdbusplus::xyz::openbmc_project::MCTP::Binding::server::SMBus;
 
-namespace fs = std::filesystem;
 std::map<MuxIdleModes, std::string> muxIdleModesMap{
     {MuxIdleModes::muxIdleModeConnect, "-1"},
     {MuxIdleModes::muxIdleModeDisconnect, "-2"},
@@ -101,24 +98,6 @@ static bool isNum(const std::string& s)
     return true;
 }
 
-static bool findFiles(const fs::path& dirPath, const std::string& matchString,
-                      std::vector<std::string>& foundPaths)
-{
-    if (!fs::exists(dirPath))
-        return false;
-
-    std::regex search(matchString);
-    for (const auto& p : fs::directory_iterator(dirPath))
-    {
-        const std::string path = p.path().string();
-        if (std::regex_search(path, search))
-        {
-            foundPaths.emplace_back(path);
-        }
-    }
-    return true;
-}
-
 static bool getBusNumFromPath(const std::string& path, std::string& busStr)
 {
     std::vector<std::string> parts;
@@ -134,116 +113,61 @@ static bool getBusNumFromPath(const std::string& path, std::string& busStr)
     return false;
 }
 
-static bool getRootBus(const std::string& muxBus, std::string& rootBus)
+const std::vector<uint8_t>* SMBusBinding::getBindingPrivateData(uint8_t dstEid)
 {
-    auto ec = std::error_code();
-    auto path = fs::read_symlink(
-        fs::path("/sys/bus/i2c/devices/i2c-" + muxBus + "/mux_device"), ec);
-    if (ec)
-    {
-        return false;
-    }
-
-    std::string filename = path.filename();
-    std::vector<std::string> parts;
-    boost::split(parts, filename, boost::is_any_of("-"));
-    if (parts.size() == 2)
-    {
-        rootBus = parts[0];
-        if (isNum(rootBus))
-        {
-            return true;
-        }
-    }
-    return false;
+    return bindingPrivateTable.getPrivateData(dstEid);
 }
 
-static bool isMuxBus(const std::string& bus)
+uint32_t SMBusBinding::getTransmitSegment(mctp_eid_t /*dstEid*/)
 {
-    return is_symlink(
-        fs::path("/sys/bus/i2c/devices/i2c-" + bus + "/mux_device"));
+    // Mux channels are only switches on the root bus, so endpoints behind
+    // any mux port share the root bus wires with the ones on it directly
+    return rootBus < 0 ? 0 : static_cast<uint32_t>(rootBus);
 }
 
-std::map<int, int> SMBusBinding::getMuxFds(const std::string& rootPort)
+void SMBusBinding::indexDeviceTableEntry(const DeviceTableEntry_t& entry)
 {
-    auto devDir = fs::path("/dev/");
-    auto matchString = std::string(R"(i2c-\d+$)");
-    std::vector<std::string> i2cBuses{};
-
-    // Search for mux ports
-    if (!findFiles(devDir, matchString, i2cBuses))
+    const auto& [eid, device] = entry;
+    mctp_smbus_pkt_private prvt = {};
+    prvt.fd = device.fd;
+    if (muxPortMap.count(prvt.fd) != 0)
     {
-        throwRunTimeError("unable to find i2c devices");
+        prvt.mux_hold_timeout = 1000;
+        prvt.mux_flags = IS_MUX_PORT;
     }
-
-    std::map<int, int> muxes;
-    for (const auto& i2cPath : i2cBuses)
+    else
     {
-        std::string i2cPort;
-        std::string rootBus;
-        if (!getBusNumFromPath(i2cPath, i2cPort))
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "i2c bus path is malformed",
-                phosphor::logging::entry("PATH=%s", i2cPath.c_str()));
-            continue;
-        }
-
-        if (!isMuxBus(i2cPort))
-        {
-            continue; // we found regular i2c port
-        }
-
-        if (!getRootBus(i2cPort, rootBus))
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "Error getting root port for the bus",
-                phosphor::logging::entry("BUS:", i2cPort.c_str()));
-            continue;
-        }
-
-        // Add to list of muxes if rootport matches to the one defined in mctp
-        // configuration
-        if (rootPort == rootBus)
-        {
-            int muxfd = open(i2cPath.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
-            if (muxfd < 0)
-            {
-                continue;
-            }
-            muxes.emplace(muxfd, std::stoi(i2cPort));
-        }
+        prvt.mux_hold_timeout = 0;
+        prvt.mux_flags = 0;
     }
-    return muxes;
+    prvt.slave_addr = device.slave_addr;
+    uint8_t* prvtPtr = reinterpret_cast<uint8_t*>(&prvt);
+    bindingPrivateTable.set(
+        eid, {device.fd, device.slave_addr},
+        std::vector<uint8_t>(prvtPtr, prvtPtr + sizeof(prvt)));
 }
 
-std::optional<std::vector<uint8_t>>
-    SMBusBinding::getBindingPrivateData(uint8_t dstEid)
+void SMBusBinding::addDeviceTableEntry(const DeviceTableEntry_t& entry)
 {
-    mctp_smbus_pkt_private prvt = {};
+    smbusDeviceTable.push_back(entry);
+    // Earlier entries for an EID win, as they did when searching the table
+    if (!bindingPrivateTable.contains(entry.first))
+    {
+        indexDeviceTableEntry(entry);
+    }
+}
 
-    for (auto& device : smbusDeviceTable)
+void SMBusBinding::setDeviceTable(const std::vector<DeviceTableEntry_t>& table)
+{
+    smbusDeviceTable = table;
+    bindingPrivateTable.clear();
+    for (const auto& entry : smbusDeviceTable)
     {
-        if (std::get<0>(device) == dstEid)
+        if (!bindingPrivateTable.contains(entry.first))
         {
-            mctp_smbus_pkt_private temp = std::get<1>(device);
-            prvt.fd = temp.fd;
-            if (muxPortMap.count(prvt.fd) != 0)
-            {
-                prvt.mux_hold_timeout = 1000;
-                prvt.mux_flags = IS_MUX_PORT;
-            }
-            else
-            {
-                prvt.mux_hold_timeout = 0;
-                prvt.mux_flags = 0;
-            }
-            prvt.slave_addr = temp.slave_addr;
-            uint8_t* prvtPtr = reinterpret_cast<uint8_t*>(&prvt);
-            return std::vector<uint8_t>(prvtPtr, prvtPtr + sizeof(prvt));
+            indexDeviceTableEntry(entry);
         }
     }
-    return std::nullopt;
 }
 
 bool SMBusBinding::reserveBandwidth(const mctp_eid_t eid,
@@ -258,7 +182,7 @@ bool SMBusBinding::reserveBandwidth(const mctp_eid_t eid,
                 .c_str());
         return false;
     }
-    std::optional<std::vector<uint8_t>> pvtData = getBindingPrivateData(eid);
+    const std::vector<uint8_t>* pvtData = getBindingPrivateData(eid);
     if (!pvtData)
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
@@ -282,8 +206,9 @@ bool SMBusBinding::reserveBandwidth(const mctp_eid_t eid,
                 "reserveBandwidth: init pull model failed");
             return false;
         }
-        // TODO: Set only the required MUX.
-        setMuxIdleMode(MuxIdleModes::muxIdleModeConnect);
+        // Only the mux of the endpoint needs to stay connected
+        muxTopology.setIdleState(
+            prvt->fd, muxIdleModesMap.at(MuxIdleModes::muxIdleModeConnect));
         rsvBWActive = true;
         reservedEID = eid;
     }
@@ -332,7 +257,8 @@ void SMBusBinding::startTimerAndReleaseBW(const uint16_t interval,
             ret = 0;
             return;
         }
-        setMuxIdleMode(MuxIdleModes::muxIdleModeDisconnect);
+        muxTopology.setIdleState(
+            prvt.fd, muxIdleModesMap.at(MuxIdleModes::muxIdleModeDisconnect));
         if (mctp_smbus_exit_pull_model(&prvt) < 0)
         {
             phosphor::logging::log<phosphor::logging::level::ERR>(
@@ -352,7 +278,8 @@ SMBusBinding::SMBusBinding(std::shared_ptr<sdbusplus::asio::connection> conn,
     MctpBinding(conn, objServer, objPath, conf, ioc,
                 mctp_server::BindingTypes::MctpOverSmbus),
     smbusReceiverFd(ioc), reserveBWTimer(ioc), scanTimer(ioc),
-    addRootDevices(true)
+    probeWorker(ioc), scanLatencyTimer(ioc), i2cEvents(ioc),
+    topologyRefreshTimer(ioc), addRootDevices(true)
 {
     smbusInterface = objServer->add_interface(objPath, smbus_server::interface);
 
@@ -362,13 +289,15 @@ SMBusBinding::SMBusBinding(std::shared_ptr<sdbusplus::asio::connection> conn,
         bus = conf.bus;
         bmcSlaveAddr = conf.bmcSlaveAddr;
         supportedEndpointSlaveAddress = conf.supportedEndpointSlaveAddress;
+        concurrentMuxAddresses = conf.concurrentMuxAddresses;
         scanInterval = conf.scanInterval;
+        currentScanInterval = scanInterval;
 
         // TODO: If we are not top most busowner, wait for top mostbus owner
         // to issue EID Pool
         if (conf.mode == mctp_server::BindingModeTypes::BusOwner)
         {
-            eidPool.initializeEidPool(conf.eidPool);
+            eidPool.initializeEidPool(conf.eidPool, conf.eidAffinityFile);
         }
 
         if (bindingModeType == mctp_server::BindingModeTypes::BusOwner)
@@ -389,6 +318,10 @@ SMBusBinding::SMBusBinding(std::shared_ptr<sdbusplus::asio::connection> conn,
         registerProperty(smbusInterface, "BusPath", bus);
         registerProperty(smbusInterface, "BmcSlaveAddress", bmcSlaveAddr);
 
+        smbusInterface->register_method("GetScanRxLatency", [this]() {
+            return scanRxLatency.get();
+        });
+
         if (smbusInterface->initialize() == false)
         {
             throw std::system_error(
@@ -406,6 +339,7 @@ SMBusBinding::SMBusBinding(std::shared_ptr<sdbusplus::asio::connection> conn,
 
 void SMBusBinding::triggerDeviceDiscovery()
 {
+    fullScanRequested = true;
     scanTimer.cancel();
 }
 
@@ -416,8 +350,31 @@ void SMBusBinding::scanDevices()
     boost::asio::spawn(io, [this](boost::asio::yield_context yield) {
         if (!rsvBWActive)
         {
+            // Known devices are only registered again by a full scan, which
+            // still happens regularly to notice devices reset in between
+            bool fullScan =
+                fullScanRequested || incrementalScans >= maxIncrementalScans;
+            fullScanRequested = false;
+            incrementalScans = fullScan ? 0 : incrementalScans + 1;
+
             deviceWatcher.deviceDiscoveryInit();
-            initEndpointDiscovery(yield);
+            scanInProgress = true;
+            sampleScanLatency();
+            size_t changes = initEndpointDiscovery(yield, fullScan);
+            scanInProgress = false;
+            scanLatencyTimer.cancel();
+            if (topologyRefreshPending)
+            {
+                refreshMuxTopology();
+            }
+
+            // Devices tend to come and go in bursts, so look again soon
+            // after a change and back off while nothing changes
+            uint64_t minScanInterval =
+                std::max(scanInterval / scanIntervalDivisor, uint64_t{1});
+            currentScanInterval =
+                changes != 0 ? minScanInterval
+                             : std::min(currentScanInterval * 2, scanInterval);
         }
         else
         {
@@ -425,7 +382,7 @@ void SMBusBinding::scanDevices()
                 "Reserve bandwidth active. Unable to scan devices");
         }
 
-        scanTimer.expires_after(std::chrono::seconds(scanInterval));
+        scanTimer.expires_after(std::chrono::seconds(currentScanInterval));
         scanTimer.async_wait([this](const boost::system::error_code& ec) {
             if (ec && ec != boost::asio::error::operation_aborted)
             {
@@ -444,99 +401,125 @@ void SMBusBinding::scanDevices()
     });
 }
 
-void SMBusBinding::restoreMuxIdleMode()
+void SMBusBinding::sampleScanLatency()
 {
-    auto logMuxErr = [](const std::string& path) {
-        phosphor::logging::log<phosphor::logging::level::WARNING>(
-            "Unable to restore mux idle mode",
-            phosphor::logging::entry("MUX_PATH=%s", path.c_str()));
-    };
-
-    for (const auto& [path, idleMode] : muxIdleModeMap)
-    {
-        fs::path idlePath = fs::path(path);
-        if (!fs::exists(idlePath))
-        {
-            logMuxErr(path);
-            continue;
-        }
-
-        std::fstream idleFile(idlePath);
-        if (idleFile.good())
+    // A received message waits as long as this timer's handler is late
+    scanLatencyTimer.expires_after(scanLatencySamplePeriod);
+    scanLatencyTimer.async_wait([this](const boost::system::error_code& ec) {
+        if (ec || !scanInProgress)
         {
-            idleFile << idleMode;
-            if (idleFile.bad())
-            {
-                logMuxErr(path);
-            }
-        }
-        else
-        {
-            logMuxErr(path);
+            return;
         }
-    }
+        scanRxLatency.record(std::chrono::steady_clock::now() -
+                             scanLatencyTimer.expiry());
+        sampleScanLatency();
+    });
 }
 
-void SMBusBinding::setMuxIdleMode(const MuxIdleModes mode)
+void SMBusBinding::watchMuxTopology()
 {
-    auto itr = muxIdleModesMap.find(mode);
-    if (itr == muxIdleModesMap.end())
+    udevContext = udev_new();
+    if (udevContext)
     {
-        phosphor::logging::log<phosphor::logging::level::ERR>(
-            "Inavlid mux idle mode");
-        return;
+        i2cMonitor = udev_monitor_new_from_netlink(udevContext, "udev");
     }
-    std::string rootPort;
-    if (!getBusNumFromPath(bus, rootPort))
+    if (!i2cMonitor ||
+        udev_monitor_filter_add_match_subsystem_devtype(i2cMonitor, "i2c",
+                                                        nullptr) < 0 ||
+        udev_monitor_enable_receiving(i2cMonitor) < 0)
     {
-        throwRunTimeError("Error in finding root port");
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "Unable to watch I2C buses, mux topology changes will be missed");
+        return;
     }
+    i2cEvents.assign(udev_monitor_get_fd(i2cMonitor));
+    waitForTopologyEvent();
+}
 
-    fs::path rootPath = fs::path("/sys/bus/i2c/devices/i2c-" + rootPort + "/");
-    std::string matchString = rootPort + std::string(R"(-\d+$)");
-    std::vector<std::string> i2cMuxes{};
-    static bool muxIdleModeFlag = false;
+void SMBusBinding::waitForTopologyEvent()
+{
+    i2cEvents.async_wait(
+        boost::asio::posix::stream_descriptor::wait_read,
+        [this](const boost::system::error_code& ec) {
+            if (ec == boost::asio::error::operation_aborted)
+            {
+                return;
+            }
+            if (udev_device* dev = udev_monitor_receive_device(i2cMonitor))
+            {
+                udev_device_unref(dev);
+            }
+            // A mux brings its channels in a burst of events, read the
+            // topology once they are done
+            topologyRefreshTimer.expires_after(topologyRefreshDelay);
+            topologyRefreshTimer.async_wait(
+                [this](const boost::system::error_code& timerEc) {
+                    if (!timerEc)
+                    {
+                        refreshMuxTopology();
+                    }
+                });
+            waitForTopologyEvent();
+        });
+}
 
-    // Search for mux ports
-    if (!findFiles(rootPath, matchString, i2cMuxes))
+void SMBusBinding::refreshMuxTopology()
+{
+    // The probe worker reads the mux channels while a scan is in progress
+    if (scanInProgress)
     {
-        phosphor::logging::log<phosphor::logging::level::DEBUG>(
-            "No mux interfaces found");
+        topologyRefreshPending = true;
         return;
     }
+    topologyRefreshPending = false;
 
-    for (const auto& muxPath : i2cMuxes)
+    auto removed = muxTopology.refresh(
+        rootBus, muxIdleModesMap.at(MuxIdleModes::muxIdleModeDisconnect));
+    auto channels = muxTopology.getChannelBuses();
+    if (removed.empty() && channels == muxPortMap)
     {
-        std::string path = muxPath + "/idle_state";
-        fs::path idlePath = fs::path(path);
-        if (!fs::exists(idlePath))
-        {
-            continue;
-        }
+        return;
+    }
 
-        std::fstream idleFile(idlePath);
-        if (idleFile.good())
+    // Endpoints behind channels which are gone went with them. The fds stay
+    // open till the next refresh, anything still holding one is stopped now.
+    for (int fd : removed)
+    {
+        std::vector<mctp_eid_t> eids;
+        for (const auto& [eid, bindingPvt] : smbusDeviceTable)
         {
-            if (!muxIdleModeFlag)
+            if (bindingPvt.fd == fd)
             {
-                std::string currentMuxIdleMode;
-                idleFile >> currentMuxIdleMode;
-                muxIdleModeMap.insert_or_assign(path, currentMuxIdleMode);
-
-                phosphor::logging::log<phosphor::logging::level::DEBUG>(
-                    (path + " " + currentMuxIdleMode).c_str());
+                eids.emplace_back(eid);
             }
-
-            idleFile << itr->second;
         }
-        else
+        for (mctp_eid_t eid : eids)
         {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "Unable to set idle mode for mux",
-                phosphor::logging::entry("MUX_PATH=%s", idlePath.c_str()));
+            if (rsvBWActive && eid == reservedEID)
+            {
+                releaseBandwidth(eid);
+            }
+            unregisterEndpoint(eid);
+            removeDeviceTableEntry(eid);
         }
+        cancelCtrlTx([fd](const CtrlTxRequest& ctrlTx) {
+            auto prvt = reinterpret_cast<const mctp_smbus_pkt_private*>(
+                ctrlTx.bindingPrivate.data());
+            return ctrlTx.bindingPrivate.size() >=
+                       sizeof(mctp_smbus_pkt_private) &&
+                   prvt->fd == fd;
+        });
+        std::erase_if(knownDevices, [fd](const auto& device) {
+            return device.first.first == fd;
+        });
     }
-    muxIdleModeFlag = true;
+    muxPortMap = std::move(channels);
+
+    phosphor::logging::log<phosphor::logging::level::INFO>(
+        ("Mux topology changed, " + std::to_string(muxPortMap.size()) +
+         " mux channels")
+            .c_str());
+    triggerDeviceDiscovery();
 }
 
 void SMBusBinding::initializeBinding()
@@ -547,10 +530,16 @@ void SMBusBinding::initializeBinding()
         auto rootPort = SMBusInit();
         phosphor::logging::log<phosphor::logging::level::INFO>(
             "Scanning root port");
-        setMuxIdleMode(MuxIdleModes::muxIdleModeDisconnect);
+        // Disconnect the muxes, so the root port scan finds only devices on
+        // the root bus
+        rootBus = std::stoi(rootPort);
+        muxTopology.refresh(
+            rootBus, muxIdleModesMap.at(MuxIdleModes::muxIdleModeDisconnect));
+        muxPortMap = muxTopology.getChannelBuses();
         // Scan root port
         scanPort(outFd, rootDeviceMap);
-        muxPortMap = getMuxFds(rootPort);
+        watchMuxTopology();
+        restoreEndpointSnapshot();
     }
 
     catch (const std::exception& e)
@@ -566,7 +555,16 @@ void SMBusBinding::initializeBinding()
 
 SMBusBinding::~SMBusBinding()
 {
-    restoreMuxIdleMode();
+    muxTopology.restoreIdleStates();
+    if (i2cMonitor)
+    {
+        i2cEvents.release();
+        udev_monitor_unref(i2cMonitor);
+    }
+    if (udevContext)
+    {
+        udev_unref(udevContext);
+    }
 
     if (smbusReceiverFd.native_handle() >= 0)
     {
@@ -693,7 +691,8 @@ void SMBusBinding::scanMuxBus(std::set<std::pair<int, uint8_t>>& deviceMap)
     }
 }
 
-void SMBusBinding::initEndpointDiscovery(boost::asio::yield_context& yield)
+size_t SMBusBinding::initEndpointDiscovery(boost::asio::yield_context& yield,
+                                           bool fullScan)
 {
     std::set<std::pair<int, uint8_t>> registerDeviceMap;
 
@@ -707,95 +706,145 @@ void SMBusBinding::initEndpointDiscovery(boost::asio::yield_context& yield)
 
     // Scan mux bus to get the list of fd and the corresponding slave address of
     // all the mux ports
-    scanMuxBus(registerDeviceMap);
+    std::set<std::pair<int, uint8_t>> muxDevices;
+    probeWorker.run(yield, [this, &muxDevices]() { scanMuxBus(muxDevices); });
+
+    // A device answering at the same address as last time keeps its EID, so
+    // only new devices are registered unless this is a full scan. Devices
+    // gone since are registered again, which fails and removes them.
+    for (const auto& device : muxDevices)
+    {
+        if (fullScan || knownDevices.count(device) == 0)
+        {
+            registerDeviceMap.insert(device);
+        }
+    }
+    size_t changes = 0;
+    for (auto it = knownDevices.begin(); it != knownDevices.end();)
+    {
+        if (muxDevices.count(it->first) != 0)
+        {
+            ++it;
+            continue;
+        }
+        if (it->second != MCTP_EID_NULL)
+        {
+            registerDeviceMap.insert(it->first);
+        }
+        changes++;
+        it = knownDevices.erase(it);
+    }
 
     if (registerDeviceMap.empty())
     {
         phosphor::logging::log<phosphor::logging::level::DEBUG>(
-            "No device found");
-        return;
+            "No new device found");
+        return changes;
     }
 
-    /* Since i2c muxes restrict that only one command needs to be
-     * in flight, we cannot register multiple endpoints in parallel.
-     * Thus, in a single yield_context, all the discovered devices
-     * are attempted with registration sequentially */
+    // Devices on the root bus can be talked to while a mux channel is in
+    // use, but a selected mux channel is visible to every other mux on the
+    // root bus. Channels are therefore discovered one at a time unless their
+    // mux is configured as safe to use concurrently.
+    std::map<std::string, std::vector<std::pair<int, uint8_t>>> lanes;
     for (const auto& device : registerDeviceMap)
     {
-        phosphor::logging::log<phosphor::logging::level::DEBUG>(
-            ("Device discovery: Checking device " +
-             std::to_string(std::get<1>(device)))
-                .c_str());
+        std::string lane = "root";
+        if (auto muxPort = muxPortMap.find(std::get<0>(device));
+            muxPort != muxPortMap.end())
+        {
+            lane = "mux";
+            const auto* mux = muxTopology.getMux(muxPort->first);
+            if (mux && concurrentMuxAddresses.count(mux->address) != 0)
+            {
+                lane = muxTopology.getMuxName(muxPort->first).value();
+            }
+        }
+        lanes[lane].emplace_back(device);
+    }
 
-        struct mctp_smbus_pkt_private smbusBindingPvt;
-        smbusBindingPvt.fd = std::get<0>(device);
+    std::map<std::pair<int, uint8_t>, mctp_eid_t> discovered;
+    std::vector<std::function<void(boost::asio::yield_context)>> steps;
+    for (const auto& [lane, devices] : lanes)
+    {
+        steps.emplace_back([this, &devices = devices,
+                            &discovered](boost::asio::yield_context laneYield) {
+            for (const auto& device : devices)
+            {
+                discovered[device] = discoverDevice(laneYield, device);
+            }
+        });
+    }
 
-        if (muxPortMap.count(smbusBindingPvt.fd) != 0)
+    auto start = std::chrono::steady_clock::now();
+    runConcurrently(yield, steps);
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    phosphor::logging::log<phosphor::logging::level::INFO>(
+        ("Device discovery of " + std::to_string(registerDeviceMap.size()) +
+         " devices in " + std::to_string(lanes.size()) + " lanes took " +
+         std::to_string(duration.count()) + " ms")
+            .c_str());
+    addRootDevices = false;
+
+    for (const auto& [device, eid] : discovered)
+    {
+        if (muxDevices.count(device) == 0)
         {
-            smbusBindingPvt.mux_hold_timeout = ctrlTxRetryDelay;
-            smbusBindingPvt.mux_flags = 0x80;
+            continue;
         }
-        else
+        auto known = knownDevices.find(device);
+        if (known == knownDevices.end() || known->second != eid)
         {
-            smbusBindingPvt.mux_hold_timeout = 0;
-            smbusBindingPvt.mux_flags = 0;
+            changes++;
         }
-        /* Set 8 bit i2c slave address */
-        smbusBindingPvt.slave_addr =
-            static_cast<uint8_t>((std::get<1>(device) << 1));
+        knownDevices[device] = eid;
+    }
+    return changes;
+}
 
-        auto const ptr = reinterpret_cast<uint8_t*>(&smbusBindingPvt);
-        std::vector<uint8_t> bindingPvtVect(ptr, ptr + sizeof(smbusBindingPvt));
-        if (!deviceWatcher.isDeviceGoodForInit(bindingPvtVect))
-        {
-            phosphor::logging::log<phosphor::logging::level::DEBUG>(
-                "Device found in ignore list. Skipping discovery");
-            continue;
-        }
+mctp_eid_t SMBusBinding::discoverDevice(boost::asio::yield_context& yield,
+                                        const std::pair<int, uint8_t>& device)
+{
+    phosphor::logging::log<phosphor::logging::level::DEBUG>(
+        ("Device discovery: Checking device " +
+         std::to_string(std::get<1>(device)))
+            .c_str());
 
-        mctp_eid_t registeredEid = getEIDFromDeviceTable(bindingPvtVect);
-        std::optional<mctp_eid_t> eid =
-            registerEndpoint(yield, bindingPvtVect, registeredEid);
+    struct mctp_smbus_pkt_private smbusBindingPvt;
+    smbusBindingPvt.fd = std::get<0>(device);
 
-        if (eid.has_value())
-        {
-            bool isEidPresent = false;
-            for (auto const& [eidEntry, bindingPvt] : smbusDeviceTable)
-            {
-                if (eidEntry == eid.value())
-                {
-                    isEidPresent = true;
-                }
-            }
-            if (eid.value() != registeredEid)
-            {
-                // Remove the entry from DeviceTable
-                if (smbusDeviceTable.size())
-                {
-                    removeDeviceTableEntry(registeredEid);
-                }
-            }
+    if (muxPortMap.count(smbusBindingPvt.fd) != 0)
+    {
+        smbusBindingPvt.mux_hold_timeout = ctrlTxRetryDelay;
+        smbusBindingPvt.mux_flags = 0x80;
+    }
+    else
+    {
+        smbusBindingPvt.mux_hold_timeout = 0;
+        smbusBindingPvt.mux_flags = 0;
+    }
+    /* Set 8 bit i2c slave address */
+    smbusBindingPvt.slave_addr =
+        static_cast<uint8_t>((std::get<1>(device) << 1));
 
-            if (!isEidPresent && eid.value() != MCTP_EID_NULL)
-            {
-                smbusDeviceTable.push_back(
-                    std::make_pair(eid.value(), smbusBindingPvt));
-                std::string busName(bus);
+    auto const ptr = reinterpret_cast<uint8_t*>(&smbusBindingPvt);
+    std::vector<uint8_t> bindingPvtVect(ptr, ptr + sizeof(smbusBindingPvt));
+    if (!deviceWatcher.isDeviceGoodForInit(bindingPvtVect))
+    {
+        phosphor::logging::log<phosphor::logging::level::DEBUG>(
+            "Device found in ignore list. Skipping discovery");
+        return MCTP_EID_NULL;
+    }
 
-                if (muxPortMap.count(smbusBindingPvt.fd) != 0)
-                {
-                    auto itr = muxPortMap.find(smbusBindingPvt.fd);
-                    busName.assign(std::to_string(itr->second));
-                }
+    mctp_eid_t registeredEid = getEIDFromDeviceTable(bindingPvtVect);
+    std::optional<mctp_eid_t> eid =
+        registerEndpoint(yield, bindingPvtVect, registeredEid);
 
-                phosphor::logging::log<phosphor::logging::level::INFO>(
-                    ("SMBus device at bus:" + busName + ",8 bit address: " +
-                     std::to_string(smbusBindingPvt.slave_addr) +
-                     " registered at EID " + std::to_string(*eid))
-                        .c_str());
-            }
-        }
-        else
+    if (eid.has_value())
+    {
+        bool isEidPresent = bindingPrivateTable.contains(eid.value());
+        if (eid.value() != registeredEid)
         {
             // Remove the entry from DeviceTable
             if (smbusDeviceTable.size())
@@ -803,8 +852,34 @@ void SMBusBinding::initEndpointDiscovery(boost::asio::yield_context& yield)
                 removeDeviceTableEntry(registeredEid);
             }
         }
+
+        if (!isEidPresent && eid.value() != MCTP_EID_NULL)
+        {
+            addDeviceTableEntry(std::make_pair(eid.value(), smbusBindingPvt));
+            std::string busName(bus);
+
+            if (muxPortMap.count(smbusBindingPvt.fd) != 0)
+            {
+                auto itr = muxPortMap.find(smbusBindingPvt.fd);
+                busName.assign(std::to_string(itr->second));
+            }
+
+            phosphor::logging::log<phosphor::logging::level::INFO>(
+                ("SMBus device at bus:" + busName + ",8 bit address: " +
+                 std::to_string(smbusBindingPvt.slave_addr) +
+                 " registered at EID " + std::to_string(*eid))
+                    .c_str());
+        }
     }
-    addRootDevices = false;
+    else
+    {
+        // Remove the entry from DeviceTable
+        if (smbusDeviceTable.size())
+        {
+            removeDeviceTableEntry(registeredEid);
+        }
+    }
+    return eid.value_or(MCTP_EID_NULL);
 }
 
 // TODO: This method is a placeholder and has not been tested
@@ -949,26 +1024,16 @@ void SMBusBinding::removeDeviceTableEntry(const mctp_eid_t eid)
                                               return (tableEntry.first == eid);
                                           }),
                            smbusDeviceTable.end());
+    bindingPrivateTable.erase(eid);
 }
 
 mctp_eid_t SMBusBinding::getEIDFromDeviceTable(
     const std::vector<uint8_t>& bindingPrivate)
 {
-    mctp_eid_t eid = MCTP_EID_NULL;
-    for (auto& deviceEntry : smbusDeviceTable)
-    {
-        const mctp_smbus_pkt_private* ptr =
-            reinterpret_cast<const mctp_smbus_pkt_private*>(
-                bindingPrivate.data());
-        mctp_smbus_pkt_private bindingDataEntry = std::get<1>(deviceEntry);
-        if (bindingDataEntry.slave_addr == ptr->slave_addr &&
-            bindingDataEntry.fd == ptr->fd)
-        {
-            eid = std::get<0>(deviceEntry);
-            break;
-        }
-    }
-    return eid;
+    const mctp_smbus_pkt_private* ptr =
+        reinterpret_cast<const mctp_smbus_pkt_private*>(bindingPrivate.data());
+    return bindingPrivateTable.getEid({ptr->fd, ptr->slave_addr})
+        .value_or(MCTP_EID_NULL);
 }
 
 std::string SMBusBinding::convertToString(DiscoveryFlags flag)
@@ -1008,11 +1073,7 @@ void SMBusBinding::addUnknownEIDToDeviceTable(const mctp_eid_t eid,
         return;
     }
 
-    auto deviceIter = std::find_if(
-        smbusDeviceTable.begin(), smbusDeviceTable.end(),
-        [eid](auto const eidEntry) { return std::get<0>(eidEntry) == eid; });
-
-    if (deviceIter != smbusDeviceTable.end())
+    if (bindingPrivateTable.contains(eid))
     {
         return;
     }
@@ -1026,7 +1087,7 @@ void SMBusBinding::addUnknownEIDToDeviceTable(const mctp_eid_t eid,
     smbusBindingPvt.slave_addr =
         static_cast<uint8_t>((bindingPtr->slave_addr) & (~1));
 
-    smbusDeviceTable.emplace_back(std::make_pair(eid, smbusBindingPvt));
+    addDeviceTableEntry(std::make_pair(eid, smbusBindingPvt));
 
     phosphor::logging::log<phosphor::logging::level::INFO>(
         ("New EID added to device table. EID = " + std::to_string(eid))
@@ -1153,7 +1214,7 @@ void SMBusBinding::updateRoutingTable()
         if (isDeviceTableChanged(smbusDeviceTable, smbusDeviceTableTmp))
         {
             processRoutingTableChanges(smbusDeviceTableTmp, yield, prvData);
-            smbusDeviceTable = smbusDeviceTableTmp;
+            setDeviceTable(smbusDeviceTableTmp);
         }
         entryHdlCounter++;
     });
@@ -1196,3 +1257,75 @@ void SMBusBinding::processRoutingTableChanges(
         }
     }
 }
+
+std::optional<std::string> SMBusBinding::getEndpointAddress(mctp_eid_t eid)
+{
+    // Bus numbers stay the same across restarts, the file descriptors don't
+    const auto& address = bindingPrivateTable.getAddress(eid);
+    if (!address)
+    {
+        return std::nullopt;
+    }
+    const auto& [fd, slaveAddr] = *address;
+    int busNumber = rootBus;
+    if (fd != outFd)
+    {
+        auto muxPort = muxPortMap.find(fd);
+        if (muxPort == muxPortMap.end())
+        {
+            return std::nullopt;
+        }
+        busNumber = muxPort->second;
+    }
+    std::stringstream stream;
+    stream << busNumber << ":0x" << std::hex
+           << static_cast<unsigned>(slaveAddr >> 1);
+    return stream.str();
+}
+
+bool SMBusBinding::restoreEndpointAddress(mctp_eid_t eid,
+                                          const std::string& address)
+{
+    int busNumber = -1;
+    unsigned slaveAddr = 0;
+    char separator = 0;
+    std::istringstream stream(address);
+    if (!(stream >> std::dec >> busNumber >> separator >> std::hex >>
+          slaveAddr) ||
+        separator != ':' || slaveAddr > 0x7f)
+    {
+        return false;
+    }
+
+    struct mctp_smbus_pkt_private smbusBindingPvt = {};
+    if (busNumber == rootBus)
+    {
+        smbusBindingPvt.fd = outFd;
+    }
+    else
+    {
+        auto muxPort = std::find_if(
+            muxPortMap.begin(), muxPortMap.end(),
+            [busNumber](const auto& port) { return port.second == busNumber; });
+        if (muxPort == muxPortMap.end())
+        {
+            // The mux channel is gone, discovery will find the device anew
+            return false;
+        }
+        smbusBindingPvt.fd = muxPort->first;
+        smbusBindingPvt.mux_hold_timeout = ctrlTxRetryDelay;
+        smbusBindingPvt.mux_flags = 0x80;
+        knownDevices[{smbusBindingPvt.fd, static_cast<uint8_t>(slaveAddr)}] =
+            eid;
+    }
+    smbusBindingPvt.slave_addr = static_cast<uint8_t>(slaveAddr << 1);
+    addDeviceTableEntry(std::make_pair(eid, smbusBindingPvt));
+    return true;
+}
+
+void SMBusBinding::forgetEndpointAddress(mctp_eid_t eid)
+{
+    std::erase_if(knownDevices,
+                  [eid](const auto& device) { return device.second == eid; });
+    removeDeviceTableEntry(eid);
+}
@@ -136,6 +136,10 @@ static std::optional<SMBusConfiguration> getSMBusConfiguration(const T& map)
     uint64_t scanInterval = 0;
     std::vector<uint64_t> supportedEndpointSlaveAddress;
     std::vector<uint64_t> ignoredEndpintSlaveAddress;
+    std::vector<uint64_t> concurrentMuxAddresses;
+    std::string eidAffinityFile;
+    std::string snapshotFile;
+    std::vector<uint64_t> directedOnlyMsgTypes;
 
     if (!getField(map, "PhysicalMediumID", physicalMediumID))
     {
@@ -210,6 +214,30 @@ static std::optional<SMBusConfiguration> getSMBusConfiguration(const T& map)
         ignoredEndpintSlaveAddress = {};
     }
 
+    if (!getField(map, "ConcurrentMuxAddresses", concurrentMuxAddresses))
+    {
+        concurrentMuxAddresses = {};
+    }
+
+    if (!getField(map, "EIDAffinityFile", eidAffinityFile))
+    {
+        eidAffinityFile = "/var/lib/mctp/" +
+                          std::filesystem::path(bus).filename().string() +
+                          "-eid-affinity";
+    }
+
+    if (!getField(map, "EndpointSnapshotFile", snapshotFile))
+    {
+        snapshotFile = "/var/lib/mctp/" +
+                       std::filesystem::path(bus).filename().string() +
+                       "-endpoints";
+    }
+
+    if (!getField(map, "DirectedOnlyMessageTypes", directedOnlyMsgTypes))
+    {
+        directedOnlyMsgTypes = {};
+    }
+
     auto endpointSlaveAddress =
         std::set<uint8_t>(supportedEndpointSlaveAddress.begin(),
                           supportedEndpointSlaveAddress.end());
@@ -227,14 +255,24 @@ static std::optional<SMBusConfiguration> getSMBusConfiguration(const T& map)
     if (mode == mctp_server::BindingModeTypes::BusOwner)
     {
         config.eidPool = std::set<uint8_t>(eidPool.begin(), eidPool.end());
+        config.eidAffinityFile = eidAffinityFile;
     }
     config.supportedEndpointSlaveAddress = endpointSlaveAddress;
+    for (uint64_t it : concurrentMuxAddresses)
+    {
+        config.concurrentMuxAddresses.insert(static_cast<uint8_t>(it));
+    }
     config.bus = bus;
     config.arpMasterSupport = arpOwnerSupport;
     config.bmcSlaveAddr = static_cast<uint8_t>(bmcReceiverAddress);
     config.reqToRespTime = static_cast<unsigned int>(reqToRespTimeMs);
     config.reqRetryCount = static_cast<uint8_t>(reqRetryCount);
     config.scanInterval = scanInterval;
+    config.snapshotFile = snapshotFile;
+    for (uint64_t it : directedOnlyMsgTypes)
+    {
+        config.directedOnlyMsgTypes.insert(static_cast<uint8_t>(it));
+    }
 
     return config;
 }
@@ -249,6 +287,8 @@ static std::optional<PcieConfiguration> getPcieConfiguration(const T& map)
     uint64_t reqToRespTimeMs;
     uint64_t reqRetryCount;
     uint64_t getRoutingInterval;
+    std::string snapshotFile;
+    std::vector<uint64_t> directedOnlyMsgTypes;
 
     if (!getField(map, "PhysicalMediumID", physicalMediumID))
     {
@@ -286,6 +326,16 @@ static std::optional<PcieConfiguration> getPcieConfiguration(const T& map)
         return std::nullopt;
     }
 
+    if (!getField(map, "EndpointSnapshotFile", snapshotFile))
+    {
+        snapshotFile = "/var/lib/mctp/pcie-endpoints";
+    }
+
+    if (!getField(map, "DirectedOnlyMessageTypes", directedOnlyMsgTypes))
+    {
+        directedOnlyMsgTypes = {};
+    }
+
     PcieConfiguration config;
     config.mediumId = stringToMediumID.at(physicalMediumID);
     config.mode = stringToBindingModeMap.at(role);
@@ -297,6 +347,11 @@ static std::optional<PcieConfiguration> getPcieConfiguration(const T& map)
     {
         config.getRoutingInterval = static_cast<uint8_t>(getRoutingInterval);
     }
+    config.snapshotFile = snapshotFile;
+    for (uint64_t it : directedOnlyMsgTypes)
+    {
+        config.directedOnlyMsgTypes.insert(static_cast<uint8_t>(it));
+    }
 
     return config;
 }
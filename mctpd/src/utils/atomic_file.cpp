@@ -0,0 +1,55 @@
+/*
+// Copyright (c) 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "utils/atomic_file.hpp"
+
+#include <fstream>
+#include <phosphor-logging/log.hpp>
+#include <system_error>
+
+namespace mctpd
+{
+
+bool writeFileAtomically(const std::filesystem::path& file,
+                         const std::function<void(std::ostream&)>& writer)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(file.parent_path(), ec);
+
+    std::filesystem::path tmpFile = file;
+    tmpFile += ".tmp";
+    {
+        std::ofstream stream(tmpFile, std::ios::trunc);
+        writer(stream);
+        if (!stream.flush())
+        {
+            phosphor::logging::log<phosphor::logging::level::ERR>(
+                ("Unable to write " + tmpFile.string()).c_str());
+            return false;
+        }
+    }
+    std::filesystem::rename(tmpFile, file, ec);
+    if (ec)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            ("Unable to replace " + file.string() + ": " + ec.message())
+                .c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace mctpd
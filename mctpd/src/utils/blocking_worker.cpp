@@ -0,0 +1,97 @@
+/*
+// Copyright (c) 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+#include "utils/blocking_worker.hpp"
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <exception>
+
+namespace mctpd
+{
+
+BlockingWorker::BlockingWorker(boost::asio::io_context& iocIn) :
+    ioc(iocIn), thread([this]() { loop(); })
+{
+}
+
+BlockingWorker::~BlockingWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeup.notify_one();
+    thread.join();
+}
+
+void BlockingWorker::run(boost::asio::yield_context yield,
+                         const std::function<void()>& job)
+{
+    bool done = false;
+    std::exception_ptr error;
+    // Never expires, cancelled from the io_context once the job is done
+    boost::asio::steady_timer finished(
+        ioc, boost::asio::steady_timer::time_point::max());
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.emplace_back([this, &job, &done, &error, &finished]() {
+            try
+            {
+                job();
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+            boost::asio::post(ioc, [&done, &finished]() {
+                done = true;
+                finished.cancel();
+            });
+        });
+    }
+    wakeup.notify_one();
+
+    while (!done)
+    {
+        boost::system::error_code ec;
+        finished.async_wait(yield[ec]);
+    }
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+void BlockingWorker::loop()
+{
+    while (true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeup.wait(lock, [this]() { return stopping || !jobs.empty(); });
+            if (stopping)
+            {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        job();
+    }
+}
+} // namespace mctpd
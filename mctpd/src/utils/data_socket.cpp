@@ -0,0 +1,207 @@
+/*
+// Copyright (c) 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "utils/data_socket.hpp"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <cerrno>
+#include <cstring>
+#include <phosphor-logging/log.hpp>
+#include <system_error>
+
+namespace mctpd
+{
+
+DataSocketServer::DataSocketServer(boost::asio::io_context& ioc,
+                                   const std::string& name,
+                                   SendHandler&& sendHandler,
+                                   SendReceiveHandler&& sendReceiveHandler) :
+    io(ioc),
+    socketName(name), acceptor(ioc), send(std::move(sendHandler)),
+    sendReceive(std::move(sendReceiveHandler))
+{
+    // Generic endpoint takes the address family from the local endpoint and
+    // the socket type from the protocol, giving AF_UNIX + SOCK_SEQPACKET
+    Protocol::endpoint endpoint{boost::asio::local::stream_protocol::endpoint(
+        std::string(1, '\0') + socketName)};
+    acceptor.open(endpoint.protocol());
+    acceptor.bind(endpoint);
+    acceptor.listen();
+
+    boost::asio::spawn(io, [this](boost::asio::yield_context yield) {
+        acceptClients(yield);
+    });
+}
+
+DataSocketServer::~DataSocketServer()
+{
+    boost::system::error_code ec;
+    acceptor.close(ec);
+}
+
+void DataSocketServer::acceptClients(boost::asio::yield_context yield)
+{
+    while (true)
+    {
+        auto client = std::make_shared<Connection>(io);
+        boost::system::error_code ec;
+        acceptor.async_accept(client->socket, yield[ec]);
+        if (ec == boost::asio::error::operation_aborted)
+        {
+            return;
+        }
+        if (ec)
+        {
+            phosphor::logging::log<phosphor::logging::level::ERR>(
+                "Data socket accept failed",
+                phosphor::logging::entry("ERROR=%s", ec.message().c_str()));
+            continue;
+        }
+        if (!isPeerAllowed(client->socket))
+        {
+            client->socket.close(ec);
+            continue;
+        }
+
+        boost::asio::spawn(
+            io, [this, client](boost::asio::yield_context yieldClient) {
+                serveClient(client, yieldClient);
+            });
+    }
+}
+
+bool DataSocketServer::isPeerAllowed(Protocol::socket& client)
+{
+    struct ucred cred = {};
+    socklen_t credLen = sizeof(cred);
+    if (getsockopt(client.native_handle(), SOL_SOCKET, SO_PEERCRED, &cred,
+                   &credLen) < 0)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Data socket: Failed to get peer credentials",
+            phosphor::logging::entry("ERROR=%s", strerror(errno)));
+        return false;
+    }
+    if (cred.uid != 0 && cred.uid != geteuid())
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "Data socket: Rejected client",
+            phosphor::logging::entry("PID=%d", cred.pid),
+            phosphor::logging::entry("UID=%u", cred.uid));
+        return false;
+    }
+    return true;
+}
+
+void DataSocketServer::serveClient(std::shared_ptr<Connection> client,
+                                   boost::asio::yield_context yield)
+{
+    std::vector<uint8_t> packet(maxPacketSize);
+    while (true)
+    {
+        boost::system::error_code ec;
+        while (client->inFlight >= maxRequestsInFlight)
+        {
+            client->slotFreed.expires_at(
+                boost::asio::steady_timer::time_point::max());
+            client->slotFreed.async_wait(yield[ec]);
+        }
+
+        boost::asio::socket_base::message_flags flags = 0;
+        size_t len = client->socket.async_receive(boost::asio::buffer(packet),
+                                                  flags, yield[ec]);
+        // A zero length read means the client has closed its end
+        if (ec || len == 0)
+        {
+            return;
+        }
+        if (flags & MSG_TRUNC || len < sizeof(DataSocketHeader))
+        {
+            phosphor::logging::log<phosphor::logging::level::WARNING>(
+                "Data socket: Invalid packet length",
+                phosphor::logging::entry("LEN=%zu", len));
+            continue;
+        }
+
+        DataSocketHeader header;
+        std::memcpy(&header, packet.data(), sizeof(header));
+        std::vector<uint8_t> payload(packet.begin() + sizeof(header),
+                                     packet.begin() +
+                                         static_cast<ptrdiff_t>(len));
+        ++client->inFlight;
+        boost::asio::spawn(
+            io, [this, client, header, payload = std::move(payload)](
+                    boost::asio::yield_context yieldReq) mutable {
+                handleRequest(client, header, std::move(payload), yieldReq);
+            });
+    }
+}
+
+void DataSocketServer::handleRequest(std::shared_ptr<Connection> client,
+                                     DataSocketHeader header,
+                                     std::vector<uint8_t> payload,
+                                     boost::asio::yield_context yield)
+{
+    // Replies are sent straight from the receive buffer
+    MessageBuffer response;
+    switch (static_cast<DataSocketOp>(header.op))
+    {
+        case DataSocketOp::send:
+            header.status = static_cast<int16_t>(
+                send(header.eid, header.msgTag, header.tagOwner != 0,
+                     std::move(payload)));
+            break;
+        case DataSocketOp::sendReceive:
+            try
+            {
+                response = sendReceive(yield, header.eid, std::move(payload),
+                                       header.timeout);
+                header.status = 0;
+            }
+            catch (const std::system_error& e)
+            {
+                header.status = static_cast<int16_t>(-e.code().value());
+            }
+            catch (const std::exception&)
+            {
+                header.status = -EIO;
+            }
+            break;
+        default:
+            header.status = -EOPNOTSUPP;
+            break;
+    }
+
+    std::array<boost::asio::const_buffer, 2> reply = {
+        boost::asio::buffer(&header, sizeof(header)),
+        response ? boost::asio::buffer(*response)
+                 : boost::asio::const_buffer()};
+    boost::system::error_code ec;
+    client->socket.async_send(reply, 0, yield[ec]);
+    --client->inFlight;
+    client->slotFreed.cancel();
+    if (ec && ec != boost::asio::error::operation_aborted)
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "Data socket: Failed to send reply",
+            phosphor::logging::entry("ERROR=%s", ec.message().c_str()));
+    }
+}
+} // namespace mctpd
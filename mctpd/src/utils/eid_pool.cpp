@@ -16,79 +16,191 @@
 
 #include "utils/eid_pool.hpp"
 
+#include "utils/atomic_file.hpp"
+
+#include <fstream>
 #include <phosphor-logging/log.hpp>
 #include <system_error>
 
 namespace mctpd
 {
 
-void EidPool::initializeEidPool(const std::set<mctp_eid_t>& pool)
+namespace
+{
+// Devices without Get UUID support all report the null UUID
+bool isNullUuid(const std::string& uuid)
+{
+    return uuid.find_first_not_of("0-") == std::string::npos;
+}
+} // namespace
+
+void EidPool::initializeEidPool(const std::set<mctp_eid_t>& pool,
+                                const std::filesystem::path& affinityFileIn)
 {
     for (auto const& epId : pool)
     {
-        eidPool.push_back(std::make_pair(epId, false));
+        setBit(poolEids, epId, true);
+        setBit(freeEids, epId, true);
     }
+    affinityFile = affinityFileIn;
+    loadAffinity();
 }
 
 void EidPool::updateEidStatus(const mctp_eid_t endpointId, const bool assigned)
 {
-    bool eidPresent = false;
-    size_t prevSize = eidPool.size();
-    // To implement EID pool in FIFO: The eid entry in the pool is removed and
-    // inserted at the end, so that the older EID from the pool is picked for
-    // registering the endpoint.
-
-    eidPool.erase(std::remove_if(eidPool.begin(), eidPool.end(),
-                                 [endpointId](auto const& eidPair) {
-                                     return (eidPair.first == endpointId);
-                                 }),
-                  eidPool.end());
-    eidPresent = (prevSize > eidPool.size());
-
-    if (eidPresent)
-    {
-        eidPool.push_back(std::make_pair(endpointId, assigned));
-
-        if (assigned)
-        {
-            phosphor::logging::log<phosphor::logging::level::DEBUG>(
-                ("EID " + std::to_string(endpointId) + " is assigned").c_str());
-        }
-        else
-        {
-            phosphor::logging::log<phosphor::logging::level::DEBUG>(
-                ("EID " + std::to_string(endpointId) + " added to pool")
-                    .c_str());
-        }
-    }
-    else
+    if (!testBit(poolEids, endpointId))
     {
         phosphor::logging::log<phosphor::logging::level::INFO>(
             ("Unable to find EID " + std::to_string(endpointId) +
              " in the pool")
                 .c_str());
+        return;
+    }
+
+    setBit(freeEids, endpointId, !assigned);
+    if (assigned)
+    {
+        phosphor::logging::log<phosphor::logging::level::DEBUG>(
+            ("EID " + std::to_string(endpointId) + " is assigned").c_str());
     }
+    else
+    {
+        phosphor::logging::log<phosphor::logging::level::DEBUG>(
+            ("EID " + std::to_string(endpointId) + " added to pool").c_str());
+    }
+}
+
+std::optional<mctp_eid_t> EidPool::findFree(const EidBitmap& candidates) const
+{
+    size_t eid = nextSetBit(candidates, nextEid);
+    if (eid == maxEids)
+    {
+        eid = nextSetBit(candidates, 0);
+    }
+    if (eid == maxEids)
+    {
+        return std::nullopt;
+    }
+    return static_cast<mctp_eid_t>(eid);
 }
 
-mctp_eid_t EidPool::getAvailableEidFromPool()
+void EidPool::allocate(mctp_eid_t eid)
+{
+    setBit(freeEids, eid, false);
+    nextEid = (eid + 1u) % maxEids;
+    phosphor::logging::log<phosphor::logging::level::DEBUG>(
+        ("Allocated EID: " + std::to_string(eid)).c_str());
+}
+
+mctp_eid_t EidPool::getAvailableEidFromPool(const std::string& uuid)
 {
     // Note:- No need to check for busowner role explicitly when accessing EID
     // pool since getAvailableEidFromPool will be called only in busowner mode.
 
-    for (auto& [eid, eidAssignedStatus] : eidPool)
+    if (auto eid = getEidAffinity(uuid); eid && testBit(freeEids, *eid))
     {
-        if (!eidAssignedStatus)
-        {
-            phosphor::logging::log<phosphor::logging::level::DEBUG>(
-                ("Allocated EID: " + std::to_string(eid)).c_str());
-            eidAssignedStatus = true;
-            return eid;
-        }
+        allocate(*eid);
+        return *eid;
+    }
+
+    // EIDs kept for other UUIDs are only handed out once no other is free
+    EidBitmap unclaimed;
+    for (size_t i = 0; i < unclaimed.size(); i++)
+    {
+        unclaimed[i] = freeEids[i] & ~claimedEids[i];
     }
+    std::optional<mctp_eid_t> eid = findFree(unclaimed);
+    if (!eid)
+    {
+        eid = findFree(freeEids);
+    }
+    if (eid)
+    {
+        allocate(*eid);
+        return *eid;
+    }
+
     phosphor::logging::log<phosphor::logging::level::ERR>(
         "No free EID in the pool");
     throw std::system_error(
         std::make_error_code(std::errc::address_not_available));
 }
 
+std::optional<mctp_eid_t>
+    EidPool::getEidAffinity(const std::string& uuid) const
+{
+    auto it = uuidToEid.find(uuid);
+    if (it == uuidToEid.end())
+    {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void EidPool::setEidAffinity(const std::string& uuid,
+                             const mctp_eid_t endpointId)
+{
+    if (isNullUuid(uuid) || !testBit(poolEids, endpointId) ||
+        eidToUuid[endpointId] == uuid)
+    {
+        return;
+    }
+
+    if (auto previousEid = getEidAffinity(uuid))
+    {
+        eidToUuid[*previousEid].clear();
+        setBit(claimedEids, *previousEid, false);
+    }
+    if (!eidToUuid[endpointId].empty())
+    {
+        // The pool ran out of other EIDs, the previous owner loses its claim
+        uuidToEid.erase(eidToUuid[endpointId]);
+    }
+    uuidToEid[uuid] = endpointId;
+    eidToUuid[endpointId] = uuid;
+    setBit(claimedEids, endpointId, true);
+    storeAffinity();
+}
+
+// The affinity file holds one UUID and its EID per line
+void EidPool::loadAffinity()
+{
+    if (affinityFile.empty())
+    {
+        return;
+    }
+    std::ifstream file(affinityFile);
+    std::string uuid;
+    unsigned int eid = 0;
+    while (file >> uuid >> eid)
+    {
+        if (eid >= maxEids || isNullUuid(uuid) ||
+            !testBit(poolEids, static_cast<mctp_eid_t>(eid)) ||
+            !eidToUuid[eid].empty() || uuidToEid.contains(uuid))
+        {
+            continue;
+        }
+        uuidToEid[uuid] = static_cast<mctp_eid_t>(eid);
+        eidToUuid[eid] = uuid;
+        setBit(claimedEids, static_cast<mctp_eid_t>(eid), true);
+    }
+    phosphor::logging::log<phosphor::logging::level::DEBUG>(
+        ("Loaded " + std::to_string(uuidToEid.size()) + " EID affinities")
+            .c_str());
+}
+
+void EidPool::storeAffinity() const
+{
+    if (affinityFile.empty())
+    {
+        return;
+    }
+    writeFileAtomically(affinityFile, [this](std::ostream& file) {
+        for (const auto& [uuid, eid] : uuidToEid)
+        {
+            file << uuid << ' ' << static_cast<unsigned int>(eid) << '\n';
+        }
+    });
+}
+
 } // namespace mctpd
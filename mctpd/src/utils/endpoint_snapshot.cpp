@@ -0,0 +1,145 @@
+/*
+// Copyright (c) 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "utils/endpoint_snapshot.hpp"
+
+#include "utils/atomic_file.hpp"
+
+#include <fstream>
+#include <limits>
+#include <phosphor-logging/log.hpp>
+#include <sstream>
+
+namespace mctpd
+{
+
+namespace
+{
+// Lists are written comma separated in hex, "-" for an empty one
+template <typename T>
+void writeList(std::ostream& stream, const std::vector<T>& list)
+{
+    if (list.empty())
+    {
+        stream << '-';
+        return;
+    }
+    for (size_t i = 0; i < list.size(); i++)
+    {
+        stream << (i ? "," : "") << std::hex
+               << static_cast<unsigned int>(list[i]) << std::dec;
+    }
+}
+
+template <typename T>
+bool readList(const std::string& field, std::vector<T>& list)
+{
+    list.clear();
+    if (field == "-")
+    {
+        return true;
+    }
+    std::istringstream stream(field);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        size_t end = 0;
+        unsigned long value = 0;
+        try
+        {
+            value = std::stoul(item, &end, 16);
+        }
+        catch (const std::exception&)
+        {
+            return false;
+        }
+        if (end != item.size() || value > std::numeric_limits<T>::max())
+        {
+            return false;
+        }
+        list.push_back(static_cast<T>(value));
+    }
+    return true;
+}
+
+std::string orDash(const std::string& value)
+{
+    return value.empty() ? "-" : value;
+}
+
+std::string fromDash(const std::string& value)
+{
+    return value == "-" ? std::string() : value;
+}
+} // namespace
+
+std::vector<EndpointRecord>
+    readEndpointSnapshot(const std::filesystem::path& file)
+{
+    std::vector<EndpointRecord> endpoints;
+    std::ifstream stream(file);
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        std::istringstream fields(line);
+        EndpointRecord endpoint;
+        unsigned int eid = 0;
+        unsigned int networkId = 0;
+        std::string msgTypes;
+        std::string vendorIdFormat;
+        std::string vendorIdCapabilitySets;
+        if (!(fields >> eid >> endpoint.uuid >> endpoint.mode >> networkId >>
+              msgTypes >> vendorIdFormat >> vendorIdCapabilitySets >>
+              endpoint.address) ||
+            eid > std::numeric_limits<uint8_t>::max() ||
+            networkId > std::numeric_limits<uint16_t>::max() ||
+            !readList(msgTypes, endpoint.msgTypes) ||
+            !readList(vendorIdCapabilitySets,
+                      endpoint.vendorIdCapabilitySets))
+        {
+            phosphor::logging::log<phosphor::logging::level::WARNING>(
+                ("Skipping endpoint snapshot line: " + line).c_str());
+            continue;
+        }
+        endpoint.eid = static_cast<uint8_t>(eid);
+        endpoint.networkId = static_cast<uint16_t>(networkId);
+        endpoint.uuid = fromDash(endpoint.uuid);
+        endpoint.mode = fromDash(endpoint.mode);
+        endpoint.vendorIdFormat = fromDash(vendorIdFormat);
+        endpoint.address = fromDash(endpoint.address);
+        endpoints.emplace_back(std::move(endpoint));
+    }
+    return endpoints;
+}
+
+bool writeEndpointSnapshot(const std::filesystem::path& file,
+                           const std::vector<EndpointRecord>& endpoints)
+{
+    return writeFileAtomically(file, [&endpoints](std::ostream& stream) {
+        for (const auto& endpoint : endpoints)
+        {
+            stream << static_cast<unsigned int>(endpoint.eid) << ' '
+                   << orDash(endpoint.uuid) << ' ' << orDash(endpoint.mode)
+                   << ' ' << endpoint.networkId << ' ';
+            writeList(stream, endpoint.msgTypes);
+            stream << ' ' << orDash(endpoint.vendorIdFormat) << ' ';
+            writeList(stream, endpoint.vendorIdCapabilitySets);
+            stream << ' ' << orDash(endpoint.address) << '\n';
+        }
+    });
+}
+
+} // namespace mctpd
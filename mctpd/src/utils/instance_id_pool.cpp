@@ -0,0 +1,57 @@
+/*
+// Copyright (c) 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "utils/instance_id_pool.hpp"
+
+namespace mctpd
+{
+
+std::optional<uint8_t> InstanceIdPool::allocate(mctp_eid_t eid)
+{
+    static_assert(idCount == 32, "IDs are tracked in a 32 bit word");
+    auto& endpoint = endpoints[eid];
+    if (endpoint.used == UINT32_MAX)
+    {
+        return std::nullopt;
+    }
+
+    // Rotate the free IDs so the search starts at the next one
+    uint32_t free = ~endpoint.used;
+    if (endpoint.next != 0)
+    {
+        free = (free >> endpoint.next) | (free << (idCount - endpoint.next));
+    }
+    auto instanceId = static_cast<uint8_t>(
+        (endpoint.next + static_cast<unsigned>(__builtin_ctz(free))) %
+        idCount);
+    endpoint.used |= uint32_t{1} << instanceId;
+    endpoint.next = static_cast<uint8_t>((instanceId + 1) % idCount);
+    return instanceId;
+}
+
+void InstanceIdPool::release(mctp_eid_t eid, uint8_t instanceId)
+{
+    if (instanceId < idCount)
+    {
+        endpoints[eid].used &= ~(uint32_t{1} << instanceId);
+    }
+}
+
+size_t InstanceIdPool::inUse(mctp_eid_t eid) const
+{
+    return static_cast<size_t>(__builtin_popcount(endpoints[eid].used));
+}
+} // namespace mctpd
@@ -0,0 +1,44 @@
+/*
+// Copyright (c) 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+#include "utils/latency_histogram.hpp"
+
+#include <algorithm>
+
+namespace mctpd
+{
+
+void LatencyHistogram::record(std::chrono::steady_clock::duration latency)
+{
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(latency);
+    auto bucket = std::upper_bound(bounds.begin(), bounds.end(), us);
+    counts[static_cast<size_t>(bucket - bounds.begin())]++;
+    max = std::max(max, us);
+}
+
+std::map<std::string, uint64_t> LatencyHistogram::get() const
+{
+    static const std::array<std::string, bounds.size() + 1> labels = {
+        "<100us", "<1ms", "<10ms", "<100ms", "<1s", ">=1s"};
+
+    std::map<std::string, uint64_t> result;
+    for (size_t i = 0; i < counts.size(); i++)
+    {
+        result.emplace(labels[i], counts[i]);
+    }
+    result.emplace("Max", static_cast<uint64_t>(max.count()));
+    return result;
+}
+} // namespace mctpd
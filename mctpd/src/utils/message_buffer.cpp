@@ -0,0 +1,124 @@
+/*
+// Copyright (c) 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "utils/message_buffer.hpp"
+
+#include <utility>
+
+namespace mctpd
+{
+
+struct MessageBufferPool::State
+{
+    size_t maxFree;
+    std::vector<std::unique_ptr<MessageBuffer::Block>> free{};
+    Counters counters{};
+};
+
+struct MessageBuffer::Block
+{
+    std::vector<uint8_t> data{};
+    size_t refs{0u};
+    // Set only while the block is in use, free blocks don't keep the pool
+    // alive
+    std::shared_ptr<MessageBufferPool::State> pool{};
+};
+
+MessageBuffer::MessageBuffer(Block* blockIn) : block(blockIn)
+{
+    ++block->refs;
+}
+
+MessageBuffer::MessageBuffer(const MessageBuffer& other) : block(other.block)
+{
+    if (block)
+    {
+        ++block->refs;
+    }
+}
+
+MessageBuffer::MessageBuffer(MessageBuffer&& other) noexcept :
+    block(std::exchange(other.block, nullptr))
+{
+}
+
+MessageBuffer& MessageBuffer::operator=(MessageBuffer other) noexcept
+{
+    std::swap(block, other.block);
+    return *this;
+}
+
+MessageBuffer::~MessageBuffer()
+{
+    if (!block || --block->refs > 0)
+    {
+        return;
+    }
+
+    auto pool = std::move(block->pool);
+    std::unique_ptr<Block> owned(block);
+    if (pool && pool->free.size() < pool->maxFree)
+    {
+        pool->free.push_back(std::move(owned));
+    }
+}
+
+std::vector<uint8_t>& MessageBuffer::operator*() const
+{
+    return block->data;
+}
+
+std::vector<uint8_t>* MessageBuffer::operator->() const
+{
+    return &block->data;
+}
+
+MessageBufferPool::MessageBufferPool(size_t maxFreeBuffers) :
+    state(std::make_shared<State>(State{maxFreeBuffers}))
+{
+}
+
+MessageBuffer MessageBufferPool::acquire(const void* data, size_t len)
+{
+    auto& counters = state->counters;
+    std::unique_ptr<MessageBuffer::Block> block;
+    if (!state->free.empty())
+    {
+        block = std::move(state->free.back());
+        state->free.pop_back();
+    }
+    else
+    {
+        block = std::make_unique<MessageBuffer::Block>();
+    }
+    if (block->data.capacity() < len)
+    {
+        ++counters.allocations;
+    }
+
+    auto bytes = static_cast<const uint8_t*>(data);
+    block->data.assign(bytes, bytes + len);
+    block->pool = state;
+    ++counters.acquired;
+    counters.bytesCopied += len;
+    return MessageBuffer(block.release());
+}
+
+const MessageBufferPool::Counters& MessageBufferPool::getCounters() const
+{
+    return state->counters;
+}
+} // namespace mctpd
@@ -0,0 +1,150 @@
+/*
+// Copyright (c) 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "utils/message_subscribers.hpp"
+
+#include <libmctp-msgtypes.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace mctpd
+{
+
+bool MessageSubscribers::Filter::operator==(const Filter& other) const
+{
+    return msgType == other.msgType && vendorId == other.vendorId &&
+           vendorMsgType == other.vendorMsgType &&
+           vendorMsgTypeMask == other.vendorMsgTypeMask;
+}
+
+bool MessageSubscribers::Filter::matches(const std::vector<uint8_t>& msg) const
+{
+    if (msg.empty() || msg[0] != msgType)
+    {
+        return false;
+    }
+    if (msgType != MCTP_MESSAGE_TYPE_VDPCI)
+    {
+        return true;
+    }
+
+    // Message type is followed by the PCI vendor ID and the vendor defined
+    // message type, both big endian
+    constexpr size_t vendorHdrLen = 5;
+    if (msg.size() < vendorHdrLen)
+    {
+        return false;
+    }
+    uint16_t msgVendorId = static_cast<uint16_t>((msg[1] << 8) | msg[2]);
+    uint16_t msgVendorType = static_cast<uint16_t>((msg[3] << 8) | msg[4]);
+    return msgVendorId == vendorId &&
+           (msgVendorType & vendorMsgTypeMask) ==
+               (vendorMsgType & vendorMsgTypeMask);
+}
+
+bool MessageSubscribers::subscribe(const std::string& client,
+                                   const Filter& filter)
+{
+    auto& filters = clients[client].filters;
+    if (std::find(filters.begin(), filters.end(), filter) != filters.end())
+    {
+        return false;
+    }
+    filters.push_back(filter);
+    return true;
+}
+
+bool MessageSubscribers::unsubscribe(const std::string& client,
+                                     const Filter& filter)
+{
+    auto clientItr = clients.find(client);
+    if (clientItr == clients.end())
+    {
+        return false;
+    }
+    auto& filters = clientItr->second.filters;
+    auto filterItr = std::find(filters.begin(), filters.end(), filter);
+    if (filterItr == filters.end())
+    {
+        return false;
+    }
+    filters.erase(filterItr);
+    if (filters.empty())
+    {
+        clients.erase(clientItr);
+    }
+    return true;
+}
+
+void MessageSubscribers::removeClient(const std::string& client)
+{
+    clients.erase(client);
+}
+
+bool MessageSubscribers::hasClient(const std::string& client) const
+{
+    return clients.find(client) != clients.end();
+}
+
+std::vector<std::string>
+    MessageSubscribers::getRecipients(const std::vector<uint8_t>& msg)
+{
+    std::vector<std::string> recipients;
+    for (auto& [name, client] : clients)
+    {
+        if (std::any_of(client.filters.begin(), client.filters.end(),
+                        [&msg](const Filter& filter) {
+                            return filter.matches(msg);
+                        }))
+        {
+            recipients.push_back(name);
+            ++client.delivered;
+        }
+    }
+    return recipients;
+}
+
+MessageSubscribers::Delivery
+    MessageSubscribers::getDelivery(const std::vector<uint8_t>& msg)
+{
+    Delivery delivery;
+    auto recipients = getRecipients(msg);
+    if (!recipients.empty() &&
+        directedOnlyTypes.find(msg[0]) != directedOnlyTypes.end())
+    {
+        delivery.recipients = std::move(recipients);
+        delivery.broadcast = false;
+    }
+    return delivery;
+}
+
+void MessageSubscribers::setDirectedOnlyTypes(
+    const std::set<uint8_t>& msgTypes)
+{
+    directedOnlyTypes = msgTypes;
+}
+
+std::map<std::string, uint64_t> MessageSubscribers::getDeliveryCounters() const
+{
+    std::map<std::string, uint64_t> counters;
+    for (const auto& [name, client] : clients)
+    {
+        counters.emplace(name, client.delivered);
+    }
+    return counters;
+}
+} // namespace mctpd
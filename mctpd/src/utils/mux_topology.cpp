@@ -0,0 +1,263 @@
+/*
+// Copyright (c) 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+#include "utils/mux_topology.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <phosphor-logging/log.hpp>
+#include <regex>
+
+namespace fs = std::filesystem;
+
+namespace mctpd
+{
+
+namespace
+{
+std::optional<std::string> readIdleState(int fd)
+{
+    std::string value(16, '\0');
+    ssize_t len = pread(fd, value.data(), value.size(), 0);
+    if (len < 0)
+    {
+        return std::nullopt;
+    }
+    value.resize(static_cast<size_t>(len));
+    while (!value.empty() && (value.back() == '\n' || value.back() == '\0'))
+    {
+        value.pop_back();
+    }
+    return value;
+}
+} // namespace
+
+MuxTopology::MuxTopology(const fs::path& sysfsDirIn, const fs::path& devDirIn) :
+    sysfsDir(sysfsDirIn), devDir(devDirIn)
+{
+}
+
+MuxTopology::~MuxTopology()
+{
+    for (const auto& [fd, channel] : channels)
+    {
+        close(fd);
+    }
+    for (int fd : retiredFds)
+    {
+        close(fd);
+    }
+    for (const auto& [name, mux] : muxes)
+    {
+        if (mux.idleStateFd >= 0)
+        {
+            close(mux.idleStateFd);
+        }
+    }
+}
+
+std::vector<int> MuxTopology::refresh(int rootBus,
+                                      const std::string& newIdleState)
+{
+    const std::string root = std::to_string(rootBus);
+    std::error_code ec;
+
+    // Whatever was still using these has drained since the last refresh
+    for (int fd : retiredFds)
+    {
+        close(fd);
+    }
+    retiredFds.clear();
+
+    // Mux channels are buses whose mux_device links to a mux on the root bus,
+    // named after the bus and the mux address, e.g. 5-0070
+    const std::regex busName(R"(i2c-(\d+))");
+    const std::regex muxName(root + "-([0-9a-fA-F]{4})");
+    std::map<int, std::string> foundChannels;
+    std::map<std::string, uint8_t> foundMuxes;
+    for (const auto& entry : fs::directory_iterator(sysfsDir, ec))
+    {
+        std::string name = entry.path().filename();
+        std::smatch busMatch;
+        if (!std::regex_match(name, busMatch, busName))
+        {
+            continue;
+        }
+        std::error_code linkEc;
+        std::string mux =
+            fs::read_symlink(entry.path() / "mux_device", linkEc).filename();
+        std::smatch muxMatch;
+        if (linkEc || !std::regex_match(mux, muxMatch, muxName))
+        {
+            continue;
+        }
+        foundChannels.emplace(std::stoi(busMatch[1].str()), mux);
+        foundMuxes.emplace(mux, static_cast<uint8_t>(std::stoul(
+                                    muxMatch[1].str(), nullptr, 16)));
+    }
+
+    for (auto it = muxes.begin(); it != muxes.end();)
+    {
+        if (foundMuxes.count(it->first) != 0)
+        {
+            ++it;
+            continue;
+        }
+        if (it->second.idleStateFd >= 0)
+        {
+            close(it->second.idleStateFd);
+        }
+        it = muxes.erase(it);
+    }
+    for (const auto& [name, address] : foundMuxes)
+    {
+        if (muxes.count(name) != 0)
+        {
+            continue;
+        }
+
+        // Not every mux driver has an idle state
+        Mux mux;
+        mux.address = address;
+        auto idlePath = sysfsDir / ("i2c-" + root) / name / "idle_state";
+        if (fs::exists(idlePath, ec))
+        {
+            mux.idleStateFd = open(idlePath.c_str(), O_RDWR | O_CLOEXEC);
+            if (mux.idleStateFd < 0)
+            {
+                phosphor::logging::log<phosphor::logging::level::ERR>(
+                    "Unable to open mux idle state",
+                    phosphor::logging::entry("MUX_PATH=%s", idlePath.c_str()));
+            }
+            else if (auto state = readIdleState(mux.idleStateFd))
+            {
+                mux.originalIdleState = *state;
+                mux.idleState = *state;
+            }
+        }
+        auto added = muxes.emplace(name, std::move(mux)).first;
+        writeIdleState(name, added->second, newIdleState);
+    }
+
+    std::vector<int> removed;
+    for (auto it = channels.begin(); it != channels.end();)
+    {
+        auto found = foundChannels.find(it->second.bus);
+        if (found != foundChannels.end() && found->second == it->second.mux)
+        {
+            foundChannels.erase(found);
+            ++it;
+            continue;
+        }
+        removed.emplace_back(it->first);
+        it = channels.erase(it);
+    }
+    retiredFds = removed;
+    for (const auto& [bus, mux] : foundChannels)
+    {
+        std::string path = devDir / ("i2c-" + std::to_string(bus));
+        int fd = open(path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0)
+        {
+            continue;
+        }
+        channels.emplace(fd, Channel{bus, mux});
+    }
+    return removed;
+}
+
+std::map<int, int> MuxTopology::getChannelBuses() const
+{
+    std::map<int, int> buses;
+    for (const auto& [fd, channel] : channels)
+    {
+        buses.emplace(fd, channel.bus);
+    }
+    return buses;
+}
+
+const MuxTopology::Mux* MuxTopology::getMux(int channelFd) const
+{
+    auto name = getMuxName(channelFd);
+    if (!name)
+    {
+        return nullptr;
+    }
+    auto mux = muxes.find(*name);
+    return mux != muxes.end() ? &mux->second : nullptr;
+}
+
+std::optional<std::string> MuxTopology::getMuxName(int channelFd) const
+{
+    auto channel = channels.find(channelFd);
+    if (channel == channels.end())
+    {
+        return std::nullopt;
+    }
+    return channel->second.mux;
+}
+
+bool MuxTopology::setIdleState(int channelFd, const std::string& state)
+{
+    auto name = getMuxName(channelFd);
+    if (!name)
+    {
+        return false;
+    }
+    return writeIdleState(*name, muxes.at(*name), state);
+}
+
+void MuxTopology::setIdleStates(const std::string& state)
+{
+    for (auto& [name, mux] : muxes)
+    {
+        writeIdleState(name, mux, state);
+    }
+}
+
+void MuxTopology::restoreIdleStates()
+{
+    for (auto& [name, mux] : muxes)
+    {
+        if (!mux.originalIdleState.empty())
+        {
+            writeIdleState(name, mux, mux.originalIdleState);
+        }
+    }
+}
+
+bool MuxTopology::writeIdleState(const std::string& name, Mux& mux,
+                                 const std::string& state)
+{
+    if (mux.idleStateFd < 0)
+    {
+        return false;
+    }
+    if (mux.idleState == state)
+    {
+        return true;
+    }
+    if (pwrite(mux.idleStateFd, state.data(), state.size(), 0) < 0)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Unable to set idle mode for mux",
+            phosphor::logging::entry("MUX=%s", name.c_str()));
+        return false;
+    }
+    mux.idleState = state;
+    return true;
+}
+} // namespace mctpd
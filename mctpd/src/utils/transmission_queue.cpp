@@ -1,15 +1,17 @@
 #include "utils/transmission_queue.hpp"
 
+#include "utils/bitmap.hpp"
+
+#include <libmctp-msgtypes.h>
+
+#include <algorithm>
 #include <phosphor-logging/log.hpp>
 
 using mctpd::MctpTransmissionQueue;
+using mctpd::nextSetBit;
+using mctpd::setBit;
 
-MctpTransmissionQueue::Message::Message(size_t index_,
-                                        std::vector<uint8_t>&& payload_,
-                                        std::vector<uint8_t>&& privateData_,
-                                        boost::asio::io_context& ioc) :
-    index(index_),
-    payload(std::move(payload_)), privateData(std::move(privateData_)),
+MctpTransmissionQueue::Message::Message(boost::asio::io_context& ioc) :
     timer(ioc)
 {
 }
@@ -33,100 +35,320 @@ void MctpTransmissionQueue::Tags::erase(uint8_t flag)
     bits &= static_cast<uint8_t>(~(1 << flag));
 }
 
-std::shared_ptr<MctpTransmissionQueue::Message> MctpTransmissionQueue::transmit(
-    struct mctp* mctp, mctp_eid_t destEid, std::vector<uint8_t>&& payload,
-    std::vector<uint8_t>&& privateData, boost::asio::io_context& ioc)
+void MctpTransmissionQueue::MessageList::push(Message& message)
+{
+    message.prev = tail;
+    message.next = nullptr;
+    if (tail)
+    {
+        tail->next = &message;
+    }
+    else
+    {
+        head = &message;
+    }
+    tail = &message;
+}
+
+MctpTransmissionQueue::Message& MctpTransmissionQueue::MessageList::pop()
+{
+    Message& message = *head;
+    erase(message);
+    return message;
+}
+
+void MctpTransmissionQueue::MessageList::erase(Message& message)
+{
+    (message.prev ? message.prev->next : head) = message.next;
+    (message.next ? message.next->prev : tail) = message.prev;
+    message.prev = nullptr;
+    message.next = nullptr;
+}
+
+MctpTransmissionQueue::MctpTransmissionQueue(boost::asio::io_context& iocIn,
+                                             size_t segmentBudgetIn) :
+    ioc(iocIn),
+    segmentBudget(segmentBudgetIn)
+{
+    slots.reserve(initialSlots);
+    freeSlots.reserve(initialSlots);
+    for (size_t i = 0; i < initialSlots; i++)
+    {
+        slots.emplace_back(std::make_unique<Message>(ioc));
+        freeSlots.emplace_back(slots.back().get());
+    }
+}
+
+MctpTransmissionQueue::Priority
+    MctpTransmissionQueue::classify(const std::vector<uint8_t>& payload)
 {
+    // PLDM type is in the low bits of the third byte, after the MCTP message
+    // type and the PLDM instance ID
+    static constexpr uint8_t pldmTypeMask = 0x3F;
+    static constexpr uint8_t pldmTypeFirmwareUpdate = 0x05;
+    static constexpr uint8_t msgTypeMask = 0x7F;
+
+    if (payload.empty())
+    {
+        return Priority::normal;
+    }
+    uint8_t msgType = payload[0] & msgTypeMask;
+    if (msgType == MCTP_MESSAGE_TYPE_MCTP_CTRL)
+    {
+        return Priority::control;
+    }
+    if (msgType == MCTP_MESSAGE_TYPE_PLDM && payload.size() > 2 &&
+        (payload[2] & pldmTypeMask) == pldmTypeFirmwareUpdate)
+    {
+        return Priority::bulk;
+    }
+    return Priority::normal;
+}
+
+MctpTransmissionQueue::Message& MctpTransmissionQueue::allocate()
+{
+    if (freeSlots.empty())
+    {
+        // Every slot is waiting for a response, grow the slab. Free slots
+        // can't outnumber the slots, so they never need to grow on dispose.
+        slots.emplace_back(std::make_unique<Message>(ioc));
+        freeSlots.reserve(slots.size());
+        return *slots.back();
+    }
+    Message& message = *freeSlots.back();
+    freeSlots.pop_back();
+    return message;
+}
+
+MctpTransmissionQueue::Message&
+    MctpTransmissionQueue::transmit(struct mctp* mctp, mctp_eid_t destEid,
+                                    std::vector<uint8_t>&& payload,
+                                    const std::vector<uint8_t>& privateData,
+                                    uint32_t segment)
+{
+    Message& message = allocate();
+    message.payload = std::move(payload);
+    // Copied into the slot's storage, which is reused from message to message
+    message.privateData.assign(privateData.begin(), privateData.end());
+    message.priority = classify(message.payload);
+    message.segment = segment;
+    message.destEid = destEid;
+    message.queuedAt = std::chrono::steady_clock::now();
+
+    const auto priorityIndex = static_cast<size_t>(message.priority);
     auto& endpoint = endpoints[destEid];
-    auto msgIndex = endpoint.msgCounter++;
-    auto message = std::make_shared<Message>(msgIndex, std::move(payload),
-                                             std::move(privateData), ioc);
-    endpoint.queuedMessages.emplace(msgIndex, message);
-    endpoint.transmitQueuedMessages(mctp, destEid);
+    endpoint.used = true;
+    endpoint.queuedMessages[priorityIndex].push(message);
+    endpoint.stats.queueDepth++;
+    message.queued = true;
+    setBit(pending[priorityIndex], destEid, true);
+    queued[priorityIndex]++;
+
+    schedule(mctp);
     return message;
 }
 
-void MctpTransmissionQueue::Endpoint::transmitQueuedMessages(struct mctp* mctp,
-                                                             mctp_eid_t destEid)
+bool MctpTransmissionQueue::transmitTo(struct mctp* mctp, mctp_eid_t destEid,
+                                       Priority priority)
 {
-    while (!queuedMessages.empty())
+    const auto priorityIndex = static_cast<size_t>(priority);
+    auto& endpoint = endpoints[destEid];
+    auto& queue = endpoint.queuedMessages[priorityIndex];
+
+    const std::optional<uint8_t> nextTag = endpoint.availableTags.next();
+    if (!nextTag)
     {
-        const std::optional<uint8_t> nextTag = availableTags.next();
-        if (!nextTag)
+        return false;
+    }
+    if (segmentsInFlight[queue.head->segment] >= segmentBudget)
+    {
+        return false;
+    }
+
+    auto msgTag = nextTag.value();
+    Message& message = queue.pop();
+    message.queued = false;
+    queued[priorityIndex]--;
+    if (!queue.head)
+    {
+        setBit(pending[priorityIndex], destEid, false);
+    }
+    lastServed[priorityIndex] = destEid;
+
+    auto& stats = endpoint.stats;
+    stats.queueDepth--;
+
+    int rc = mctp_message_tx(mctp, destEid, message.payload.data(),
+                             message.payload.size(), true, msgTag,
+                             message.privateData.data());
+    if (rc < 0)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Error in mctp_message_tx");
+        // Wake up the requester instead of letting it wait for the timeout
+        message.failed = true;
+        message.timer.cancel();
+        return true;
+    }
+
+    auto wait = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - message.queuedAt);
+    stats.totalWait += wait;
+    stats.maxWait = std::max(stats.maxWait, wait);
+    endpoint.availableTags.erase(msgTag);
+    message.tag = msgTag;
+    segmentsInFlight[message.segment]++;
+    stats.inFlight++;
+    stats.transmitted++;
+    endpoint.transmittedMessages[msgTag] = &message;
+    return true;
+}
+
+bool MctpTransmissionQueue::transmitNext(struct mctp* mctp, Priority priority)
+{
+    const auto& bitmap = pending[static_cast<size_t>(priority)];
+    const auto& last = lastServed[static_cast<size_t>(priority)];
+
+    // Start after the endpoint served last in this class, so each endpoint
+    // gets a turn before any of them gets a second one
+    const size_t start = last ? last.value() + 1u : 0u;
+    for (auto [begin, end] : {std::pair{start, maxEndpoints},
+                              std::pair{size_t{0}, start}})
+    {
+        for (size_t eid = nextSetBit(bitmap, begin); eid < end;
+             eid = nextSetBit(bitmap, eid + 1))
         {
-            break;
+            if (transmitTo(mctp, static_cast<mctp_eid_t>(eid), priority))
+            {
+                return true;
+            }
         }
-        auto msgTag = nextTag.value();
-        auto queuedMessageIter = queuedMessages.begin();
-        auto message = std::move(queuedMessageIter->second);
-        queuedMessages.erase(queuedMessageIter);
-
-        int rc = mctp_message_tx(mctp, destEid, message->payload.data(),
-                                 message->payload.size(), true, msgTag,
-                                 message->privateData.data());
-        if (rc < 0)
+    }
+    return false;
+}
+
+void MctpTransmissionQueue::schedule(struct mctp* mctp)
+{
+    auto transmitFrom = [this, mctp](bool withCredits) {
+        for (size_t priority = 0; priority < priorityCount; priority++)
         {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "Error in mctp_message_tx");
-            continue;
+            if ((credits[priority] != 0) != withCredits ||
+                !transmitNext(mctp, static_cast<Priority>(priority)))
+            {
+                continue;
+            }
+            if (withCredits)
+            {
+                credits[priority]--;
+            }
+            return true;
         }
+        return false;
+    };
 
-        availableTags.erase(msgTag);
-        message->tag = msgTag;
-        transmittedMessages.emplace(msgTag, std::move(message));
+    while (true)
+    {
+        // Higher classes go first while they have credits left, lower ones
+        // still get their share of every round
+        if (transmitFrom(true))
+        {
+            continue;
+        }
+        bool creditedQueued = false;
+        for (size_t priority = 0; priority < priorityCount; priority++)
+        {
+            creditedQueued |= credits[priority] != 0 && queued[priority] != 0;
+        }
+        if (!creditedQueued && credits != priorityWeights)
+        {
+            credits = priorityWeights;
+            continue;
+        }
+        // Classes with credits are waiting for tags or segment budget, the
+        // others may use whatever is free meanwhile
+        if (!transmitFrom(false))
+        {
+            break;
+        }
     }
 }
 
+void MctpTransmissionQueue::release(Endpoint& endpoint, const Message& message)
+{
+    auto msgTag = message.tag.value();
+    endpoint.transmittedMessages[msgTag] = nullptr;
+    endpoint.availableTags.emplace(msgTag);
+    endpoint.stats.inFlight--;
+    // Entries are kept at zero so the map doesn't allocate per message
+    segmentsInFlight[message.segment]--;
+}
+
 bool MctpTransmissionQueue::receive(struct mctp* mctp, mctp_eid_t srcEid,
                                     uint8_t msgTag,
-                                    std::vector<uint8_t>&& response,
-                                    boost::asio::io_context& ioc)
+                                    const MessageBuffer& response)
 {
-    auto endpointIter = endpoints.find(srcEid);
-    if (endpointIter == endpoints.end())
+    if (msgTag >= maxTags)
     {
         return false;
     }
-
-    auto& endpoint = endpointIter->second;
-    auto messageIter = endpoint.transmittedMessages.find(msgTag);
-    if (messageIter == endpoint.transmittedMessages.end())
+    auto& endpoint = endpoints[srcEid];
+    Message* message = endpoint.transmittedMessages[msgTag];
+    if (!message)
     {
         return false;
     }
 
-    const auto message = messageIter->second;
-    message->response = std::move(response);
-    endpoint.transmittedMessages.erase(messageIter);
+    message->response = response;
+    release(endpoint, *message);
     message->tag.reset();
-    endpoint.availableTags.emplace(msgTag);
 
-    // Now that another tag is available, try to transmit any queued messages
+    // Now that a tag and segment budget are available, try to transmit any
+    // queued messages
     message->timer.cancel();
-    ioc.post([this, mctp, srcEid] {
-        endpoints[srcEid].transmitQueuedMessages(mctp, srcEid);
-    });
+    ioc.post([this, mctp] { schedule(mctp); });
     return true;
 }
 
-void MctpTransmissionQueue::dispose(mctp_eid_t destEid,
-                                    const std::shared_ptr<Message>& message)
+void MctpTransmissionQueue::dispose(struct mctp* mctp, Message& message)
 {
-    auto& endpoint = endpoints[destEid];
-    auto queuedMessageIter = endpoint.queuedMessages.find(message->index);
-    if (queuedMessageIter != endpoint.queuedMessages.end())
+    auto& endpoint = endpoints[message.destEid];
+    if (message.queued)
     {
-        endpoint.queuedMessages.erase(queuedMessageIter);
+        const auto priorityIndex = static_cast<size_t>(message.priority);
+        auto& queue = endpoint.queuedMessages[priorityIndex];
+        queue.erase(message);
+        message.queued = false;
+        endpoint.stats.queueDepth--;
+        queued[priorityIndex]--;
+        if (!queue.head)
+        {
+            setBit(pending[priorityIndex], message.destEid, false);
+        }
     }
-    if (message->tag)
+    if (message.tag)
     {
-        auto msgTag = message->tag.value();
-        endpoint.availableTags.emplace(msgTag);
+        release(endpoint, message);
+        message.tag.reset();
+        schedule(mctp);
+    }
+
+    message.response = MessageBuffer();
+    message.failed = false;
+    message.payload.clear();
+    message.privateData.clear();
+    freeSlots.emplace_back(&message);
+}
 
-        auto transmittedMessageIter = endpoint.transmittedMessages.find(msgTag);
-        if (transmittedMessageIter != endpoint.transmittedMessages.end())
+std::map<mctp_eid_t, MctpTransmissionQueue::EndpointStats>
+    MctpTransmissionQueue::getStats() const
+{
+    std::map<mctp_eid_t, EndpointStats> stats;
+    for (size_t eid = 0; eid < maxEndpoints; eid++)
+    {
+        if (endpoints[eid].used)
         {
-            endpoint.transmittedMessages.erase(transmittedMessageIter);
+            stats.emplace(static_cast<mctp_eid_t>(eid), endpoints[eid].stats);
         }
     }
+    return stats;
 }
\ No newline at end of file
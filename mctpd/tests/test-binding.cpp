@@ -128,3 +128,87 @@ TEST_F(BindingBasicTest, Send_GetEid_Timeout)
         ASSERT_EQ(0, resp.size());
     }
 }
+
+TEST_F(BindingBasicTest, Send_GetEid_ResponseFromOtherEid)
+{
+    constexpr unsigned DEST_EID = 10;
+    constexpr unsigned OTHER_EID = 11;
+    constexpr unsigned CC_OK = 0;
+
+    auto getEid = makePromise<std::tuple<bool, std::vector<uint8_t>>>();
+    schedule([&](boost::asio::yield_context yield) {
+        std::vector<uint8_t> prv, resp;
+
+        bool result = binding->getEidCtrlCmd(yield, prv, DEST_EID, resp);
+        getEid.promise.set_value({result, resp});
+    });
+
+    // Same instance ID, but sent by another endpoint
+    schedule([&]() {
+        auto response =
+            binding->backdoor.prepareCtrlResponse<mctp_ctrl_resp_get_eid>();
+        response.hdr->src = OTHER_EID;
+        response.payload->completion_code = CC_OK;
+        binding->backdoor.rx(response);
+    });
+
+    // Check that the response was not matched and GetEid timed out
+    {
+        const auto [result, resp] = waitFor(getEid.future);
+        ASSERT_FALSE(result);
+        ASSERT_EQ(0, resp.size());
+    }
+}
+
+TEST_F(BindingBasicTest, Send_GetEid_ConcurrentToSameEid)
+{
+    constexpr unsigned DEST_EID = 10;
+    constexpr unsigned CC_OK = 0;
+    constexpr std::array<unsigned, 2> RESP_EIDS = {21, 22};
+
+    std::array<AsyncPair<std::tuple<bool, std::vector<uint8_t>>>, 2> getEids;
+    for (auto& getEid : getEids)
+    {
+        schedule([&](boost::asio::yield_context yield) {
+            std::vector<uint8_t> prv, resp;
+
+            bool result = binding->getEidCtrlCmd(yield, prv, DEST_EID, resp);
+            getEid.promise.set_value({result, resp});
+        });
+    }
+
+    // Both requests are outstanding with their own instance ID and tag,
+    // answer them in reverse order
+    schedule([&]() {
+        auto& tx = binding->backdoor.log().tx;
+        ASSERT_EQ(tx.size(), 2u);
+        auto first = reinterpret_cast<const mctp_ctrl_msg_hdr*>(
+            tx.front().payload.data());
+        auto second = reinterpret_cast<const mctp_ctrl_msg_hdr*>(
+            tx.back().payload.data());
+        ASSERT_NE(first->rq_dgram_inst, second->rq_dgram_inst);
+        ASSERT_NE(tx.front().header.flags_seq_tag & MCTP_HDR_TAG_MASK,
+                  tx.back().header.flags_seq_tag & MCTP_HDR_TAG_MASK);
+
+        for (size_t i : {size_t{1}, size_t{0}})
+        {
+            auto response =
+                binding->backdoor.prepareCtrlResponse<mctp_ctrl_resp_get_eid>(
+                    i == 0 ? tx.front() : tx.back());
+            response.payload->completion_code = CC_OK;
+            response.payload->eid = static_cast<uint8_t>(RESP_EIDS[i]);
+            binding->backdoor.rx(response);
+        }
+    });
+
+    for (size_t i = 0; i < getEids.size(); i++)
+    {
+        const auto [result, resp] = waitFor(getEids[i].future);
+        ASSERT_TRUE(result);
+        ASSERT_EQ(resp.size(), sizeof(mctp_ctrl_resp_get_eid));
+
+        auto response =
+            reinterpret_cast<const mctp_ctrl_resp_get_eid*>(resp.data());
+        ASSERT_EQ(response->eid, RESP_EIDS[i]);
+    }
+}
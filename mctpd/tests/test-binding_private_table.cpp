@@ -0,0 +1,43 @@
+#include "utils/binding_private_table.hpp"
+
+#include <gtest/gtest.h>
+
+using Table = mctpd::BindingPrivateTable<std::pair<int, uint8_t>>;
+
+TEST(BindingPrivateTableTest, LooksUpByEidAndAddress)
+{
+    Table table;
+    table.set(10, {3, 0x20}, {0x01, 0x02});
+    table.set(11, {4, 0x20}, {0x03});
+
+    ASSERT_NE(table.getPrivateData(10), nullptr);
+    EXPECT_EQ(*table.getPrivateData(10), std::vector<uint8_t>({0x01, 0x02}));
+    EXPECT_EQ(table.getPrivateData(12), nullptr);
+    EXPECT_EQ(table.getEid({4, 0x20}), 11);
+    EXPECT_FALSE(table.getEid({5, 0x20}));
+}
+
+TEST(BindingPrivateTableTest, SetReplacesEntryOfEid)
+{
+    Table table;
+    table.set(10, {3, 0x20}, {0x01});
+    table.set(10, {3, 0x22}, {0x02});
+
+    EXPECT_FALSE(table.getEid({3, 0x20}));
+    EXPECT_EQ(table.getEid({3, 0x22}), 10);
+    EXPECT_EQ(table.getAddress(10), std::make_pair(3, uint8_t{0x22}));
+}
+
+TEST(BindingPrivateTableTest, SharedAddressKeepsRemainingEids)
+{
+    Table table;
+    table.set(12, {3, 0x20}, {});
+    table.set(10, {3, 0x20}, {});
+
+    EXPECT_EQ(table.getEid({3, 0x20}), 10);
+    table.erase(10);
+    EXPECT_FALSE(table.contains(10));
+    EXPECT_EQ(table.getEid({3, 0x20}), 12);
+    table.clear();
+    EXPECT_FALSE(table.getEid({3, 0x20}));
+}
@@ -0,0 +1,61 @@
+#include "utils/blocking_worker.hpp"
+
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+TEST(BlockingWorkerTest, IoContextRunsWhileJobBlocks)
+{
+    boost::asio::io_context ioc;
+    mctpd::BlockingWorker worker(ioc);
+    const auto mainThread = std::this_thread::get_id();
+    std::thread::id jobThread;
+    bool jobDone = false;
+    size_t ticks = 0;
+
+    boost::asio::spawn(ioc, [&](boost::asio::yield_context yield) {
+        worker.run(yield, [&]() {
+            jobThread = std::this_thread::get_id();
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        });
+        jobDone = true;
+    });
+    boost::asio::spawn(ioc, [&](boost::asio::yield_context yield) {
+        boost::asio::steady_timer timer(ioc);
+        while (!jobDone)
+        {
+            timer.expires_after(std::chrono::milliseconds(5));
+            timer.async_wait(yield);
+            ticks++;
+        }
+    });
+    ioc.run();
+
+    EXPECT_TRUE(jobDone);
+    EXPECT_NE(jobThread, mainThread);
+    // The timer kept firing while the job slept
+    EXPECT_GT(ticks, 5u);
+}
+
+TEST(BlockingWorkerTest, JobExceptionIsRethrown)
+{
+    boost::asio::io_context ioc;
+    mctpd::BlockingWorker worker(ioc);
+    bool caught = false;
+
+    boost::asio::spawn(ioc, [&](boost::asio::yield_context yield) {
+        try
+        {
+            worker.run(yield, []() { throw std::runtime_error("probe"); });
+        }
+        catch (const std::runtime_error&)
+        {
+            caught = true;
+        }
+    });
+    ioc.run();
+
+    EXPECT_TRUE(caught);
+}
@@ -0,0 +1,145 @@
+#include "utils/data_socket.hpp"
+
+#include <algorithm>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <cstring>
+#include <set>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+using Protocol = boost::asio::generic::seq_packet_protocol;
+
+class DataSocketTest : public ::testing::Test
+{
+  public:
+    void SetUp() override
+    {
+        server = std::make_unique<mctpd::DataSocketServer>(
+            io, "mctpd-test-" + std::to_string(getpid()),
+            [this](mctp_eid_t dstEid, uint8_t, bool,
+                   std::vector<uint8_t> payload) {
+                sent.emplace_back(dstEid, std::move(payload));
+                return 0;
+            },
+            [this](boost::asio::yield_context yield, mctp_eid_t dstEid,
+                   std::vector<uint8_t> payload, uint16_t timeout) {
+                // EID doubles as response delay to reorder replies
+                maxActive = std::max(maxActive, ++active);
+                boost::asio::steady_timer timer(io);
+                timer.expires_after(std::chrono::milliseconds(dstEid));
+                timer.async_wait(yield);
+                --active;
+                if (dstEid > timeout)
+                {
+                    throw std::system_error(
+                        std::make_error_code(std::errc::timed_out));
+                }
+                payload.push_back(dstEid);
+                return pool.acquire(payload.data(), payload.size());
+            });
+
+        client.connect(Protocol::endpoint{
+            boost::asio::local::stream_protocol::endpoint(
+                std::string(1, '\0') + server->getName())});
+    }
+
+    void request(uint32_t id, mctpd::DataSocketOp op, uint8_t eid,
+                 std::vector<uint8_t> payload)
+    {
+        mctpd::DataSocketHeader header{};
+        header.id = id;
+        header.op = static_cast<uint8_t>(op);
+        header.eid = eid;
+        header.timeout = 50;
+        std::vector<uint8_t> packet(sizeof(header));
+        std::memcpy(packet.data(), &header, sizeof(header));
+        packet.insert(packet.end(), payload.begin(), payload.end());
+        client.send(boost::asio::buffer(packet), 0);
+    }
+
+    std::pair<mctpd::DataSocketHeader, std::vector<uint8_t>> reply()
+    {
+        std::vector<uint8_t> packet(mctpd::DataSocketServer::maxPacketSize);
+        boost::asio::socket_base::message_flags flags = 0;
+        size_t len = 0;
+        client.async_receive(boost::asio::buffer(packet), flags,
+                             [&len](boost::system::error_code, size_t n) {
+                                 len = n;
+                             });
+        while (len == 0)
+        {
+            io.run_one();
+        }
+        mctpd::DataSocketHeader header{};
+        std::memcpy(&header, packet.data(), sizeof(header));
+        packet.resize(len);
+        packet.erase(packet.begin(), packet.begin() + sizeof(header));
+        return {header, packet};
+    }
+
+    boost::asio::io_context io;
+    mctpd::MessageBufferPool pool;
+    std::unique_ptr<mctpd::DataSocketServer> server;
+    Protocol::socket client{io};
+    std::vector<std::pair<mctp_eid_t, std::vector<uint8_t>>> sent;
+    size_t active = 0;
+    size_t maxActive = 0;
+};
+
+TEST_F(DataSocketTest, SendReturnsStatus)
+{
+    request(7, mctpd::DataSocketOp::send, 8, {0x01, 0x02});
+
+    auto [header, payload] = reply();
+    EXPECT_EQ(header.id, 7u);
+    EXPECT_EQ(header.status, 0);
+    EXPECT_TRUE(payload.empty());
+    ASSERT_EQ(sent.size(), 1u);
+    EXPECT_EQ(sent[0].first, 8);
+    EXPECT_EQ(sent[0].second, (std::vector<uint8_t>{0x01, 0x02}));
+}
+
+TEST_F(DataSocketTest, SendReceiveRepliesOutOfOrder)
+{
+    request(1, mctpd::DataSocketOp::sendReceive, 30, {0x01});
+    request(2, mctpd::DataSocketOp::sendReceive, 10, {0x01});
+
+    auto first = reply();
+    EXPECT_EQ(first.first.id, 2u);
+    EXPECT_EQ(first.second, (std::vector<uint8_t>{0x01, 10}));
+
+    auto second = reply();
+    EXPECT_EQ(second.first.id, 1u);
+    EXPECT_EQ(second.second, (std::vector<uint8_t>{0x01, 30}));
+}
+
+TEST_F(DataSocketTest, SendReceiveReportsErrno)
+{
+    request(3, mctpd::DataSocketOp::sendReceive, 60, {0x01});
+
+    auto [header, payload] = reply();
+    EXPECT_EQ(header.id, 3u);
+    EXPECT_EQ(header.status, -ETIMEDOUT);
+    EXPECT_TRUE(payload.empty());
+}
+
+TEST_F(DataSocketTest, RequestsBeyondInFlightLimitWait)
+{
+    constexpr size_t count = mctpd::DataSocketServer::maxRequestsInFlight + 4;
+    for (uint32_t id = 0; id < count; ++id)
+    {
+        request(id, mctpd::DataSocketOp::sendReceive, 20, {0x01});
+    }
+
+    std::set<uint32_t> ids;
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto [header, payload] = reply();
+        EXPECT_EQ(header.status, 0);
+        ids.insert(header.id);
+    }
+    EXPECT_EQ(ids.size(), count);
+    EXPECT_EQ(maxActive, mctpd::DataSocketServer::maxRequestsInFlight);
+}
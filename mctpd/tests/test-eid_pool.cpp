@@ -0,0 +1,81 @@
+#include "utils/eid_pool.hpp"
+
+#include <unistd.h>
+
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+
+static const std::string uuidA = "12345678-9abc-defe-dcba-987654321012";
+static const std::string uuidB = "87654321-cba0-efed-abcd-210123456789";
+static const std::string nullUuid = "00000000-0000-0000-0000-000000000000";
+
+TEST(EidPoolTest, ReusesReleasedEidLast)
+{
+    mctpd::EidPool pool;
+    pool.initializeEidPool({10, 11, 12});
+
+    EXPECT_EQ(pool.getAvailableEidFromPool(), 10);
+    EXPECT_EQ(pool.getAvailableEidFromPool(), 11);
+    pool.updateEidStatus(10, false);
+    EXPECT_EQ(pool.getAvailableEidFromPool(), 12);
+    EXPECT_EQ(pool.getAvailableEidFromPool(), 10);
+    EXPECT_THROW(pool.getAvailableEidFromPool(), std::system_error);
+}
+
+TEST(EidPoolTest, ReturningUuidGetsItsEid)
+{
+    mctpd::EidPool pool;
+    pool.initializeEidPool({10, 11, 12});
+
+    mctp_eid_t eid = pool.getAvailableEidFromPool(uuidA);
+    pool.setEidAffinity(uuidA, eid);
+    pool.updateEidStatus(eid, false);
+
+    // Other devices get the EIDs nobody waits for while there are any
+    EXPECT_NE(pool.getAvailableEidFromPool(uuidB), eid);
+    EXPECT_NE(pool.getAvailableEidFromPool(nullUuid), eid);
+    EXPECT_EQ(pool.getAvailableEidFromPool(uuidA), eid);
+}
+
+TEST(EidPoolTest, ClaimedEidHandedOutWhenPoolRunsOut)
+{
+    mctpd::EidPool pool;
+    pool.initializeEidPool({10});
+
+    pool.setEidAffinity(uuidA, pool.getAvailableEidFromPool(uuidA));
+    pool.updateEidStatus(10, false);
+    EXPECT_EQ(pool.getAvailableEidFromPool(uuidB), 10);
+    pool.setEidAffinity(uuidB, 10);
+
+    EXPECT_FALSE(pool.getEidAffinity(uuidA));
+    EXPECT_EQ(pool.getEidAffinity(uuidB), 10);
+}
+
+TEST(EidPoolTest, AffinityPersisted)
+{
+    fs::path dir = fs::temp_directory_path() /
+                   ("eid_pool_test-" + std::to_string(getpid()));
+    fs::path file = dir / "eid-affinity";
+
+    {
+        mctpd::EidPool pool;
+        pool.initializeEidPool({10, 11, 12}, file);
+        EXPECT_EQ(pool.getAvailableEidFromPool(uuidA), 10);
+        EXPECT_EQ(pool.getAvailableEidFromPool(uuidB), 11);
+        pool.setEidAffinity(uuidA, 10);
+        pool.setEidAffinity(uuidB, 11);
+        pool.setEidAffinity(nullUuid, 12);
+    }
+
+    mctpd::EidPool pool;
+    pool.initializeEidPool({10, 11, 12}, file);
+    EXPECT_EQ(pool.getAvailableEidFromPool(uuidB), 11);
+    EXPECT_EQ(pool.getAvailableEidFromPool(), 12);
+    EXPECT_EQ(pool.getAvailableEidFromPool(uuidA), 10);
+    EXPECT_FALSE(pool.getEidAffinity(nullUuid));
+
+    fs::remove_all(dir);
+}
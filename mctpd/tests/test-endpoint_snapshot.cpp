@@ -0,0 +1,74 @@
+#include "utils/endpoint_snapshot.hpp"
+
+#include <unistd.h>
+
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+
+class EndpointSnapshotTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        dir = fs::temp_directory_path() /
+              ("endpoint_snapshot_test-" + std::to_string(getpid()));
+        file = dir / "endpoints";
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(dir);
+    }
+
+    fs::path dir;
+    fs::path file;
+};
+
+TEST_F(EndpointSnapshotTest, ReadsBackWhatWasWritten)
+{
+    std::vector<mctpd::EndpointRecord> endpoints(2);
+    endpoints[0].eid = 10;
+    endpoints[0].uuid = "12345678-9abc-defe-dcba-987654321012";
+    endpoints[0].mode = "xyz.openbmc_project.MCTP.Base.BindingModeTypes.Bridge";
+    endpoints[0].networkId = 3;
+    endpoints[0].msgTypes = {0x00, 0x01, 0x7e};
+    endpoints[0].vendorIdFormat = "0x8086";
+    endpoints[0].vendorIdCapabilitySets = {0x8086, 0x0001};
+    endpoints[0].address = "12:29";
+    endpoints[1].eid = 11;
+    endpoints[1].uuid = "00000000-0000-0000-0000-000000000000";
+    endpoints[1].mode =
+        "xyz.openbmc_project.MCTP.Base.BindingModeTypes.Endpoint";
+    endpoints[1].address = "3:40";
+
+    ASSERT_TRUE(mctpd::writeEndpointSnapshot(file, endpoints));
+    EXPECT_FALSE(fs::exists(file.string() + ".tmp"));
+    EXPECT_EQ(mctpd::readEndpointSnapshot(file), endpoints);
+}
+
+TEST_F(EndpointSnapshotTest, SkipsUnreadableLines)
+{
+    fs::create_directories(dir);
+    {
+        std::ofstream stream(file);
+        stream << "300 uuid mode 0 - - - 1:2\n"
+               << "12 uuid mode 0 zz - - 1:2\n"
+               << "13 uuid\n"
+               << "14 uuid mode 0 0,5 - - 1:2\n";
+    }
+
+    auto endpoints = mctpd::readEndpointSnapshot(file);
+    ASSERT_EQ(endpoints.size(), 1u);
+    EXPECT_EQ(endpoints[0].eid, 14);
+    EXPECT_EQ(endpoints[0].msgTypes, (std::vector<uint8_t>{0, 5}));
+    EXPECT_TRUE(endpoints[0].vendorIdFormat.empty());
+    EXPECT_TRUE(endpoints[0].vendorIdCapabilitySets.empty());
+}
+
+TEST_F(EndpointSnapshotTest, MissingFileHasNoEndpoints)
+{
+    EXPECT_TRUE(mctpd::readEndpointSnapshot(file).empty());
+}
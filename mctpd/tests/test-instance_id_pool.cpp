@@ -0,0 +1,39 @@
+#include "utils/instance_id_pool.hpp"
+
+#include <gtest/gtest.h>
+
+TEST(InstanceIdPoolTest, AllocatesRoundRobinPerEid)
+{
+    mctpd::InstanceIdPool pool;
+
+    EXPECT_EQ(pool.allocate(10), 0);
+    EXPECT_EQ(pool.allocate(10), 1);
+    // Other endpoints have IDs of their own
+    EXPECT_EQ(pool.allocate(11), 0);
+
+    // A released ID is reused only after all the others
+    pool.release(10, 0);
+    for (uint8_t expected = 2; expected < mctpd::InstanceIdPool::idCount;
+         expected++)
+    {
+        EXPECT_EQ(pool.allocate(10), expected);
+    }
+    EXPECT_EQ(pool.allocate(10), 0);
+    EXPECT_EQ(pool.inUse(10), mctpd::InstanceIdPool::idCount);
+    EXPECT_EQ(pool.inUse(11), 1u);
+}
+
+TEST(InstanceIdPoolTest, RunsOutWhileAllIdsAreInUse)
+{
+    mctpd::InstanceIdPool pool;
+
+    for (size_t i = 0; i < mctpd::InstanceIdPool::idCount; i++)
+    {
+        ASSERT_TRUE(pool.allocate(10));
+    }
+    EXPECT_FALSE(pool.allocate(10));
+
+    pool.release(10, 7);
+    EXPECT_EQ(pool.allocate(10), 7);
+    EXPECT_FALSE(pool.allocate(10));
+}
@@ -0,0 +1,24 @@
+#include "utils/latency_histogram.hpp"
+
+#include <gtest/gtest.h>
+
+TEST(LatencyHistogramTest, RecordsIntoBuckets)
+{
+    using namespace std::chrono_literals;
+    mctpd::LatencyHistogram histogram;
+
+    histogram.record(50us);
+    histogram.record(100us);
+    histogram.record(999us);
+    histogram.record(20ms);
+    histogram.record(3s);
+
+    auto buckets = histogram.get();
+    EXPECT_EQ(buckets["<100us"], 1u);
+    EXPECT_EQ(buckets["<1ms"], 2u);
+    EXPECT_EQ(buckets["<10ms"], 0u);
+    EXPECT_EQ(buckets["<100ms"], 1u);
+    EXPECT_EQ(buckets["<1s"], 0u);
+    EXPECT_EQ(buckets[">=1s"], 1u);
+    EXPECT_EQ(buckets["Max"], 3000000u);
+}
@@ -142,6 +142,38 @@ TEST_F(MctpdBaseTest, BaseIfPropertyTest)
         .Times(1)
         .WillRepeatedly(Return(true));
 
+    EXPECT_CALL(*mctpInterface,
+                register_method(StrEq("RegisterMessageSubscriber")))
+        .Times(1)
+        .WillRepeatedly(Return(true));
+
+    EXPECT_CALL(*mctpInterface,
+                register_method(StrEq("UnregisterMessageSubscriber")))
+        .Times(1)
+        .WillRepeatedly(Return(true));
+
+    EXPECT_CALL(*mctpInterface,
+                register_method(StrEq("GetMessageDeliveryCounters")))
+        .Times(1)
+        .WillRepeatedly(Return(true));
+
+    EXPECT_CALL(*mctpInterface, register_method(StrEq("GetRxBufferCounters")))
+        .Times(1)
+        .WillRepeatedly(Return(true));
+
+    EXPECT_CALL(*mctpInterface,
+                register_method(StrEq("GetTransmissionQueueStats")))
+        .Times(1)
+        .WillRepeatedly(Return(true));
+
+    EXPECT_CALL(*mctpInterface, register_method(StrEq("GetEndpoints")))
+        .Times(1)
+        .WillRepeatedly(Return(true));
+
+    EXPECT_CALL(*mctpInterface, register_method(StrEq("GetEndpointsSince")))
+        .Times(1)
+        .WillRepeatedly(Return(true));
+
     EXPECT_CALL(
         *smbusInterface,
         register_property(StrEq("ArpMasterSupport"), An<bool>(),
@@ -170,6 +202,10 @@ TEST_F(MctpdBaseTest, BaseIfPropertyTest)
         .Times(1)
         .WillRepeatedly(Return(true));
 
+    EXPECT_CALL(*smbusInterface, register_method(StrEq("GetScanRxLatency")))
+        .Times(1)
+        .WillRepeatedly(Return(true));
+
     EXPECT_CALL(*mctpInterface, initialize())
         .Times(1)
         .WillRepeatedly(Return(true));
@@ -0,0 +1,59 @@
+#include "utils/message_buffer.hpp"
+
+#include <gtest/gtest.h>
+
+TEST(MessageBufferTest, HandlesShareBuffer)
+{
+    mctpd::MessageBufferPool pool;
+    const std::vector<uint8_t> msg = {0x01, 0x02, 0x03};
+
+    auto buffer = pool.acquire(msg.data(), msg.size());
+    auto copy = buffer;
+    EXPECT_EQ(*buffer, msg);
+    EXPECT_EQ(&*copy, &*buffer);
+
+    auto moved = std::move(copy);
+    EXPECT_FALSE(copy);
+    EXPECT_EQ(moved->size(), msg.size());
+}
+
+TEST(MessageBufferTest, ReleasedBufferIsReused)
+{
+    mctpd::MessageBufferPool pool;
+    const std::vector<uint8_t> msg(64, 0xAB);
+
+    for (int i = 0; i < 10; i++)
+    {
+        auto buffer = pool.acquire(msg.data(), msg.size());
+        EXPECT_EQ(*buffer, msg);
+    }
+
+    const auto& counters = pool.getCounters();
+    EXPECT_EQ(counters.acquired, 10u);
+    EXPECT_EQ(counters.allocations, 1u);
+    EXPECT_EQ(counters.bytesCopied, 10u * msg.size());
+}
+
+TEST(MessageBufferTest, BufferGrowthIsCounted)
+{
+    mctpd::MessageBufferPool pool;
+    const std::vector<uint8_t> small(8);
+    const std::vector<uint8_t> large(256);
+
+    pool.acquire(small.data(), small.size());
+    pool.acquire(large.data(), large.size());
+    pool.acquire(small.data(), small.size());
+
+    EXPECT_EQ(pool.getCounters().allocations, 2u);
+}
+
+TEST(MessageBufferTest, BufferOutlivesPool)
+{
+    const std::vector<uint8_t> msg = {0x01};
+    mctpd::MessageBuffer buffer;
+    {
+        mctpd::MessageBufferPool pool;
+        buffer = pool.acquire(msg.data(), msg.size());
+    }
+    EXPECT_EQ(*buffer, msg);
+}
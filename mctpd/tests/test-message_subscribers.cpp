@@ -0,0 +1,92 @@
+#include "utils/message_subscribers.hpp"
+
+#include <libmctp-msgtypes.h>
+
+#include <gtest/gtest.h>
+
+using Filter = mctpd::MessageSubscribers::Filter;
+
+TEST(MessageSubscribersTest, DeliversByMessageType)
+{
+    mctpd::MessageSubscribers subscribers;
+    EXPECT_TRUE(subscribers.subscribe(":1.10", {MCTP_MESSAGE_TYPE_PLDM}));
+    EXPECT_TRUE(subscribers.subscribe(":1.11", {MCTP_MESSAGE_TYPE_SPDM}));
+    EXPECT_FALSE(subscribers.subscribe(":1.10", {MCTP_MESSAGE_TYPE_PLDM}));
+
+    std::vector<uint8_t> pldmMsg = {MCTP_MESSAGE_TYPE_PLDM, 0x80, 0x02};
+    EXPECT_EQ(subscribers.getRecipients(pldmMsg),
+              std::vector<std::string>{":1.10"});
+    EXPECT_TRUE(subscribers.getRecipients({MCTP_MESSAGE_TYPE_NCSI}).empty());
+    EXPECT_TRUE(subscribers.getRecipients({}).empty());
+
+    auto counters = subscribers.getDeliveryCounters();
+    EXPECT_EQ(counters.at(":1.10"), 1u);
+    EXPECT_EQ(counters.at(":1.11"), 0u);
+}
+
+TEST(MessageSubscribersTest, DeliversVdpciByVendorAndMask)
+{
+    constexpr uint16_t vendorId = 0x8086;
+    mctpd::MessageSubscribers subscribers;
+    subscribers.subscribe(":1.20",
+                          {MCTP_MESSAGE_TYPE_VDPCI, vendorId, 0x0001, 0x00FF});
+    subscribers.subscribe(":1.21",
+                          {MCTP_MESSAGE_TYPE_VDPCI, vendorId, 0x0002, 0x00FF});
+
+    std::vector<uint8_t> msg = {MCTP_MESSAGE_TYPE_VDPCI, 0x80, 0x86, 0x01,
+                                0x02};
+    EXPECT_EQ(subscribers.getRecipients(msg),
+              std::vector<std::string>{":1.21"});
+
+    msg[1] = 0x10;
+    EXPECT_TRUE(subscribers.getRecipients(msg).empty());
+
+    std::vector<uint8_t> shortMsg = {MCTP_MESSAGE_TYPE_VDPCI, 0x80, 0x86};
+    EXPECT_TRUE(subscribers.getRecipients(shortMsg).empty());
+}
+
+TEST(MessageSubscribersTest, UnsubscribeAndRemoveClient)
+{
+    mctpd::MessageSubscribers subscribers;
+    Filter pldm{MCTP_MESSAGE_TYPE_PLDM};
+    Filter spdm{MCTP_MESSAGE_TYPE_SPDM};
+    subscribers.subscribe(":1.30", pldm);
+    subscribers.subscribe(":1.30", spdm);
+    subscribers.subscribe(":1.31", pldm);
+
+    EXPECT_TRUE(subscribers.unsubscribe(":1.30", pldm));
+    EXPECT_FALSE(subscribers.unsubscribe(":1.30", pldm));
+    EXPECT_TRUE(subscribers.hasClient(":1.30"));
+    EXPECT_TRUE(subscribers.unsubscribe(":1.30", spdm));
+    EXPECT_FALSE(subscribers.hasClient(":1.30"));
+
+    subscribers.removeClient(":1.31");
+    EXPECT_TRUE(subscribers.getRecipients({MCTP_MESSAGE_TYPE_PLDM}).empty());
+    EXPECT_TRUE(subscribers.getDeliveryCounters().empty());
+}
+
+TEST(MessageSubscribersTest, BroadcastsForUnregisteredClients)
+{
+    // ":1.50" registered for PLDM, another client listens to the broadcast
+    // without registering
+    mctpd::MessageSubscribers subscribers;
+    subscribers.subscribe(":1.50", {MCTP_MESSAGE_TYPE_PLDM});
+    std::vector<uint8_t> pldmMsg = {MCTP_MESSAGE_TYPE_PLDM, 0x80, 0x02};
+
+    auto delivery = subscribers.getDelivery(pldmMsg);
+    EXPECT_TRUE(delivery.broadcast);
+    EXPECT_TRUE(delivery.recipients.empty());
+
+    subscribers.setDirectedOnlyTypes({MCTP_MESSAGE_TYPE_PLDM});
+    delivery = subscribers.getDelivery(pldmMsg);
+    EXPECT_FALSE(delivery.broadcast);
+    EXPECT_EQ(delivery.recipients, std::vector<std::string>{":1.50"});
+
+    // Directed only types nobody registered for are still broadcast
+    subscribers.setDirectedOnlyTypes({MCTP_MESSAGE_TYPE_SPDM});
+    delivery = subscribers.getDelivery({MCTP_MESSAGE_TYPE_SPDM});
+    EXPECT_TRUE(delivery.broadcast);
+    EXPECT_TRUE(delivery.recipients.empty());
+
+    EXPECT_EQ(subscribers.getDeliveryCounters().at(":1.50"), 2u);
+}
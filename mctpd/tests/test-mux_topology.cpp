@@ -0,0 +1,150 @@
+#include "utils/mux_topology.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+
+// Builds a fake sysfs and /dev for root bus 5 in a temporary directory
+class MuxTopologyTest : public ::testing::Test
+{
+  public:
+    void SetUp() override
+    {
+        root = fs::temp_directory_path() /
+               ("mux_topology-" + std::to_string(getpid()));
+        fs::remove_all(root);
+        fs::create_directories(root / "sys" / "i2c-5");
+        fs::create_directories(root / "dev");
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(root);
+    }
+
+    void addMux(const std::string& name, const std::vector<int>& buses)
+    {
+        fs::create_directories(root / "sys" / "i2c-5" / name);
+        std::ofstream(root / "sys" / "i2c-5" / name / "idle_state") << "-1\n";
+        for (int bus : buses)
+        {
+            auto busDir = root / "sys" / ("i2c-" + std::to_string(bus));
+            fs::create_directories(busDir);
+            fs::create_directory_symlink("../i2c-5/" + name,
+                                         busDir / "mux_device");
+            std::ofstream(root / "dev" / ("i2c-" + std::to_string(bus)));
+        }
+    }
+
+    void removeChannel(int bus)
+    {
+        fs::remove_all(root / "sys" / ("i2c-" + std::to_string(bus)));
+    }
+
+    std::string idleState(const std::string& name)
+    {
+        std::string state;
+        std::ifstream(root / "sys" / "i2c-5" / name / "idle_state") >> state;
+        return state;
+    }
+
+    fs::path root;
+};
+
+TEST_F(MuxTopologyTest, FindsMuxesAndChannels)
+{
+    addMux("5-0070", {10, 11});
+    addMux("5-007a", {12});
+    // Not a mux, there is no idle_state
+    fs::create_directories(root / "sys" / "i2c-5" / "5-0050");
+
+    mctpd::MuxTopology topology(root / "sys", root / "dev");
+    EXPECT_TRUE(topology.refresh(5, "-2").empty());
+
+    auto buses = topology.getChannelBuses();
+    ASSERT_EQ(buses.size(), 3u);
+    for (const auto& [fd, bus] : buses)
+    {
+        auto mux = topology.getMux(fd);
+        ASSERT_NE(mux, nullptr);
+        EXPECT_EQ(mux->address, bus == 12 ? 0x7a : 0x70);
+        EXPECT_EQ(mux->originalIdleState, "-1");
+    }
+    EXPECT_EQ(idleState("5-0070"), "-2");
+    EXPECT_EQ(idleState("5-007a"), "-2");
+}
+
+TEST_F(MuxTopologyTest, SetsIdleStateOfOneMux)
+{
+    addMux("5-0070", {10});
+    addMux("5-0071", {11});
+
+    mctpd::MuxTopology topology(root / "sys", root / "dev");
+    topology.refresh(5, "-2");
+    for (const auto& [fd, bus] : topology.getChannelBuses())
+    {
+        if (bus == 11)
+        {
+            EXPECT_TRUE(topology.setIdleState(fd, "-1"));
+        }
+    }
+    EXPECT_EQ(idleState("5-0070"), "-2");
+    EXPECT_EQ(idleState("5-0071"), "-1");
+
+    topology.setIdleStates("-2");
+    EXPECT_EQ(idleState("5-0071"), "-2");
+    topology.restoreIdleStates();
+    EXPECT_EQ(idleState("5-0070"), "-1");
+    EXPECT_EQ(idleState("5-0071"), "-1");
+}
+
+TEST_F(MuxTopologyTest, RefreshKeepsFdsOfRemainingChannels)
+{
+    addMux("5-0070", {10, 11});
+
+    mctpd::MuxTopology topology(root / "sys", root / "dev");
+    topology.refresh(5, "-2");
+    auto before = topology.getChannelBuses();
+
+    removeChannel(11);
+    addMux("5-0071", {12});
+    auto removed = topology.refresh(5, "-2");
+
+    auto after = topology.getChannelBuses();
+    ASSERT_EQ(removed.size(), 1u);
+    EXPECT_EQ(before.at(removed[0]), 11);
+    ASSERT_EQ(after.size(), 2u);
+    for (const auto& [fd, bus] : before)
+    {
+        if (bus == 10)
+        {
+            EXPECT_EQ(after.at(fd), 10);
+        }
+    }
+    EXPECT_EQ(idleState("5-0071"), "-2");
+}
+
+TEST_F(MuxTopologyTest, RemovedChannelFdClosedOnNextRefresh)
+{
+    addMux("5-0070", {10, 11});
+
+    mctpd::MuxTopology topology(root / "sys", root / "dev");
+    topology.refresh(5, "-2");
+
+    removeChannel(11);
+    addMux("5-0071", {12});
+    auto removed = topology.refresh(5, "-2");
+    ASSERT_EQ(removed.size(), 1u);
+
+    // Still open, so the new channel can't get the same fd number
+    EXPECT_NE(fcntl(removed[0], F_GETFD), -1);
+    EXPECT_EQ(topology.getChannelBuses().count(removed[0]), 0u);
+
+    EXPECT_TRUE(topology.refresh(5, "-2").empty());
+    EXPECT_EQ(fcntl(removed[0], F_GETFD), -1);
+}
@@ -0,0 +1,414 @@
+#include "utils/transmission_queue.hpp"
+
+#include <libmctp-msgtypes.h>
+#include <libmctp.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using mctpd::MctpTransmissionQueue;
+
+// Measures the queue on its own: libmctp hands packets to a binding which
+// drops them, and responses are fed straight into the queue
+class TransmissionQueueBenchmark : public ::testing::Test
+{
+  public:
+    static constexpr mctp_eid_t ownEid = 8;
+    static constexpr size_t endpointCount = 16;
+    static constexpr size_t rounds = 20000;
+
+    void SetUp() override
+    {
+        binding.name = "benchmark";
+        binding.version = 1;
+        binding.tx = [](struct mctp_binding*, struct mctp_pktbuf*) {
+            return 0;
+        };
+        binding.pkt_size = MCTP_PACKET_SIZE(64);
+        binding.pkt_priv_size = 0;
+
+        mctp = mctp_init();
+        ASSERT_NE(mctp, nullptr);
+        ASSERT_EQ(mctp_register_bus(mctp, &binding, ownEid), 0);
+        mctp_binding_set_tx_enabled(&binding, true);
+    }
+
+    void TearDown() override
+    {
+        if (mctp)
+        {
+            mctp_destroy(mctp);
+        }
+    }
+
+    static mctp_eid_t endpointEid(size_t index)
+    {
+        return static_cast<mctp_eid_t>(ownEid + 1 + index);
+    }
+
+    void report(const char* name, size_t messages,
+                std::chrono::steady_clock::duration duration)
+    {
+        auto us =
+            std::chrono::duration_cast<std::chrono::microseconds>(duration)
+                .count();
+        auto perSecond = us > 0 ? messages * 1000000u / static_cast<size_t>(us)
+                                : messages;
+        RecordProperty(name, static_cast<int>(perSecond));
+        std::cout << name << ": " << perSecond << " messages/s\n";
+    }
+
+    boost::asio::io_context ioc;
+    struct mctp* mctp = nullptr;
+    struct mctp_binding binding = {};
+    mctpd::MessageBufferPool pool;
+};
+
+TEST_F(TransmissionQueueBenchmark, TransmitReceiveDispose)
+{
+    // Budget for a request to every endpoint at once
+    MctpTransmissionQueue queue(ioc, endpointCount);
+    const std::vector<uint8_t> request = {0x01, 0x80, 0x02, 0x11};
+    const std::vector<uint8_t> responseData = {0x01, 0x00, 0x02, 0x11, 0x00};
+    std::array<MctpTransmissionQueue::Message*, endpointCount> messages{};
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < rounds; round++)
+    {
+        for (size_t i = 0; i < endpointCount; i++)
+        {
+            messages[i] = &queue.transmit(mctp, endpointEid(i),
+                                          std::vector<uint8_t>(request), {});
+        }
+        for (size_t i = 0; i < endpointCount; i++)
+        {
+            ASSERT_TRUE(messages[i]->tag);
+            auto response =
+                pool.acquire(responseData.data(), responseData.size());
+            ASSERT_TRUE(queue.receive(mctp, endpointEid(i),
+                                      messages[i]->tag.value(), response));
+            queue.dispose(mctp, *messages[i]);
+        }
+        ioc.poll();
+    }
+    report("TransmitReceiveDispose", rounds * endpointCount,
+           std::chrono::steady_clock::now() - start);
+
+    // Every message got its response, so the preallocated slots sufficed
+    EXPECT_EQ(queue.getSlotCount(), MctpTransmissionQueue::initialSlots);
+    for (size_t i = 0; i < endpointCount; i++)
+    {
+        auto stats = queue.getStats()[endpointEid(i)];
+        EXPECT_EQ(stats.transmitted, rounds);
+        EXPECT_EQ(stats.inFlight, 0u);
+        EXPECT_EQ(stats.queueDepth, 0u);
+    }
+}
+
+TEST_F(TransmissionQueueBenchmark, QueueAndDispose)
+{
+    // One endpoint and more requests than tags. Disposing of a request in
+    // flight, as on a timeout, lets the next queued one go.
+    MctpTransmissionQueue queue(ioc);
+    const std::vector<uint8_t> request = {0x01, 0x80, 0x02, 0x11};
+    std::array<MctpTransmissionQueue::Message*, 24> messages{};
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < rounds; round++)
+    {
+        for (auto& message : messages)
+        {
+            message = &queue.transmit(mctp, endpointEid(0),
+                                      std::vector<uint8_t>(request), {});
+        }
+        for (auto message : messages)
+        {
+            queue.dispose(mctp, *message);
+        }
+    }
+    report("QueueAndDispose", rounds * messages.size(),
+           std::chrono::steady_clock::now() - start);
+
+    EXPECT_EQ(queue.getSlotCount(), MctpTransmissionQueue::initialSlots);
+    auto stats = queue.getStats()[endpointEid(0)];
+    EXPECT_EQ(stats.inFlight, 0u);
+    EXPECT_EQ(stats.queueDepth, 0u);
+}
+
+// Records what the queue hands to libmctp: destination, tag and message type
+class TransmissionQueueTest : public ::testing::Test
+{
+  public:
+    static constexpr mctp_eid_t ownEid = 8;
+
+    struct Sent
+    {
+        mctp_eid_t eid;
+        uint8_t tag;
+        uint8_t msgType;
+    };
+
+    void SetUp() override
+    {
+        sent.clear();
+        binding.name = "test";
+        binding.version = 1;
+        binding.tx = [](struct mctp_binding*, struct mctp_pktbuf* pkt) {
+            auto hdr = mctp_pktbuf_hdr(pkt);
+            auto data = static_cast<uint8_t*>(mctp_pktbuf_data(pkt));
+            sent.push_back(
+                {hdr->dest,
+                 static_cast<uint8_t>(hdr->flags_seq_tag & MCTP_HDR_TAG_MASK),
+                 data[0]});
+            return 0;
+        };
+        binding.pkt_size = MCTP_PACKET_SIZE(64);
+        binding.pkt_priv_size = 0;
+
+        mctp = mctp_init();
+        ASSERT_NE(mctp, nullptr);
+        ASSERT_EQ(mctp_register_bus(mctp, &binding, ownEid), 0);
+        mctp_binding_set_tx_enabled(&binding, true);
+    }
+
+    void TearDown() override
+    {
+        if (mctp)
+        {
+            mctp_destroy(mctp);
+        }
+    }
+
+    MctpTransmissionQueue::Message& transmit(MctpTransmissionQueue& queue,
+                                             mctp_eid_t eid,
+                                             std::vector<uint8_t> payload,
+                                             uint32_t segment = 0u)
+    {
+        auto& message =
+            queue.transmit(mctp, eid, std::move(payload), {}, segment);
+        messages.push_back(&message);
+        return message;
+    }
+
+    // Answers the message and lets the queue schedule the next ones
+    void respond(MctpTransmissionQueue& queue,
+                 MctpTransmissionQueue::Message& message, mctp_eid_t eid)
+    {
+        ASSERT_TRUE(message.tag);
+        const std::vector<uint8_t> data = {0x01, 0x00};
+        ASSERT_TRUE(queue.receive(mctp, eid, message.tag.value(),
+                                  pool.acquire(data.data(), data.size())));
+        ioc.restart();
+        ioc.poll();
+    }
+
+    // With a budget of one, answers whatever is in flight until all queued
+    // messages are sent
+    void drain(MctpTransmissionQueue& queue)
+    {
+        while (true)
+        {
+            auto inFlight = std::find_if(
+                messages.begin(), messages.end(),
+                [](const auto* message) { return message->tag.has_value(); });
+            if (inFlight == messages.end())
+            {
+                return;
+            }
+            respond(queue, **inFlight, sent.back().eid);
+        }
+    }
+
+    std::vector<mctp_eid_t> sentEids() const
+    {
+        std::vector<mctp_eid_t> eids;
+        for (const auto& packet : sent)
+        {
+            eids.push_back(packet.eid);
+        }
+        return eids;
+    }
+
+    static const std::vector<uint8_t> controlRequest;
+    static const std::vector<uint8_t> pldmRequest;
+    static const std::vector<uint8_t> pldmFwUpdateRequest;
+
+    static std::vector<Sent> sent;
+    boost::asio::io_context ioc;
+    struct mctp* mctp = nullptr;
+    struct mctp_binding binding = {};
+    mctpd::MessageBufferPool pool;
+    std::vector<MctpTransmissionQueue::Message*> messages;
+};
+
+const std::vector<uint8_t> TransmissionQueueTest::controlRequest = {
+    MCTP_MESSAGE_TYPE_MCTP_CTRL, 0x80, 0x02};
+const std::vector<uint8_t> TransmissionQueueTest::pldmRequest = {
+    MCTP_MESSAGE_TYPE_PLDM, 0x80, 0x02, 0x11};
+const std::vector<uint8_t> TransmissionQueueTest::pldmFwUpdateRequest = {
+    MCTP_MESSAGE_TYPE_PLDM, 0x80, 0x05, 0x15};
+std::vector<TransmissionQueueTest::Sent> TransmissionQueueTest::sent;
+
+TEST_F(TransmissionQueueTest, Classify)
+{
+    using Priority = MctpTransmissionQueue::Priority;
+    EXPECT_EQ(MctpTransmissionQueue::classify(controlRequest),
+              Priority::control);
+    // Integrity check bit doesn't change the class
+    constexpr uint8_t integrityCheck = 0x80;
+    EXPECT_EQ(MctpTransmissionQueue::classify(
+                  {integrityCheck | MCTP_MESSAGE_TYPE_PLDM, 0x80, 0x05}),
+              Priority::bulk);
+    EXPECT_EQ(MctpTransmissionQueue::classify(pldmRequest), Priority::normal);
+    EXPECT_EQ(MctpTransmissionQueue::classify(pldmFwUpdateRequest),
+              Priority::bulk);
+    EXPECT_EQ(MctpTransmissionQueue::classify({MCTP_MESSAGE_TYPE_PLDM, 0x80}),
+              Priority::normal);
+    EXPECT_EQ(MctpTransmissionQueue::classify({}), Priority::normal);
+}
+
+TEST_F(TransmissionQueueTest, TransmitsInQueueOrderWithFreeTags)
+{
+    MctpTransmissionQueue queue(ioc);
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        auto payload = pldmRequest;
+        payload.push_back(i);
+        transmit(queue, 10, std::move(payload));
+    }
+
+    ASSERT_EQ(sent.size(), 3u);
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        EXPECT_EQ(sent[i].eid, 10);
+        EXPECT_EQ(sent[i].tag, i);
+        EXPECT_EQ(messages[i]->tag, i);
+    }
+}
+
+TEST_F(TransmissionQueueTest, QueuesWhenTagsRunOut)
+{
+    MctpTransmissionQueue queue(ioc);
+    for (size_t i = 0; i < 9; i++)
+    {
+        transmit(queue, 10, pldmRequest);
+    }
+    EXPECT_EQ(sent.size(), 8u);
+    EXPECT_FALSE(messages[8]->tag);
+
+    // The tag of the answered message goes to the queued one
+    respond(queue, *messages[3], 10);
+    ASSERT_EQ(sent.size(), 9u);
+    EXPECT_EQ(sent[8].tag, 3);
+    EXPECT_EQ(messages[8]->tag, 3);
+}
+
+TEST_F(TransmissionQueueTest, WeightedRoundRobinAcrossClasses)
+{
+    // One message in flight at a time, so the queue picks every next one
+    MctpTransmissionQueue queue(ioc, 1);
+    transmit(queue, 9, pldmFwUpdateRequest);
+    for (size_t i = 0; i < 6; i++)
+    {
+        transmit(queue, 10, controlRequest);
+    }
+    for (size_t i = 0; i < 4; i++)
+    {
+        transmit(queue, 11, pldmRequest);
+    }
+    for (size_t i = 0; i < 3; i++)
+    {
+        transmit(queue, 12, pldmFwUpdateRequest);
+    }
+    ASSERT_EQ(sent.size(), 1u);
+
+    drain(queue);
+
+    // Rounds of 4 control, 2 normal and 1 bulk message. A round whose
+    // classes have nothing queued ends early, so the first message doesn't
+    // use up a turn of the next round.
+    const std::vector<mctp_eid_t> expected = {9,  10, 10, 10, 10, 11, 11,
+                                              12, 10, 10, 11, 11, 12, 12};
+    EXPECT_EQ(sentEids(), expected);
+}
+
+TEST_F(TransmissionQueueTest, RoundRobinAcrossEndpoints)
+{
+    MctpTransmissionQueue queue(ioc, 1);
+    transmit(queue, 9, pldmRequest);
+    for (mctp_eid_t eid : std::vector<mctp_eid_t>{12, 10, 11})
+    {
+        for (size_t i = 0; i < 3; i++)
+        {
+            transmit(queue, eid, pldmRequest);
+        }
+    }
+
+    drain(queue);
+
+    // Every endpoint gets a turn before any of them gets a second one,
+    // regardless of the order the messages were queued in
+    const std::vector<mctp_eid_t> expected = {9,  10, 11, 12, 10,
+                                              11, 12, 10, 11, 12};
+    EXPECT_EQ(sentEids(), expected);
+}
+
+TEST_F(TransmissionQueueTest, SegmentBudgetLimitsRequestsInFlight)
+{
+    constexpr uint32_t segmentA = 1;
+    constexpr uint32_t segmentB = 2;
+    MctpTransmissionQueue queue(ioc, 2);
+    auto& first = transmit(queue, 10, pldmRequest, segmentA);
+    transmit(queue, 11, pldmRequest, segmentA);
+    auto& third = transmit(queue, 10, pldmRequest, segmentA);
+    // Other segments have a budget of their own
+    transmit(queue, 12, pldmRequest, segmentB);
+
+    EXPECT_EQ(sentEids(), (std::vector<mctp_eid_t>{10, 11, 12}));
+    EXPECT_FALSE(third.tag);
+
+    respond(queue, first, 10);
+    EXPECT_EQ(sentEids(), (std::vector<mctp_eid_t>{10, 11, 12, 10}));
+    EXPECT_TRUE(third.tag);
+}
+
+TEST_F(TransmissionQueueTest, Stats)
+{
+    MctpTransmissionQueue queue(ioc, 1);
+    auto& first = transmit(queue, 10, pldmRequest);
+    auto& second = transmit(queue, 11, pldmRequest);
+    transmit(queue, 11, pldmRequest);
+
+    auto stats = queue.getStats();
+    ASSERT_EQ(stats.size(), 2u);
+    EXPECT_EQ(stats[10].inFlight, 1u);
+    EXPECT_EQ(stats[10].queueDepth, 0u);
+    EXPECT_EQ(stats[10].transmitted, 1u);
+    EXPECT_EQ(stats[11].inFlight, 0u);
+    EXPECT_EQ(stats[11].queueDepth, 2u);
+    EXPECT_EQ(stats[11].transmitted, 0u);
+
+    constexpr auto queued = std::chrono::milliseconds(5);
+    std::this_thread::sleep_for(queued);
+    respond(queue, first, 10);
+
+    stats = queue.getStats();
+    EXPECT_EQ(stats[10].inFlight, 0u);
+    EXPECT_EQ(stats[11].inFlight, 1u);
+    EXPECT_EQ(stats[11].queueDepth, 1u);
+    EXPECT_EQ(stats[11].transmitted, 1u);
+    EXPECT_GE(stats[11].maxWait, queued);
+    EXPECT_EQ(stats[11].totalWait, stats[11].maxWait);
+
+    // Disposing of a queued message removes it from the queue depth
+    queue.dispose(mctp, *messages[2]);
+    respond(queue, second, 11);
+    stats = queue.getStats();
+    EXPECT_EQ(stats[11].queueDepth, 0u);
+    EXPECT_EQ(stats[11].inFlight, 0u);
+    EXPECT_EQ(stats[11].transmitted, 1u);
+}
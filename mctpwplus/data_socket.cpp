@@ -0,0 +1,217 @@
+/*
+// Copyright (c) 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "data_socket.hpp"
+
+#include <array>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <cerrno>
+#include <cstring>
+#include <phosphor-logging/log.hpp>
+
+namespace mctpw
+{
+namespace internal
+{
+
+/// Operation codes, must match mctpd DataSocketOp
+static constexpr uint8_t dataSocketSend = 1;
+static constexpr uint8_t dataSocketSendReceive = 2;
+/// Largest packet mctpd sends on the data socket
+static constexpr size_t maxPacketSize = 64 * 1024;
+/// Time mctpd gets to reply on top of the MCTP response timeout
+static constexpr std::chrono::milliseconds replyGuardTime{1000};
+
+DataSocketClient::DataSocketClient(boost::asio::io_context& ioc,
+                                   const std::string& name) :
+    io(ioc),
+    socketName(name), socket(ioc)
+{
+}
+
+DataSocketClient::~DataSocketClient()
+{
+    close();
+}
+
+void DataSocketClient::connect()
+{
+    // Generic endpoint takes the address family from the local endpoint and
+    // the socket type from the protocol, giving AF_UNIX + SOCK_SEQPACKET
+    Protocol::endpoint endpoint{boost::asio::local::stream_protocol::endpoint(
+        std::string(1, '\0') + socketName)};
+    socket.connect(endpoint);
+    connected = true;
+
+    boost::asio::spawn(io, [self = shared_from_this()](
+                               boost::asio::yield_context yield) {
+        self->receiveReplies(yield);
+    });
+}
+
+void DataSocketClient::close()
+{
+    connected = false;
+    boost::system::error_code ec;
+    socket.close(ec);
+    for (auto& [id, request] : pending)
+    {
+        request->timer.cancel();
+    }
+}
+
+void DataSocketClient::receiveReplies(boost::asio::yield_context yield)
+{
+    std::vector<uint8_t> packet(maxPacketSize);
+    while (connected)
+    {
+        boost::system::error_code ec;
+        boost::asio::socket_base::message_flags flags = 0;
+        size_t len =
+            socket.async_receive(boost::asio::buffer(packet), flags, yield[ec]);
+        if (ec || len == 0)
+        {
+            if (connected)
+            {
+                phosphor::logging::log<phosphor::logging::level::WARNING>(
+                    ("Data socket " + socketName + " closed").c_str());
+            }
+            close();
+            return;
+        }
+        if (len < sizeof(DataSocketHeader))
+        {
+            continue;
+        }
+
+        DataSocketHeader header;
+        std::memcpy(&header, packet.data(), sizeof(header));
+        auto it = pending.find(header.id);
+        if (it == pending.end())
+        {
+            // Requester has given up waiting
+            continue;
+        }
+        it->second->reply = header;
+        it->second->response.assign(packet.begin() + sizeof(header),
+                                    packet.begin() +
+                                        static_cast<std::ptrdiff_t>(len));
+        it->second->timer.cancel();
+    }
+}
+
+std::optional<DataSocketHeader> DataSocketClient::transact(
+    boost::asio::yield_context yield, DataSocketHeader header,
+    const std::vector<uint8_t>& request, std::chrono::milliseconds wait,
+    std::vector<uint8_t>& response, boost::system::error_code& transportEc)
+{
+    if (!connected)
+    {
+        return std::nullopt;
+    }
+
+    uint32_t id = nextId++;
+    header.id = id;
+    auto pendingRequest = std::make_shared<PendingRequest>(io);
+    pending.emplace(id, pendingRequest);
+
+    // Armed before sending: the reply may arrive while async_send is
+    // suspended, and cancelling an idle timer would not wake up the wait
+    pendingRequest->timer.expires_after(wait);
+
+    std::array<boost::asio::const_buffer, 2> packet = {
+        boost::asio::buffer(&header, sizeof(header)),
+        boost::asio::buffer(request)};
+    boost::system::error_code ec;
+    socket.async_send(packet, 0, yield[ec]);
+    if (ec)
+    {
+        pending.erase(id);
+        close();
+        return std::nullopt;
+    }
+
+    // Woken up early by receiveReplies or close
+    if (!pendingRequest->reply && connected)
+    {
+        pendingRequest->timer.async_wait(yield[ec]);
+    }
+    pending.erase(id);
+
+    // The request has been sent, so it must not be repeated over D-Bus
+    if (!pendingRequest->reply)
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            ("No reply on data socket " + socketName).c_str());
+        transportEc = boost::system::errc::make_error_code(
+            connected ? boost::system::errc::timed_out
+                      : boost::system::errc::connection_reset);
+        return header;
+    }
+    response = std::move(pendingRequest->response);
+    return pendingRequest->reply;
+}
+
+std::optional<std::pair<boost::system::error_code, std::vector<uint8_t>>>
+    DataSocketClient::sendReceive(boost::asio::yield_context yield,
+                                  uint8_t dstEid,
+                                  const std::vector<uint8_t>& request,
+                                  std::chrono::milliseconds timeout)
+{
+    DataSocketHeader header{};
+    header.op = dataSocketSendReceive;
+    header.eid = dstEid;
+    header.timeout = static_cast<uint16_t>(timeout.count());
+
+    std::vector<uint8_t> response;
+    boost::system::error_code ec;
+    auto reply = transact(yield, header, request, timeout + replyGuardTime,
+                          response, ec);
+    if (!reply)
+    {
+        return std::nullopt;
+    }
+    if (!ec && reply->status < 0)
+    {
+        ec = boost::system::error_code(-reply->status,
+                                       boost::system::system_category());
+    }
+    return std::make_pair(ec, std::move(response));
+}
+
+std::optional<std::pair<boost::system::error_code, int>>
+    DataSocketClient::send(boost::asio::yield_context yield, uint8_t dstEid,
+                           uint8_t msgTag, bool tagOwner,
+                           const std::vector<uint8_t>& request)
+{
+    DataSocketHeader header{};
+    header.op = dataSocketSend;
+    header.eid = dstEid;
+    header.msgTag = msgTag;
+    header.tagOwner = tagOwner ? 1 : 0;
+
+    std::vector<uint8_t> response;
+    boost::system::error_code ec;
+    auto reply = transact(yield, header, request, replyGuardTime, response, ec);
+    if (!reply)
+    {
+        return std::nullopt;
+    }
+    return std::make_pair(ec, ec ? -1 : reply->status);
+}
+
+} // namespace internal
+} // namespace mctpw
@@ -0,0 +1,122 @@
+/*
+// Copyright (c) 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+
+#include <boost/asio/generic/seq_packet_protocol.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mctpw
+{
+namespace internal
+{
+
+/// Packet header of the mctpd data socket, must match mctpd DataSocketHeader
+struct DataSocketHeader
+{
+    uint32_t id;
+    uint8_t op;
+    uint8_t eid;
+    uint8_t msgTag;
+    uint8_t tagOwner;
+    uint16_t timeout;
+    int16_t status;
+} __attribute__((packed));
+
+/**
+ * @brief Client side of the local SEQPACKET socket mctpd offers next to the
+ * SendMctpMessagePayload and SendReceiveMctpMessagePayload D-Bus methods.
+ * Requests from several coroutines are multiplexed on one connection and
+ * matched to their replies by id.
+ */
+class DataSocketClient : public std::enable_shared_from_this<DataSocketClient>
+{
+  public:
+    DataSocketClient(boost::asio::io_context& ioc, const std::string& name);
+    ~DataSocketClient();
+
+    /**
+     * @brief Start reading replies. Throws if the socket can't be connected
+     */
+    void connect();
+
+    /**
+     * @brief Send a request and wait for the response message
+     *
+     * @return Error code and response, or std::nullopt if the request could
+     * not be sent and has to go over D-Bus instead
+     */
+    std::optional<std::pair<boost::system::error_code, std::vector<uint8_t>>>
+        sendReceive(boost::asio::yield_context yield, uint8_t dstEid,
+                    const std::vector<uint8_t>& request,
+                    std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Send a message without waiting for a response
+     *
+     * @return Error code and status returned by mctpd, or std::nullopt if
+     * the request could not be sent and has to go over D-Bus instead
+     */
+    std::optional<std::pair<boost::system::error_code, int>>
+        send(boost::asio::yield_context yield, uint8_t dstEid, uint8_t msgTag,
+             bool tagOwner, const std::vector<uint8_t>& request);
+
+    void close();
+
+    bool isConnected() const
+    {
+        return connected;
+    }
+
+  private:
+    using Protocol = boost::asio::generic::seq_packet_protocol;
+
+    struct PendingRequest
+    {
+        explicit PendingRequest(boost::asio::io_context& ioc) : timer(ioc)
+        {
+        }
+        boost::asio::steady_timer timer;
+        std::optional<DataSocketHeader> reply{};
+        std::vector<uint8_t> response{};
+    };
+
+    std::optional<DataSocketHeader> transact(
+        boost::asio::yield_context yield, DataSocketHeader header,
+        const std::vector<uint8_t>& request, std::chrono::milliseconds wait,
+        std::vector<uint8_t>& response, boost::system::error_code& transportEc);
+    void receiveReplies(boost::asio::yield_context yield);
+
+    boost::asio::io_context& io;
+    std::string socketName;
+    Protocol::socket socket;
+    bool connected = false;
+    uint32_t nextId = 0;
+    std::unordered_map<uint32_t, std::shared_ptr<PendingRequest>> pending;
+};
+
+} // namespace internal
+} // namespace mctpw
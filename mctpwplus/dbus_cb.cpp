@@ -223,6 +223,9 @@ int onMessageReceivedSignal(sd_bus_message* rawMsg, void* userData,
             return -1;
         }
 
+        // Signals addressed to this connection are checked as well, since the
+        // MCTP service sends one copy per connection and other clients on the
+        // same connection may have registered other vendor fields
         if (static_cast<MessageType>(messageType) == MessageType::vdpci)
         {
             struct VendorHeader
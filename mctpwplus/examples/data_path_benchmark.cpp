@@ -0,0 +1,104 @@
+/*
+// Copyright (c) 2021 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "mctp_wrapper.hpp"
+
+#include <boost/asio.hpp>
+#include <boost/asio/spawn.hpp>
+#include <chrono>
+#include <iostream>
+
+// Compares round trip latency and throughput of SendReceive requests sent
+// through D-Bus and through the mctpd data socket. Usage:
+//   mctp_data_path_benchmark [eid] [requests] [concurrency]
+int main(int argc, char* argv[])
+{
+    constexpr uint8_t defaultEId = 8;
+    uint8_t eid =
+        argc < 2 ? defaultEId : static_cast<uint8_t>(std::stoi(argv[1]));
+    unsigned requests =
+        argc < 3 ? 1000 : static_cast<unsigned>(std::stoul(argv[2]));
+    unsigned concurrency =
+        argc < 4 ? 4 : static_cast<unsigned>(std::stoul(argv[3]));
+    using namespace mctpw;
+    boost::asio::io_context io;
+
+    MCTPConfiguration config(mctpw::MessageType::pldm,
+                             mctpw::BindingType::mctpOverSmBus);
+    MCTPConfiguration dbusConfig = config;
+    dbusConfig.useDataSocket = false;
+    MCTPWrapper socketWrapper(io, config, nullptr, nullptr);
+    MCTPWrapper dbusWrapper(io, dbusConfig, nullptr, nullptr);
+
+    // PLDM GetTID
+    const std::vector<uint8_t> request = {1, 0x80, 0, 2};
+    const auto timeout = std::chrono::milliseconds(100);
+
+    auto run = [&](boost::asio::yield_context yield, MCTPWrapper& wrapper,
+                   const char* name) {
+        wrapper.detectMctpEndpoints(yield);
+        // Warm up, also opens the data socket
+        wrapper.sendReceiveYield(yield, eid, request, timeout);
+
+        unsigned issued = 0;
+        unsigned failed = 0;
+        unsigned running = concurrency;
+        std::chrono::nanoseconds totalLatency{0};
+        boost::asio::steady_timer done(
+            io, boost::asio::steady_timer::time_point::max());
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned worker = 0; worker < concurrency; worker++)
+        {
+            boost::asio::spawn(io, [&](boost::asio::yield_context yieldWorker) {
+                while (issued < requests)
+                {
+                    issued++;
+                    auto sent = std::chrono::steady_clock::now();
+                    auto [ec, response] = wrapper.sendReceiveYield(
+                        yieldWorker, eid, request, timeout);
+                    totalLatency += std::chrono::steady_clock::now() - sent;
+                    if (ec || response.empty())
+                    {
+                        failed++;
+                    }
+                }
+                if (--running == 0)
+                {
+                    done.cancel();
+                }
+            });
+        }
+        boost::system::error_code ec;
+        done.async_wait(yield[ec]);
+
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        std::chrono::duration<double, std::micro> latency =
+            totalLatency / requests;
+        std::cout << name << ": " << requests << " requests, " << failed
+                  << " failed, " << latency.count() << " us average latency, "
+                  << requests / elapsed.count() << " msgs/s\n";
+    };
+
+    boost::asio::spawn(io, [&](boost::asio::yield_context yield) {
+        run(yield, dbusWrapper, "D-Bus");
+        run(yield, socketWrapper, "Data socket");
+        io.stop();
+    });
+
+    io.run();
+    return 0;
+}
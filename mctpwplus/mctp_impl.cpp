@@ -189,6 +189,16 @@ void MCTPImpl::unRegisterListeners(const std::string& serviceName)
     if (itr != matchers.end())
     {
         matchers.erase(itr);
+        // The client keeps itself alive while it waits for replies
+        if (auto dataSocket = dataSockets.find(serviceName);
+            dataSocket != dataSockets.end())
+        {
+            if (dataSocket->second)
+            {
+                dataSocket->second->close();
+            }
+            dataSockets.erase(dataSocket);
+        }
         phosphor::logging::log<phosphor::logging::level::INFO>(
             (std::string("unRegisterListeners: ") + serviceName).c_str());
     }
@@ -226,6 +236,36 @@ void MCTPImpl::registerListeners(const std::string& serviceName)
         ""));
     // Saving all matchers using key as servicename
     matchers.emplace(serviceName, std::move(signalMatchers));
+    registerMessageSubscriber(serviceName);
+}
+
+void MCTPImpl::registerMessageSubscriber(const std::string& serviceName)
+{
+    if (!receiveCallback)
+    {
+        return;
+    }
+
+    uint16_t vendorId = config.vendorId ? be16toh(*config.vendorId) : 0;
+    uint16_t vendorMsgTypeMask =
+        config.vendorMessageType ? be16toh(config.vendorMessageType->mask)
+                                 : 0;
+    // Same rule as onMessageReceivedSignal applies to broadcast messages:
+    // every bit of the mask has to be set in the vendor message type
+    connection->async_method_call(
+        [serviceName](boost::system::error_code ec, bool registered) {
+            if (ec || !registered)
+            {
+                phosphor::logging::log<phosphor::logging::level::INFO>(
+                    ("RegisterMessageSubscriber: not registered with " +
+                     serviceName + ", using broadcast messages")
+                        .c_str());
+            }
+        },
+        serviceName, "/xyz/openbmc_project/mctp",
+        "xyz.openbmc_project.MCTP.Base", "RegisterMessageSubscriber",
+        static_cast<uint8_t>(config.type), vendorId, vendorMsgTypeMask,
+        vendorMsgTypeMask);
 }
 
 boost::system::error_code
@@ -362,6 +402,12 @@ MCTPImpl::EndpointMap MCTPImpl::buildMatchingEndpointMap(
     std::unordered_map<uint8_t, std::pair<unsigned, std::string>> eids;
     for (auto& bus : buses)
     {
+        if (readMatchingEndpoints(yield, bus, eids))
+        {
+            continue;
+        }
+
+        // MCTP services without GetEndpoints
         boost::system::error_code ec;
         DictType<sdbusplus::message::object_path,
                  DictType<std::string,
@@ -523,6 +569,14 @@ std::pair<boost::system::error_code, ByteArray>
             boost::system::errc::make_error_code(boost::system::errc::io_error);
         return receiveResult;
     }
+    if (auto dataSocket = getDataSocket(yield, it->second.second))
+    {
+        if (auto result =
+                dataSocket->sendReceive(yield, dstEId, request, timeout))
+        {
+            return std::move(result).value();
+        }
+    }
     receiveResult.second = connection->yield_method_call<ByteArray>(
         yield, receiveResult.first, it->second.second,
         "/xyz/openbmc_project/mctp", "xyz.openbmc_project.MCTP.Base",
@@ -573,6 +627,15 @@ std::pair<boost::system::error_code, int>
             -1);
     }
 
+    if (auto dataSocket = getDataSocket(yield, it->second.second))
+    {
+        if (auto result =
+                dataSocket->send(yield, dstEId, msgTag, tagOwner, request))
+        {
+            return result.value();
+        }
+    }
+
     boost::system::error_code ec =
         boost::system::errc::make_error_code(boost::system::errc::success);
     int status = connection->yield_method_call<int>(
@@ -583,12 +646,201 @@ std::pair<boost::system::error_code, int>
     return std::make_pair(ec, status);
 }
 
+std::shared_ptr<internal::DataSocketClient>
+    MCTPImpl::getDataSocket(boost::asio::yield_context yield,
+                            const std::string& serviceName)
+{
+    if (!config.useDataSocket)
+    {
+        return nullptr;
+    }
+    auto it = dataSockets.find(serviceName);
+    if (it != dataSockets.end())
+    {
+        // A socket that failed is dropped and looked up again, the service
+        // may have been restarted
+        if (!it->second || it->second->isConnected())
+        {
+            return it->second;
+        }
+        dataSockets.erase(it);
+    }
+
+    boost::system::error_code ec;
+    auto socketName = connection->yield_method_call<std::variant<std::string>>(
+        yield, ec, serviceName, "/xyz/openbmc_project/mctp",
+        "org.freedesktop.DBus.Properties", "Get",
+        "xyz.openbmc_project.MCTP.Base", "DataSocket");
+
+    // Another caller may have looked the socket up meanwhile. Its client is
+    // used, a second one would never be closed.
+    it = dataSockets.find(serviceName);
+    if (it != dataSockets.end() && (!it->second || it->second->isConnected()))
+    {
+        return it->second;
+    }
+
+    std::shared_ptr<internal::DataSocketClient> dataSocket;
+    auto name = std::get_if<std::string>(&socketName);
+    if (!ec && name && !name->empty())
+    {
+        try
+        {
+            dataSocket = std::make_shared<internal::DataSocketClient>(
+                connection->get_io_context(), *name);
+            dataSocket->connect();
+        }
+        catch (const std::exception& e)
+        {
+            phosphor::logging::log<phosphor::logging::level::WARNING>(
+                ("Data socket of " + serviceName + ": " + e.what()).c_str());
+            dataSocket = nullptr;
+        }
+    }
+    dataSockets.insert_or_assign(serviceName, dataSocket);
+    return dataSocket;
+}
+
+bool MCTPImpl::isMatchingEndpoint(const EndpointEntry& endpoint) const
+{
+    if (mctpw::MessageType::vdpci != config.type)
+    {
+        return true;
+    }
+    if (!config.vendorId)
+    {
+        if (config.vendorMessageType)
+        {
+            phosphor::logging::log<phosphor::logging::level::ERR>(
+                "Vendor Message Type matching is not allowed "
+                "when Vendor ID is not set");
+            return false;
+        }
+        return true;
+    }
+    try
+    {
+        const std::string& vendorIdStr = std::get<5>(endpoint);
+        if (static_cast<uint16_t>(std::stoi(vendorIdStr, nullptr, 16)) !=
+            be16toh(*config.vendorId))
+        {
+            return false;
+        }
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+    const auto& vendorMsgTypes = std::get<6>(endpoint);
+    return !config.vendorMessageType ||
+           std::find(vendorMsgTypes.begin(), vendorMsgTypes.end(),
+                     be16toh(config.vendorMessageType->value)) !=
+               vendorMsgTypes.end();
+}
+
+bool MCTPImpl::readMatchingEndpoints(
+    boost::asio::yield_context yield,
+    const std::pair<unsigned, std::string>& bus, EndpointMap& eids)
+{
+    boost::system::error_code ec;
+    auto [generation, endpoints] =
+        connection->yield_method_call<uint64_t, std::vector<EndpointEntry>>(
+            yield, ec, bus.second.c_str(), "/xyz/openbmc_project/mctp",
+            "xyz.openbmc_project.MCTP.Base", "GetEndpoints",
+            static_cast<uint8_t>(config.type));
+    if (ec)
+    {
+        phosphor::logging::log<phosphor::logging::level::DEBUG>(
+            ("GetEndpoints failed on " + bus.second).c_str());
+        return false;
+    }
+
+    for (const auto& endpoint : endpoints)
+    {
+        if (isMatchingEndpoint(endpoint))
+        {
+            eids[std::get<0>(endpoint)] = bus;
+        }
+    }
+    endpointGenerations.insert_or_assign(bus.second, generation);
+    return true;
+}
+
+bool MCTPImpl::updateMatchingEndpoints(
+    boost::asio::yield_context yield,
+    const std::pair<unsigned, std::string>& bus)
+{
+    auto lastGeneration = endpointGenerations.find(bus.second);
+    if (lastGeneration == endpointGenerations.end())
+    {
+        return false;
+    }
+
+    boost::system::error_code ec;
+    auto [generation, complete, changed, removed] =
+        connection->yield_method_call<uint64_t, bool,
+                                      std::vector<EndpointEntry>,
+                                      std::vector<uint8_t>>(
+            yield, ec, bus.second.c_str(), "/xyz/openbmc_project/mctp",
+            "xyz.openbmc_project.MCTP.Base", "GetEndpointsSince",
+            lastGeneration->second, static_cast<uint8_t>(config.type));
+    if (ec)
+    {
+        phosphor::logging::log<phosphor::logging::level::DEBUG>(
+            ("GetEndpointsSince failed on " + bus.second).c_str());
+        return false;
+    }
+
+    auto fromService = [&bus](const auto& entry) {
+        return entry.second.second == bus.second;
+    };
+    if (complete)
+    {
+        // The service restarted, the endpoints returned are all it has
+        for (auto entry = endpointMap.begin(); entry != endpointMap.end();)
+        {
+            entry = fromService(*entry) ? endpointMap.erase(entry) : ++entry;
+        }
+    }
+    for (uint8_t eid : removed)
+    {
+        auto entry = endpointMap.find(eid);
+        if (entry != endpointMap.end() && fromService(*entry))
+        {
+            endpointMap.erase(entry);
+        }
+    }
+    for (const auto& endpoint : changed)
+    {
+        if (isMatchingEndpoint(endpoint))
+        {
+            endpointMap.insert_or_assign(std::get<0>(endpoint), bus);
+        }
+        else
+        {
+            auto entry = endpointMap.find(std::get<0>(endpoint));
+            if (entry != endpointMap.end() && fromService(*entry))
+            {
+                endpointMap.erase(entry);
+            }
+        }
+    }
+    endpointGenerations.insert_or_assign(bus.second, generation);
+    return true;
+}
+
 void MCTPImpl::addToEidMap(boost::asio::yield_context yield,
                            const std::string& serviceName)
 {
     int busID = getBusId(serviceName);
     std::vector<std::pair<unsigned, std::string>> buses;
     buses.emplace_back(busID, serviceName);
+    // Only what changed since the endpoints were last read, if the service
+    // can tell
+    if (updateMatchingEndpoints(yield, buses.front()))
+    {
+        return;
+    }
     auto eidMap = buildMatchingEndpointMap(yield, buses);
     this->endpointMap.insert(eidMap.begin(), eidMap.end());
 }
@@ -15,6 +15,7 @@
 */
 #pragma once
 
+#include "data_socket.hpp"
 #include "mctp_wrapper.hpp"
 
 #include <boost/asio.hpp>
@@ -26,6 +27,7 @@
 #include <sdbusplus/asio/connection.hpp>
 #include <sdbusplus/bus/match.hpp>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <vector>
 
@@ -232,6 +234,16 @@ class MCTPImpl
                        std::unique_ptr<sdbusplus::bus::match::match>>
         monitorServiceMatchers;
     EndpointMap endpointMap;
+    /* <EID, UUID, mode, network ID, message types, VDPCI vendor ID, VDPCI
+     * vendor message types> as returned by GetEndpoints */
+    using EndpointEntry =
+        std::tuple<uint8_t, std::string, std::string, uint16_t,
+                   std::vector<uint8_t>, std::string, std::vector<uint16_t>>;
+    /* Generation of the endpoints last read from each MCTP service */
+    std::unordered_map<std::string, uint64_t> endpointGenerations;
+    /* Data socket per MCTP service, nullptr if the service has none */
+    std::unordered_map<std::string, std::shared_ptr<internal::DataSocketClient>>
+        dataSockets;
     // Get list of pair<bus, service_name_string> which expose mctp object
     std::optional<std::vector<std::pair<unsigned, std::string>>>
         findBusByBindingType(boost::asio::yield_context yield);
@@ -239,6 +251,16 @@ class MCTPImpl
     EndpointMap buildMatchingEndpointMap(
         boost::asio::yield_context yield,
         std::vector<std::pair<unsigned, std::string>>& buses);
+    // Reads the matching endpoints of an MCTP service in one call. Returns
+    // false if the service has no GetEndpoints method.
+    bool readMatchingEndpoints(boost::asio::yield_context yield,
+                               const std::pair<unsigned, std::string>& bus,
+                               EndpointMap& eids);
+    // Applies the endpoints added and removed since the last read. Returns
+    // false if the service has no GetEndpointsSince method.
+    bool updateMatchingEndpoints(boost::asio::yield_context yield,
+                                 const std::pair<unsigned, std::string>& bus);
+    bool isMatchingEndpoint(const EndpointEntry& endpoint) const;
     // Get bus id from servicename. Example: Returns 2 if device path is
     // /dev/i2c-2
     int getBusId(const std::string& serviceName);
@@ -246,6 +268,11 @@ class MCTPImpl
     void listenForRemovedMctpServices();
     void registerListeners(const std::string& serviceName);
     void unRegisterListeners(const std::string& serviceName);
+    // Ask the MCTP service to send matching messages to this connection only
+    void registerMessageSubscriber(const std::string& serviceName);
+    std::shared_ptr<internal::DataSocketClient>
+        getDataSocket(boost::asio::yield_context yield,
+                      const std::string& serviceName);
     friend struct internal::NewServiceCallback;
     friend struct internal::DeleteServiceCallback;
 };
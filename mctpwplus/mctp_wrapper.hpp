@@ -128,6 +128,9 @@ struct MCTPConfiguration
     /// Vendor Id
     std::optional<uint16_t> vendorId = std::nullopt;
     std::optional<VendorMessageType> vendorMessageType = std::nullopt;
+    /// Send messages through the data socket of the MCTP service if it has
+    /// one. D-Bus method calls are used otherwise.
+    bool useDataSocket = true;
 
     /**
      * @brief Set vendor id. Input values are expected to be in CPU byte order
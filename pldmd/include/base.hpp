@@ -16,8 +16,10 @@
 
 #pragma once
 
+#include <array>
 #include <boost/asio/spawn.hpp>
 #include <functional>
+#include <optional>
 
 #include "base.h"
 
@@ -82,5 +84,13 @@ bool isSupported(pldm_tid_t tid, const uint8_t type, const uint8_t cmd);
  */
 bool isSupported(pldm_tid_t tid, const uint8_t type);
 
+/**
+ * @brief Get the UUID reported by a terminus through GetTerminusUID
+ *
+ * @param tid PLDM TID of device
+ * @return UUID of the terminus if it supports GetTerminusUID
+ */
+std::optional<std::array<uint8_t, 16>> getTerminusUUID(const pldm_tid_t tid);
+
 } // namespace base
 } // namespace pldm
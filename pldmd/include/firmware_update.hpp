@@ -60,11 +60,6 @@ class FWUpdate
     int requestUpdate(const boost::asio::yield_context yield,
                       struct variable_field& compImgSetVerStrn);
     int processGetDeviceMetaData(const boost::asio::yield_context yield);
-    int getDeviceMetaData(const boost::asio::yield_context yield,
-                          const uint32_t dataTransferHandle,
-                          const uint8_t transferOperationFlag,
-                          uint32_t& nextDataTransferHandle,
-                          uint8_t& transferFlag);
     int processSendPackageData(const boost::asio::yield_context yield);
     int sendPackageData(const boost::asio::yield_context yield, size_t& offset,
                         size_t& length, std::set<uint32_t>& recvdRequests);
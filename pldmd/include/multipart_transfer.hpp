@@ -0,0 +1,120 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "pldm.hpp"
+
+#include <boost/asio/spawn.hpp>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "base.h"
+
+namespace pldm
+{
+
+/** @brief Limits applied to a multipart transfer */
+struct MultipartTransferLimits
+{
+    /** @brief Length of the transferred data if known upfront, for example
+     * from FRU metadata. Used to preallocate the receive buffer.
+     */
+    size_t expectedLength = 0;
+    /** @brief Transfer fails once more data than this is received */
+    size_t maxLength = 0;
+    /** @brief Transfer fails once more parts than this are needed */
+    size_t maxParts = 0;
+};
+
+/** @brief Requester side of the PLDM multipart receive protocol
+ *
+ * Drives GetFirstPart/GetNextPart requests of commands like GetPDR,
+ * GetFRURecordTable, GetVersion and GetDeviceMetaData. The command specific
+ * encoder builds the request for a part and the decoder appends the part data
+ * straight to the receive buffer, so no intermediate copies are made. Each
+ * request carries the data transfer handle returned by the previous response,
+ * thus parts are requested one after another.
+ */
+class MultipartTransfer
+{
+  public:
+    /** @brief Encode the request for a part
+     *
+     * @param instanceID[in] - Instance ID to be used in the request
+     * @param dataTransferHandle[in] - Handle of the part to be requested
+     * @param transferOpFlag[in] - PLDM_GET_FIRSTPART or PLDM_GET_NEXTPART
+     * @param msg[out] - Request message
+     *
+     * @return libpldm encode return code
+     */
+    using EncodeRequest = std::function<int(
+        const uint8_t instanceID, const uint32_t dataTransferHandle,
+        const uint8_t transferOpFlag, pldm_msg* msg)>;
+
+    /** @brief Decode the response for a part
+     *
+     * @param resp[in] - Response message including the PLDM header
+     * @param nextDataTransferHandle[out] - Handle of the next part
+     * @param transferFlag[out] - Transfer flag of the part
+     * @param buffer[in/out] - Receive buffer the part data is appended to
+     *
+     * @return true if the response is valid
+     */
+    using DecodeResponse = std::function<bool(
+        std::vector<uint8_t>& resp, uint32_t& nextDataTransferHandle,
+        uint8_t& transferFlag, std::vector<uint8_t>& buffer)>;
+
+    MultipartTransfer(const pldm_tid_t tidVal, const std::string& commandName,
+                      const size_t reqPayloadLen,
+                      const MultipartTransferLimits& transferLimits,
+                      const uint16_t timeoutVal, const size_t retryCountVal,
+                      std::optional<mctpw_eid_t> eidVal = std::nullopt);
+
+    /** @brief Run the transfer
+     *
+     * @param yield[in] - Context object that represents the currently
+     * executing coroutine
+     * @param encodeReq[in] - Command specific request encoder
+     * @param decodeResp[in] - Command specific response decoder
+     * @param buffer[out] - Received data. Partial data on failure
+     *
+     * @return true if the transfer completed within the limits
+     */
+    bool receive(boost::asio::yield_context yield,
+                 const EncodeRequest& encodeReq,
+                 const DecodeResponse& decodeResp,
+                 std::vector<uint8_t>& buffer);
+
+    /** @brief Get the number of parts received by the last transfer */
+    size_t getPartCount() const
+    {
+        return partCount;
+    }
+
+  private:
+    pldm_tid_t tid;
+    std::string command;
+    size_t requestPayloadLen;
+    MultipartTransferLimits limits;
+    uint16_t timeout;
+    size_t retryCount;
+    std::optional<mctpw_eid_t> eid;
+    size_t partCount = 0;
+};
+
+} // namespace pldm
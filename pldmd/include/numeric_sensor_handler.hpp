@@ -54,6 +54,12 @@ class NumericSensorHandler
         return sensorDisabled;
     }
 
+    /** @brief Sensor update interval in seconds as advertised by the PDR*/
+    float getUpdateInterval() const
+    {
+        return _pdr->update_interval;
+    }
+
     /** @brief Check if sensor error threshold crossed*/
     bool sensorErrorCheck();
 
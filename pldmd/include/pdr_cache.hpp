@@ -0,0 +1,73 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <array>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "platform.h"
+
+namespace pldm
+{
+namespace platform
+{
+
+using UUID = std::array<uint8_t, 16>;
+using DevicePDRs = std::unordered_map<uint32_t /*RecordHandle*/,
+                                      std::vector<uint8_t> /*PDR data*/>;
+
+/** @brief Persistent cache of terminus PDR repositories
+ *
+ * PDR repository of a terminus is stored under /var/lib/pldm/pdr in a file
+ * named after the terminus UUID. A cached repository is used only if the
+ * record count, repository size and update timestamps reported through
+ * GetPDRRepositoryInfo are unchanged. Otherwise the cache file is discarded.
+ */
+namespace pdr_cache
+{
+
+/** @brief Load PDRs cached for a terminus
+ *
+ * @param uuid[in] - UUID of the terminus
+ * @param pdrRepoInfo[in] - PDR repository info reported by the terminus
+ *
+ * @return Cached PDRs if the cache is present and up to date
+ */
+std::optional<DevicePDRs> load(const UUID& uuid,
+                               const pldm_pdr_repository_info& pdrRepoInfo);
+
+/** @brief Store PDRs of a terminus to the cache
+ *
+ * @param uuid[in] - UUID of the terminus
+ * @param pdrRepoInfo[in] - PDR repository info reported by the terminus
+ * @param devicePDRs[in] - PDRs fetched from the terminus
+ *
+ * @return Status of the operation
+ */
+bool store(const UUID& uuid, const pldm_pdr_repository_info& pdrRepoInfo,
+           const DevicePDRs& devicePDRs);
+
+/** @brief Discard PDRs cached for a terminus
+ *
+ * @param uuid[in] - UUID of the terminus
+ */
+void remove(const UUID& uuid);
+
+} // namespace pdr_cache
+} // namespace platform
+} // namespace pldm
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "pdr_cache.hpp"
 #include "pldm.hpp"
 
 #include <boost/asio.hpp>
@@ -153,6 +154,9 @@ class PDRManager
     /** @brief fetch PDRs from terminus and add to BMC PDR repo*/
     bool constructPDRRepo(boost::asio::yield_context yield);
 
+    /** @brief Add PDRs cached for the terminus UUID to BMC PDR repo*/
+    bool restorePDRRepoFromCache(const UUID& uuid);
+
     /** @brief Parse the Auxiliary Names PDR */
     void parseEntityAuxNamesPDR(std::vector<uint8_t>& pdrData);
 
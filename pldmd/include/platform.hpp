@@ -19,6 +19,7 @@
 #include "pldm.hpp"
 
 #include <boost/asio/steady_timer.hpp>
+#include <chrono>
 
 #include "platform.h"
 
@@ -30,23 +31,72 @@ namespace platform
 constexpr uint16_t commandTimeout = 100;
 constexpr size_t commandRetryCount = 3;
 
-using UUID = std::array<uint8_t, 16>;
-
 std::optional<UUID>
     getTerminusUID(boost::asio::yield_context yield, const pldm_tid_t tid,
                    std::optional<mctpw_eid_t> eid = std::nullopt);
 
+using PollClock = std::chrono::steady_clock;
+
+/** @brief Reasons for which sensor polling can be paused
+ *
+ * Pause requests are counted per reason, polling resumes only once every
+ * pause request is matched by a resume request.
+ */
+enum class PollPauseReason : uint8_t
+{
+    deviceInit,
+    deviceRemoval,
+    firmwareUpdate,
+    pdrRefresh,
+    dbusRequest,
+    shutdown
+};
+
+/** @brief Sensor tracked by the sensor poll scheduler*/
+struct SensorPollTask
+{
+    /** @brief Time at which the sensor is due to be read*/
+    PollClock::time_point deadline;
+
+    /** @brief Time between two consecutive readings*/
+    std::chrono::milliseconds interval;
+
+    /** @brief Terminus which owns the sensor*/
+    std::shared_ptr<PlatformTerminus> terminus;
+
+    SensorID sensorID;
+    bool isStateSensor;
+};
+
 class Platform
 {
   public:
-    void stopSensorPolling();
-    void startSensorPolling();
+    void stopSensorPolling(const PollPauseReason reason);
+    void startSensorPolling(const PollPauseReason reason);
+    size_t getPauseDepth() const
+    {
+        return pauseDepth;
+    }
     bool initTerminus(boost::asio::yield_context yield, const pldm_tid_t tid,
                       const pldm::base::CommandSupportTable& commandTable);
     bool deleteTerminus(const pldm_tid_t tid);
 
   private:
-    bool induceAsyncDelay(boost::asio::yield_context yield, int delay);
+    void waitForResume(boost::asio::yield_context yield);
+    void updatePauseProperties();
+    bool waitForDeadline(boost::asio::yield_context yield,
+                         boost::asio::steady_timer& timer,
+                         const PollClock::time_point deadline);
+    void waitForBusPollers(boost::asio::yield_context yield);
+    bool pollSensor(boost::asio::yield_context yield,
+                    const SensorPollTask& task);
+    void pollTerminusSensors(boost::asio::yield_context yield,
+                             const std::vector<SensorPollTask>& batch,
+                             std::vector<bool>& activeSensors);
+    void pollBusSensors(boost::asio::yield_context yield,
+                        boost::asio::steady_timer& timer,
+                        std::vector<SensorPollTask> tasks);
+    void spawnBusPoller(std::vector<SensorPollTask> tasks);
     void doPoll(boost::asio::yield_context yield);
     void pollAllSensors();
     void initializeSensorPollIntf();
@@ -56,19 +106,55 @@ class Platform
 
     std::map<pldm_tid_t, std::shared_ptr<PlatformTerminus>> platforms{};
     std::unique_ptr<boost::asio::steady_timer> sensorTimer = nullptr;
+    std::vector<std::shared_ptr<boost::asio::steady_timer>> busPollTimers{};
+    size_t activeBusPollers = 0;
     bool isSensorPollRunning = false;
-    bool startSensorPoll = false;
     bool stopSensorPoll = false;
+    size_t pauseDepth = 0;
+    std::map<PollPauseReason, size_t> pauseReasons{};
+    std::unique_ptr<sdbusplus::asio::dbus_interface> pausePollInterface =
+        nullptr;
     std::set<pldm_tid_t> tidsUnderInitialization{};
 };
 
 /** @brief Pause sensor polling
  *
  *  Caller should resume the sensor polling manually using resumeSensorPolling()
+ *  with the same reason. Pause requests can be nested.
+ *
+ *  @param reason - Reason for pausing the sensor polling
+ */
+void pauseSensorPolling(const PollPauseReason reason);
+
+/** @brief Resume sensor polling if it is paused
+ *
+ *  Polling resumes only when no other pause request is pending
+ *
+ *  @param reason - Reason passed to the matching pauseSensorPolling()
+ */
+void resumeSensorPolling(const PollPauseReason reason);
+
+/** @brief Pauses sensor polling for as long as it exists
+ *
+ *  Polling is resumed even if the code it guards throws
  */
-void pauseSensorPolling();
+class SensorPollingPause
+{
+  public:
+    explicit SensorPollingPause(const PollPauseReason reasonIn) :
+        reason(reasonIn)
+    {
+        pauseSensorPolling(reason);
+    }
+    ~SensorPollingPause()
+    {
+        resumeSensorPolling(reason);
+    }
+    SensorPollingPause(const SensorPollingPause&) = delete;
+    SensorPollingPause& operator=(const SensorPollingPause&) = delete;
 
-/** @brief Resume sensor polling if it is paused*/
-void resumeSensorPolling();
+  private:
+    PollPauseReason reason;
+};
 } // namespace platform
 } // namespace pldm
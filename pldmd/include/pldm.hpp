@@ -17,6 +17,7 @@
 
 #include "base.hpp"
 #include "mctp_wrapper.hpp"
+#include "transfer_size.hpp"
 
 #include <boost/asio.hpp>
 #include <boost/asio/error.hpp>
@@ -54,6 +55,13 @@ constexpr size_t maxPLDMMessageLen = 64 /*Maximum MCTP packet payload len*/ -
                                      1 /*MCTP messageType size*/ -
                                      pldmMsgHdrSize;
 
+/** @brief Upper bound of a PLDM message per binding medium. MCTP messages
+ * larger than a packet are split and reassembled by libmctp, so multipart
+ * transfers can ask for parts much larger than maxPLDMMessageLen.
+ */
+constexpr size_t maxSMBusPLDMMessageLen = 512 - 1 - pldmMsgHdrSize;
+constexpr size_t maxPCIePLDMMessageLen = 4096 - 1 - pldmMsgHdrSize;
+
 /** @brief pldm_empty_request
  *
  * structure representing PLDM empty request.
@@ -97,6 +105,51 @@ extern TIDMapper tidMapper;
  */
 uint8_t createInstanceId(pldm_tid_t tid);
 
+/** @brief Get the physical bus of a PLDM terminus
+ *
+ * Termini reachable through the same bus share the same mux, thus traffic to
+ * them has to be serialized. Termini on different buses can be accessed
+ * concurrently.
+ *
+ * @param tid - TID of the PLDM device
+ *
+ * @return Bus ID if the TID is mapped to a discovered MCTP endpoint
+ */
+std::optional<unsigned> getTerminusBus(const pldm_tid_t tid);
+
+/** @brief Get the negotiated maximum PLDM message length of a terminus
+ *
+ * Starts at the limit of the binding medium and is lowered by
+ * reduceMaxTransferSize if the terminus rejects parts of that size.
+ *
+ * @param tid - TID of the PLDM device
+ *
+ * @return Maximum PLDM message length excluding the PLDM header
+ */
+size_t getMaxTransferSize(const pldm_tid_t tid);
+
+/** @brief Lower the maximum PLDM message length of a terminus
+ *
+ * Used to probe the transfer size a terminus can handle. A failure caused by
+ * the part size halves the length. A part without a response is retried at
+ * maxPLDMMessageLen, which fits in a single MCTP packet, and that length is
+ * kept only if confirmMaxTransferSize reports the retry succeeded. The
+ * length never drops below maxPLDMMessageLen.
+ *
+ * @param tid - TID of the PLDM device
+ * @param failure - Why the first part of the transfer failed
+ *
+ * @return true if the first part is worth retrying at the reduced length
+ */
+bool reduceMaxTransferSize(const pldm_tid_t tid, const PartFailure failure);
+
+/** @brief Keep or undo a length reduced after a part without a response
+ *
+ * @param tid - TID of the PLDM device
+ * @param succeeded - Whether the first part of the retried transfer succeeded
+ */
+void confirmMaxTransferSize(const pldm_tid_t tid, const bool succeeded);
+
 /** @brief Trigger device discovery scan
  *
  * PLDM terminus can go for reset after certain operations like PLDM firmware
@@ -83,8 +83,13 @@ class StateSensorHandler
     /** @brief Handle sensor reading*/
     bool handleSensorReading(get_sensor_state_field& stateReading);
 
+    /** @brief Update state of a composite sensor instance other than first*/
+    void updateCompositeState(const size_t compositeIndex,
+                              const get_sensor_state_field& stateReading);
+
     /** @brief Log redfish event for sensor state change*/
-    void logStateChangeEvent(const uint8_t currentState,
+    void logStateChangeEvent(const size_t compositeIndex,
+                             const uint8_t currentState,
                              const uint8_t previousState);
 
     /** @brief Terminus ID*/
@@ -117,6 +122,19 @@ class StateSensorHandler
     bool operationalIntfReady = false;
     bool interfaceInitialized = false;
 
+    /** @brief Interface and cached readings of a composite sensor instance*/
+    struct CompositeSensorState
+    {
+        std::unique_ptr<sdbusplus::asio::dbus_interface> sensorInterface =
+            nullptr;
+        uint8_t previousStateReading = PLDM_INVALID_VALUE;
+        uint8_t currentStateReading = PLDM_INVALID_VALUE;
+    };
+
+    /** @brief Composite sensor instances except the first one, which is
+     * exposed through sensorInterface*/
+    std::vector<CompositeSensorState> compositeStates;
+
     /** @brief Sensor Interfaces*/
     std::unique_ptr<sdbusplus::asio::dbus_interface> sensorInterface = nullptr;
     std::unique_ptr<sdbusplus::asio::dbus_interface> availableInterface =
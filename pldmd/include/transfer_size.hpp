@@ -0,0 +1,103 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+#include "base.h"
+
+namespace pldm
+{
+
+/** @brief Why the first part of a multipart transfer failed */
+enum class PartFailure
+{
+    /** @brief No response, for example a send failure or a timeout */
+    noResponse,
+    /** @brief Response rejected for a reason unrelated to the part size */
+    invalidResponse,
+    /** @brief Length completion code or truncated response */
+    partSize
+};
+
+/** @brief Tell if a decoded response points at the requested part size
+ *
+ * @param rc - Return code of the libpldm decoder
+ * @param completionCode - Completion code of the response
+ *
+ * @return true if the terminus rejected or truncated the part
+ */
+bool isPartSizeError(const int rc, const uint8_t completionCode);
+
+/** @brief Per terminus maximum PLDM message length
+ *
+ * Every terminus starts at the limit of the binding medium, passed in as
+ * initialSize. The limit is halved, down to a floor, when a part fails
+ * because of its size. A part without a response is retried once at the
+ * floor, which is kept only if confirm reports that the retry succeeded.
+ */
+class TransferSizes
+{
+  public:
+    /** @brief Construct the table
+     *
+     * @param minSizeVal - Length the probing never goes below
+     */
+    explicit TransferSizes(const size_t minSizeVal);
+
+    /** @brief Get the maximum PLDM message length of a terminus
+     *
+     * @param tid - TID of the PLDM device
+     * @param initialSize - Length used until the terminus is probed
+     */
+    size_t get(const pldm_tid_t tid, const size_t initialSize) const;
+
+    /** @brief Lower the maximum PLDM message length after a failed part
+     *
+     * A part size failure halves the length. A part without a response drops
+     * the length to the minimum on trial, until confirm is called.
+     *
+     * @param tid - TID of the PLDM device
+     * @param initialSize - Length used until the terminus is probed
+     * @param failure - Why the part failed
+     *
+     * @return true if the part is worth retrying at the reduced length, false
+     * if the failure is not size related, the trial is already running or
+     * the length is already at the minimum
+     */
+    bool reduce(const pldm_tid_t tid, const size_t initialSize,
+                const PartFailure failure);
+
+    /** @brief Keep or undo the length set on trial by reduce
+     *
+     * @param tid - TID of the PLDM device
+     * @param succeeded - Whether the part sent at the trial length succeeded
+     */
+    void confirm(const pldm_tid_t tid, const bool succeeded);
+
+    /** @brief Forget the negotiated length of a terminus */
+    void erase(const pldm_tid_t tid);
+
+  private:
+    size_t minSize;
+    std::unordered_map<pldm_tid_t, size_t> sizes;
+    // Length to restore if the part sent at the minimum on trial fails
+    std::unordered_map<pldm_tid_t, size_t> trialFallbacks;
+};
+
+} // namespace pldm
@@ -15,6 +15,7 @@
  */
 #include "base.hpp"
 
+#include "multipart_transfer.hpp"
 #include "platform.hpp"
 #include "pldm.hpp"
 
@@ -51,6 +52,8 @@ constexpr size_t retryCount = 3;
 constexpr size_t hdrSize = sizeof(pldm_msg_hdr);
 constexpr uint8_t defaultTID = 0x00;
 constexpr size_t maxTIDPoolSize = 254;
+// Room for 255 versions and the CRC32 of the GetVersion response
+constexpr size_t maxVersionDataLen = 1024;
 constexpr std::chrono::minutes tidReclaimWindow{3};
 
 using SupportedPLDMTypes = std::array<bitfield8_t, 8>;
@@ -225,61 +228,46 @@ bool getSupportedPLDMTypes(boost::asio::yield_context yield,
 bool getPLDMVersions(boost::asio::yield_context yield, const mctpw_eid_t eid,
                      const uint8_t pldmType, PLDMVersions& supportedVersions)
 {
-    int8_t maxTransfers = 16;
-    uint8_t instanceID = createInstanceId(defaultTID);
-    std::vector<uint8_t> getPLDMVersionsRequest(
-        sizeof(pldm_get_version_req) + hdrSize, 0x00);
-    std::vector<uint8_t> getPLDMVersionsResponse;
-    uint32_t transferHandle = 0;
-    uint8_t transferOpFlag = PLDM_GET_FIRSTPART;
-    uint8_t completionCode = PLDM_ERROR;
-    uint8_t transferFlag = PLDM_START;
-    variable_field responseVersion;
-    auto msg = reinterpret_cast<pldm_msg*>(getPLDMVersionsRequest.data());
+    MultipartTransferLimits limits;
+    limits.maxLength = maxVersionDataLen;
+    limits.maxParts = 16;
+    // TID passed as 0 will be ignored since EID is present.
+    MultipartTransfer transfer(defaultTID, "GetVersion",
+                               sizeof(pldm_get_version_req), limits, timeOut,
+                               retryCount, eid);
     std::vector<uint8_t> versionDataBuffer;
 
     supportedVersions.clear();
-    while (PLDM_END != transferFlag && PLDM_START_AND_END != transferFlag)
+    bool transferComplete = transfer.receive(
+        yield,
+        [pldmType](const uint8_t instanceID, const uint32_t transferHandle,
+                   const uint8_t transferOpFlag, pldm_msg* msg) {
+            return encode_get_version_req(instanceID, transferHandle,
+                                          transferOpFlag, pldmType, msg);
+        },
+        [eid](std::vector<uint8_t>& resp, uint32_t& nextTransferHandle,
+              uint8_t& transferFlag, std::vector<uint8_t>& buffer) {
+            uint8_t completionCode = PLDM_ERROR;
+            variable_field responseVersion;
+            int rc = decode_get_version_resp(
+                reinterpret_cast<pldm_msg*>(resp.data()),
+                resp.size() - hdrSize, &completionCode, &nextTransferHandle,
+                &transferFlag, &responseVersion);
+            if (!validateBaseRespDecode(eid, rc, completionCode, "GetVersion"))
+            {
+                return false;
+            }
+            buffer.insert(buffer.end(), responseVersion.ptr,
+                          responseVersion.ptr + responseVersion.length);
+            return true;
+        },
+        versionDataBuffer);
+    if (!transferComplete)
     {
-        if (maxTransfers-- < 0)
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "Maximum number of packets limit reached for GetVersion "
-                "request");
-            return false;
-        }
-        int rc = encode_get_version_req(instanceID, transferHandle,
-                                        transferOpFlag, pldmType, msg);
-        if (!validateBaseReqEncode(eid, rc, "GetVersion"))
-        {
-            return false;
-        }
-
-        // TID passed as 0 will be ignored since EID is present.
-        if (!sendReceivePldmMessage(yield, defaultTID, timeOut, retryCount,
-                                    getPLDMVersionsRequest,
-                                    getPLDMVersionsResponse, eid))
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "Send or receive error while getting supported PLDM Versions",
-                phosphor::logging::entry("EID=0x%X", eid));
-            return false;
-        }
-
-        // For multipart response next transfer handle will be updated in
-        // transferHandle variable and it will be used in subsequent iterations
-        rc = decode_get_version_resp(
-            reinterpret_cast<pldm_msg*>(getPLDMVersionsResponse.data()),
-            getPLDMVersionsResponse.size() - hdrSize, &completionCode,
-            &transferHandle, &transferFlag, &responseVersion);
-        if (!validateBaseRespDecode(eid, rc, completionCode, "GetVersion"))
-        {
-            return false;
-        }
-        versionDataBuffer.insert(versionDataBuffer.end(), responseVersion.ptr,
-                                 responseVersion.ptr + responseVersion.length);
-
-        transferOpFlag = PLDM_GET_NEXTPART;
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Error while getting supported PLDM Versions",
+            phosphor::logging::entry("EID=0x%X", eid));
+        return false;
     }
 
     // Version response should contain at least one version and its CRC32
@@ -845,6 +833,20 @@ bool deleteDeviceBaseInfo(const pldm_tid_t tid)
     return discoveryDataTable.erase(tid) == 1;
 }
 
+std::optional<std::array<uint8_t, 16>> getTerminusUUID(const pldm_tid_t tid)
+{
+    auto itr = std::find_if(uuidMapping.begin(), uuidMapping.end(),
+                            [&tid](const auto& uuidTID) {
+                                auto const& [uuid, mappedTID] = uuidTID;
+                                return mappedTID == tid;
+                            });
+    if (itr == uuidMapping.end())
+    {
+        return std::nullopt;
+    }
+    return itr->first;
+}
+
 bool isSupported(pldm_tid_t tid, const uint8_t type, const uint8_t cmd)
 {
     try
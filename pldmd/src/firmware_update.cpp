@@ -16,6 +16,7 @@
 #include "firmware_update.hpp"
 
 #include "fwu_inventory.hpp"
+#include "multipart_transfer.hpp"
 #include "platform.hpp"
 #include "pldm.hpp"
 #include "pldm_fwu_image.hpp"
@@ -449,43 +450,48 @@ int FWUpdate::processGetDeviceMetaData(const boost::asio::yield_context yield)
         return PLDM_SUCCESS;
     }
 
-    // GetDeviceMetaData
-    uint32_t dataTransferHandle = 0;
-    uint32_t nextDataTransferHandle = 0;
-
-    uint8_t transferOperationFlag = PLDM_GET_FIRSTPART;
-    uint8_t nextTransferFlag = PLDM_START;
-
-    // Count responses received
-    uint8_t responseCount = 0;
-
-    while ((nextTransferFlag != PLDM_START_AND_END) &&
-           (nextTransferFlag != PLDM_END))
+    MultipartTransferLimits limits;
+    limits.expectedLength = fwDeviceMetaDataLen;
+    limits.maxLength = fwDeviceMetaDataLen;
+    limits.maxParts = deviceMetaDataResponseCount;
+    MultipartTransfer transfer(currentTid, "GetDeviceMetaData",
+                               sizeof(struct get_device_meta_data_req), limits,
+                               timeout, retryCount);
+
+    bool transferComplete = transfer.receive(
+        yield,
+        [](const uint8_t instanceID, const uint32_t dataTransferHandle,
+           const uint8_t transferOperationFlag, pldm_msg* msgReq) {
+            return encode_get_device_meta_data_req(
+                instanceID, msgReq, sizeof(struct get_device_meta_data_req),
+                dataTransferHandle, transferOperationFlag);
+        },
+        [this](std::vector<uint8_t>& pldmResp,
+               uint32_t& nextDataTransferHandle, uint8_t& transferFlag,
+               std::vector<uint8_t>& buffer) {
+            struct variable_field metaData = {};
+            auto msgResp = reinterpret_cast<pldm_msg*>(pldmResp.data());
+
+            int retVal = decode_get_device_meta_data_resp(
+                msgResp, pldmResp.size() - hdrSize, &completionCode,
+                &nextDataTransferHandle, &transferFlag, &metaData);
+            if (!validatePLDMRespDecode(currentTid, retVal, completionCode,
+                                        "GetDeviceMetaData"))
+            {
+                return false;
+            }
+            buffer.insert(buffer.end(), metaData.ptr,
+                          metaData.ptr + metaData.length);
+            return true;
+        },
+        fwDeviceMetaData);
+    if (!transferComplete)
     {
-        int retVal =
-            getDeviceMetaData(yield, dataTransferHandle, transferOperationFlag,
-                              nextDataTransferHandle, nextTransferFlag);
-
-        if (retVal != PLDM_SUCCESS)
-        {
-            phosphor::logging::log<phosphor::logging::level::WARNING>(
-                ("GetDeviceMetaData failed with retVal " +
-                 std::to_string(retVal))
-                    .c_str());
-            return retVal;
-        }
-        dataTransferHandle = nextDataTransferHandle;
-        transferOperationFlag = PLDM_GET_NEXTPART;
-
-        // Limiting number of times while loop executes
-        if (responseCount++ >= deviceMetaDataResponseCount)
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "GetDeviceMetaData responses exceed limit");
-
-            fwDeviceMetaData.clear();
-            return PLDM_ERROR;
-        }
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "GetDeviceMetaData failed",
+            phosphor::logging::entry("TID=%d", currentTid));
+        fwDeviceMetaData.clear();
+        return PLDM_ERROR;
     }
     phosphor::logging::log<phosphor::logging::level::DEBUG>(
         (std::string("GetDeviceMetaData successful. Received bytes ") +
@@ -494,56 +500,6 @@ int FWUpdate::processGetDeviceMetaData(const boost::asio::yield_context yield)
     return PLDM_SUCCESS;
 }
 
-int FWUpdate::getDeviceMetaData(const boost::asio::yield_context yield,
-                                const uint32_t dataTransferHandle,
-                                const uint8_t transferOperationFlag,
-                                uint32_t& nextDataTransferHandle,
-                                uint8_t& transferFlag)
-{
-
-    uint8_t instanceID = createInstanceId(currentTid);
-    std::vector<uint8_t> pldmReq(sizeof(struct PLDMEmptyRequest) +
-                                 sizeof(struct get_device_meta_data_req));
-    struct pldm_msg* msgReq = reinterpret_cast<pldm_msg*>(pldmReq.data());
-
-    int retVal = encode_get_device_meta_data_req(
-        instanceID, msgReq, sizeof(struct get_device_meta_data_req),
-        dataTransferHandle, transferOperationFlag);
-    if (!validatePLDMReqEncode(currentTid, retVal, "GetDeviceMetaData"))
-    {
-        return retVal;
-    }
-
-    // Send GetDeviceMetaData Command
-    std::vector<uint8_t> pldmResp;
-    if (!sendReceivePldmMessage(yield, currentTid, timeout, retryCount, pldmReq,
-                                pldmResp))
-    {
-        phosphor::logging::log<phosphor::logging::level::ERR>(
-            "GetDeviceMetaData: Failed to send or receive PLDM message",
-            phosphor::logging::entry("TID=%d", currentTid));
-        return PLDM_ERROR;
-    }
-    struct variable_field metaData = {};
-    auto msgResp = reinterpret_cast<pldm_msg*>(pldmResp.data());
-
-    // Decode received response
-    retVal = decode_get_device_meta_data_resp(
-        msgResp, pldmResp.size() - hdrSize, &completionCode,
-        &nextDataTransferHandle, &transferFlag, &metaData);
-    if (!validatePLDMRespDecode(currentTid, retVal, completionCode,
-                                "GetDeviceMetaData"))
-    {
-        return retVal;
-    }
-
-    // Save metadata
-    std::copy(metaData.ptr, metaData.ptr + metaData.length,
-              back_inserter(fwDeviceMetaData));
-
-    return PLDM_SUCCESS;
-}
-
 int FWUpdate::processSendMetaData(const boost::asio::yield_context yield)
 {
 
@@ -2409,18 +2365,21 @@ static int initUpdate(const boost::asio::yield_context yield)
                     .c_str());
             continue;
         }
-        pldm::platform::pauseSensorPolling();
-        int retVal = fwUpdate->runUpdate(yield);
-        if (retVal != PLDM_SUCCESS)
         {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                ("runUpdate failed for TID: " + std::to_string(matchedTid) +
-                 ". RETVAL:" + std::to_string(retVal))
-                    .c_str());
-            fwUpdateStatus = false;
-            fwUpdate->terminateFwUpdate(yield);
+            pldm::platform::SensorPollingPause pause(
+                pldm::platform::PollPauseReason::firmwareUpdate);
+            int retVal = fwUpdate->runUpdate(yield);
+            if (retVal != PLDM_SUCCESS)
+            {
+                phosphor::logging::log<phosphor::logging::level::ERR>(
+                    ("runUpdate failed for TID: " +
+                     std::to_string(matchedTid) +
+                     ". RETVAL:" + std::to_string(retVal))
+                        .c_str());
+                fwUpdateStatus = false;
+                fwUpdate->terminateFwUpdate(yield);
+            }
         }
-        pldm::platform::resumeSensorPolling();
         updateMode = false;
     }
 
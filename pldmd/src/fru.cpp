@@ -16,6 +16,7 @@
 #include "fru.hpp"
 
 #include "fru_support.hpp"
+#include "multipart_transfer.hpp"
 
 #include <string>
 #include <xyz/openbmc_project/Inventory/Source/PLDM/FRU/server.hpp>
@@ -235,94 +236,71 @@ static bool addFRUObjectToDbus(const std::string& fruObjPath,
 
 int GetPLDMFRU::getFRURecordTableCmd(FRUProperties& fruProperties)
 {
-    uint32_t dataTransferHandle = 0;
-    uint8_t transferOperationFlag = PLDM_GET_FIRSTPART;
-    size_t multipartTransferLimit = 100;
-
-    uint8_t cc = PLDM_ERROR;
-    uint8_t transferFlag = 0;
-    uint32_t nextDataTransferHandle = 0;
-    size_t fruRecordTableLen = 0;
-    std::vector<uint8_t> fruRecordTableData = {};
-
-    while (transferFlag != PLDM_END && transferFlag != PLDM_START_AND_END)
+    auto fruTableLen = fruMetadata.find("FRUTableLength");
+    if (fruTableLen == fruMetadata.end())
     {
-        auto fruTableLen = fruMetadata.find("FRUTableLength");
-        if (fruTableLen == fruMetadata.end())
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "GetFruRecordTable: No FRUTableLength available in "
-                "metadata",
-                phosphor::logging::entry("TID=%d", tid));
-            return PLDM_ERROR;
-        }
-        if (fruRecordTableData.size() > fruTableLen->second ||
-            !(--multipartTransferLimit))
-        {
-            phosphor::logging::log<phosphor::logging::level::WARNING>(
-                "Max FRU record table length limit reached. Discarding the "
-                "record",
-                phosphor::logging::entry("TID=%d", tid));
-            return PLDM_ERROR;
-        }
-
-        uint8_t instanceID = createInstanceId(tid);
-
-        std::vector<uint8_t> requestMsg(pldmHdrSize +
-                                        PLDM_GET_FRU_RECORD_TABLE_REQ_BYTES);
-        auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
-
-        int rc = encode_get_fru_record_table_req(
-            instanceID, dataTransferHandle, transferOperationFlag, request,
-            requestMsg.size() - pldmHdrSize);
-
-        if (!validatePLDMReqEncode(tid, rc, "GetFruRecordTable"))
-        {
-            return PLDM_ERROR;
-        }
-
-        std::vector<uint8_t> responseMsg;
-
-        if (!sendReceivePldmMessage(yield, tid, timeout, retryCount, requestMsg,
-                                    responseMsg))
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "GetFruRecordTable: Failed to send or receive PLDM message",
-                phosphor::logging::entry("TID=%d", tid));
-            return PLDM_ERROR;
-        }
-
-        auto responsePtr = reinterpret_cast<pldm_msg*>(responseMsg.data());
-        size_t payloadLen = responseMsg.size() - pldmHdrSize;
-
-        if (payloadLen < PLDM_GET_FRU_RECORD_TABLE_MIN_RESP_BYTES)
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "GetFruRecordTable: payloadLen cannot be less than 6",
-                phosphor::logging::entry("TID=%d", tid));
-            return PLDM_ERROR;
-        }
-
-        std::vector<uint8_t> partialFRURecordTableData(
-            payloadLen - PLDM_GET_FRU_RECORD_TABLE_MIN_RESP_BYTES);
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "GetFruRecordTable: No FRUTableLength available in "
+            "metadata",
+            phosphor::logging::entry("TID=%d", tid));
+        return PLDM_ERROR;
+    }
 
-        rc = decode_get_fru_record_table_resp(
-            responsePtr, payloadLen, &cc, &nextDataTransferHandle,
-            &transferFlag, partialFRURecordTableData.data(),
-            &fruRecordTableLen);
+    MultipartTransferLimits limits;
+    limits.expectedLength = fruTableLen->second;
+    limits.maxLength = fruTableLen->second;
+    limits.maxParts = 100;
+    MultipartTransfer transfer(tid, "GetFruRecordTable",
+                               PLDM_GET_FRU_RECORD_TABLE_REQ_BYTES, limits,
+                               timeout, retryCount);
+    std::vector<uint8_t> fruRecordTableData;
+
+    bool transferComplete = transfer.receive(
+        yield,
+        [](const uint8_t instanceID, const uint32_t dataTransferHandle,
+           const uint8_t transferOperationFlag, pldm_msg* request) {
+            return encode_get_fru_record_table_req(
+                instanceID, dataTransferHandle, transferOperationFlag, request,
+                PLDM_GET_FRU_RECORD_TABLE_REQ_BYTES);
+        },
+        [this](std::vector<uint8_t>& responseMsg,
+               uint32_t& nextDataTransferHandle, uint8_t& transferFlag,
+               std::vector<uint8_t>& buffer) {
+            auto responsePtr = reinterpret_cast<pldm_msg*>(responseMsg.data());
+            size_t payloadLen = responseMsg.size() - pldmHdrSize;
+
+            if (payloadLen < PLDM_GET_FRU_RECORD_TABLE_MIN_RESP_BYTES)
+            {
+                phosphor::logging::log<phosphor::logging::level::ERR>(
+                    "GetFruRecordTable: payloadLen cannot be less than 6",
+                    phosphor::logging::entry("TID=%d", tid));
+                return false;
+            }
 
-        if (!validatePLDMRespDecode(tid, rc, cc, "GetFruRecordTable"))
-        {
-            return PLDM_ERROR;
-        }
-        dataTransferHandle = nextDataTransferHandle;
-        transferOperationFlag = PLDM_GET_NEXTPART;
-
-        // Copy multipart fru data into fruRecordTableData to create
-        // final fru
-        std::copy(partialFRURecordTableData.begin(),
-                  partialFRURecordTableData.end(),
-                  std::back_inserter(fruRecordTableData));
+            // Decode the part straight into the end of the table
+            size_t offset = buffer.size();
+            buffer.resize(offset + payloadLen -
+                          PLDM_GET_FRU_RECORD_TABLE_MIN_RESP_BYTES);
+            uint8_t cc = PLDM_ERROR;
+            size_t fruRecordTableLen = 0;
+            int rc = decode_get_fru_record_table_resp(
+                responsePtr, payloadLen, &cc, &nextDataTransferHandle,
+                &transferFlag, buffer.data() + offset, &fruRecordTableLen);
+            if (!validatePLDMRespDecode(tid, rc, cc, "GetFruRecordTable"))
+            {
+                return false;
+            }
+            buffer.resize(offset + fruRecordTableLen);
+            return true;
+        },
+        fruRecordTableData);
+    if (!transferComplete)
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "GetFruRecordTable: Multipart transfer failed. Discarding the "
+            "record",
+            phosphor::logging::entry("TID=%d", tid));
+        return PLDM_ERROR;
     }
 
     if (!verifyCRC(fruRecordTableData))
@@ -0,0 +1,100 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "multipart_transfer.hpp"
+
+#include <algorithm>
+#include <phosphor-logging/log.hpp>
+
+namespace pldm
+{
+
+MultipartTransfer::MultipartTransfer(
+    const pldm_tid_t tidVal, const std::string& commandName,
+    const size_t reqPayloadLen, const MultipartTransferLimits& transferLimits,
+    const uint16_t timeoutVal, const size_t retryCountVal,
+    std::optional<mctpw_eid_t> eidVal) :
+    tid(tidVal),
+    command(commandName), requestPayloadLen(reqPayloadLen),
+    limits(transferLimits), timeout(timeoutVal), retryCount(retryCountVal),
+    eid(eidVal)
+{
+}
+
+bool MultipartTransfer::receive(boost::asio::yield_context yield,
+                                const EncodeRequest& encodeReq,
+                                const DecodeResponse& decodeResp,
+                                std::vector<uint8_t>& buffer)
+{
+    std::vector<uint8_t> req(pldmMsgHdrSize + requestPayloadLen);
+    auto reqMsg = reinterpret_cast<pldm_msg*>(req.data());
+    uint32_t dataTransferHandle = 0;
+    uint8_t transferOpFlag = PLDM_GET_FIRSTPART;
+    uint8_t transferFlag = PLDM_START;
+
+    partCount = 0;
+    buffer.clear();
+    buffer.reserve(std::min(limits.expectedLength, limits.maxLength));
+
+    while (transferFlag != PLDM_END && transferFlag != PLDM_START_AND_END)
+    {
+        if (partCount >= limits.maxParts)
+        {
+            phosphor::logging::log<phosphor::logging::level::ERR>(
+                (command + ": Maximum number of parts limit reached").c_str(),
+                phosphor::logging::entry("TID=%d", tid));
+            return false;
+        }
+
+        int rc = encodeReq(createInstanceId(tid), dataTransferHandle,
+                           transferOpFlag, reqMsg);
+        if (!validatePLDMReqEncode(tid, rc, command))
+        {
+            return false;
+        }
+
+        std::vector<uint8_t> resp;
+        if (!sendReceivePldmMessage(yield, tid, timeout, retryCount, req, resp,
+                                    eid))
+        {
+            phosphor::logging::log<phosphor::logging::level::ERR>(
+                (command + ": Failed to send or receive PLDM message").c_str(),
+                phosphor::logging::entry("TID=%d", tid));
+            return false;
+        }
+
+        uint32_t nextDataTransferHandle = 0;
+        if (!decodeResp(resp, nextDataTransferHandle, transferFlag, buffer))
+        {
+            return false;
+        }
+        ++partCount;
+
+        if (buffer.size() > limits.maxLength)
+        {
+            phosphor::logging::log<phosphor::logging::level::WARNING>(
+                (command + ": Maximum data length limit reached").c_str(),
+                phosphor::logging::entry("TID=%d", tid),
+                phosphor::logging::entry("LEN=%zu", buffer.size()));
+            return false;
+        }
+
+        dataTransferHandle = nextDataTransferHandle;
+        transferOpFlag = PLDM_GET_NEXTPART;
+    }
+    return true;
+}
+
+} // namespace pldm
@@ -0,0 +1,246 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "pdr_cache.hpp"
+
+#include "utils.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <phosphor-logging/log.hpp>
+#include <sstream>
+
+#include "utils.h"
+
+namespace pldm
+{
+namespace platform
+{
+namespace pdr_cache
+{
+
+static constexpr const char* pdrCacheDir = "/var/lib/pldm/pdr";
+static constexpr uint32_t pdrCacheMagic = 0x43524450; // "PDRC"
+static constexpr uint8_t pdrCacheVersion = 0x01;
+
+/* File layout:
+ * PDRCacheHeader | (PDRCacheRecordHeader | PDR data) x recordCount | CRC32
+ * All multi-byte fields are little endian. CRC32 covers everything before it.
+ */
+struct PDRCacheHeader
+{
+    uint32_t magic;
+    uint8_t version;
+    uint8_t uuid[16];
+    timestamp104_t updateTime;
+    timestamp104_t oemUpdateTime;
+    uint32_t recordCount;
+    uint32_t repositorySize;
+    uint32_t largestRecordSize;
+} __attribute__((packed));
+
+struct PDRCacheRecordHeader
+{
+    uint32_t recordHandle;
+    uint32_t length;
+} __attribute__((packed));
+
+static std::filesystem::path getCachePath(const UUID& uuid)
+{
+    std::stringstream fileName;
+    for (auto byte : uuid)
+    {
+        fileName << std::hex << std::setfill('0') << std::setw(2)
+                 << static_cast<int>(byte);
+    }
+    fileName << ".bin";
+    return std::filesystem::path(pdrCacheDir) / fileName.str();
+}
+
+static bool isHeaderValid(const PDRCacheHeader& header, const UUID& uuid,
+                          const pldm_pdr_repository_info& pdrRepoInfo)
+{
+    return le32toh(header.magic) == pdrCacheMagic &&
+           header.version == pdrCacheVersion &&
+           std::memcmp(header.uuid, uuid.data(), uuid.size()) == 0 &&
+           std::memcmp(&header.updateTime, &pdrRepoInfo.update_time,
+                       sizeof(timestamp104_t)) == 0 &&
+           std::memcmp(&header.oemUpdateTime, &pdrRepoInfo.oem_update_time,
+                       sizeof(timestamp104_t)) == 0 &&
+           le32toh(header.recordCount) == pdrRepoInfo.record_count &&
+           le32toh(header.repositorySize) == pdrRepoInfo.repository_size &&
+           le32toh(header.largestRecordSize) == pdrRepoInfo.largest_record_size;
+}
+
+static std::optional<DevicePDRs>
+    parseCache(const std::vector<uint8_t>& data, const UUID& uuid,
+               const pldm_pdr_repository_info& pdrRepoInfo)
+{
+    constexpr size_t crcSize = sizeof(uint32_t);
+    if (data.size() < sizeof(PDRCacheHeader) + crcSize)
+    {
+        return std::nullopt;
+    }
+
+    uint32_t crc;
+    std::memcpy(&crc, data.data() + data.size() - crcSize, crcSize);
+    if (le32toh(crc) != crc32(data.data(), data.size() - crcSize))
+    {
+        return std::nullopt;
+    }
+
+    PDRCacheHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (!isHeaderValid(header, uuid, pdrRepoInfo))
+    {
+        return std::nullopt;
+    }
+
+    DevicePDRs devicePDRs;
+    size_t offset = sizeof(header);
+    const size_t end = data.size() - crcSize;
+    for (uint32_t record = 0; record < pdrRepoInfo.record_count; record++)
+    {
+        if (end - offset < sizeof(PDRCacheRecordHeader))
+        {
+            return std::nullopt;
+        }
+        PDRCacheRecordHeader recordHeader;
+        std::memcpy(&recordHeader, data.data() + offset, sizeof(recordHeader));
+        offset += sizeof(recordHeader);
+
+        uint32_t length = le32toh(recordHeader.length);
+        if (end - offset < length || length > pdrRepoInfo.largest_record_size)
+        {
+            return std::nullopt;
+        }
+        devicePDRs.emplace(le32toh(recordHeader.recordHandle),
+                           std::vector<uint8_t>(data.begin() + offset,
+                                                data.begin() + offset +
+                                                    length));
+        offset += length;
+    }
+    if (offset != end)
+    {
+        return std::nullopt;
+    }
+    return devicePDRs;
+}
+
+std::optional<DevicePDRs> load(const UUID& uuid,
+                               const pldm_pdr_repository_info& pdrRepoInfo)
+{
+    std::filesystem::path cachePath = getCachePath(uuid);
+    std::ifstream cacheFile(cachePath, std::ios::binary);
+    if (!cacheFile)
+    {
+        return std::nullopt;
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(cacheFile)),
+                              std::istreambuf_iterator<char>());
+    cacheFile.close();
+
+    std::optional<DevicePDRs> devicePDRs = parseCache(data, uuid, pdrRepoInfo);
+    if (!devicePDRs)
+    {
+        phosphor::logging::log<phosphor::logging::level::INFO>(
+            ("Discarding outdated or corrupted PDR cache " +
+             cachePath.string())
+                .c_str());
+        remove(uuid);
+    }
+    return devicePDRs;
+}
+
+bool store(const UUID& uuid, const pldm_pdr_repository_info& pdrRepoInfo,
+           const DevicePDRs& devicePDRs)
+{
+    PDRCacheHeader header;
+    header.magic = htole32(pdrCacheMagic);
+    header.version = pdrCacheVersion;
+    std::memcpy(header.uuid, uuid.data(), uuid.size());
+    header.updateTime = pdrRepoInfo.update_time;
+    header.oemUpdateTime = pdrRepoInfo.oem_update_time;
+    header.recordCount = htole32(utils::to_uint32(devicePDRs.size()));
+    header.repositorySize = htole32(pdrRepoInfo.repository_size);
+    header.largestRecordSize = htole32(pdrRepoInfo.largest_record_size);
+
+    std::vector<uint8_t> data;
+    const uint8_t* headerPtr = reinterpret_cast<const uint8_t*>(&header);
+    data.insert(data.end(), headerPtr, headerPtr + sizeof(header));
+    for (const auto& [recordHandle, pdr] : devicePDRs)
+    {
+        PDRCacheRecordHeader recordHeader;
+        recordHeader.recordHandle = htole32(recordHandle);
+        recordHeader.length = htole32(utils::to_uint32(pdr.size()));
+        const uint8_t* recordHeaderPtr =
+            reinterpret_cast<const uint8_t*>(&recordHeader);
+        data.insert(data.end(), recordHeaderPtr,
+                    recordHeaderPtr + sizeof(recordHeader));
+        data.insert(data.end(), pdr.begin(), pdr.end());
+    }
+    uint32_t crc = htole32(crc32(data.data(), data.size()));
+    const uint8_t* crcPtr = reinterpret_cast<const uint8_t*>(&crc);
+    data.insert(data.end(), crcPtr, crcPtr + sizeof(crc));
+
+    std::error_code ec;
+    std::filesystem::create_directories(pdrCacheDir, ec);
+    if (ec)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            ("Unable to create PDR cache directory. " + ec.message()).c_str());
+        return false;
+    }
+
+    // Write to a temporary file and rename, so that a power loss never
+    // leaves a partially written cache behind
+    std::filesystem::path cachePath = getCachePath(uuid);
+    std::filesystem::path tmpPath = cachePath;
+    tmpPath += ".tmp";
+    {
+        std::ofstream cacheFile(tmpPath, std::ios::binary | std::ios::trunc);
+        cacheFile.write(reinterpret_cast<const char*>(data.data()),
+                        static_cast<std::streamsize>(data.size()));
+        cacheFile.close();
+        if (!cacheFile)
+        {
+            phosphor::logging::log<phosphor::logging::level::ERR>(
+                ("Unable to write PDR cache " + tmpPath.string()).c_str());
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+    }
+    std::filesystem::rename(tmpPath, cachePath, ec);
+    if (ec)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            ("Unable to store PDR cache. " + ec.message()).c_str());
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+void remove(const UUID& uuid)
+{
+    std::error_code ec;
+    std::filesystem::remove(getCachePath(uuid), ec);
+}
+
+} // namespace pdr_cache
+} // namespace platform
+} // namespace pldm
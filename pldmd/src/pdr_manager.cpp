@@ -16,6 +16,7 @@
 
 #include "pdr_manager.hpp"
 
+#include "multipart_transfer.hpp"
 #include "platform.hpp"
 #include "pldm.hpp"
 #include "utils.hpp"
@@ -90,20 +91,18 @@ static void printPDRInfo(pldm_pdr_repository_info& pdrRepoInfo)
 // TODO: remove this API after code complete
 static void printPDRResp(const RecordHandle& recordHandle,
                          const RecordHandle& nextRecordHandle,
-                         const transfer_op_flag& transferOpFlag,
+                         const uint8_t& transferFlag,
                          const uint16_t& recordChangeNumber,
                          const DataTransferHandle& nextDataTransferHandle,
-                         const bool& transferComplete,
                          const std::vector<uint8_t>& pdrRecord)
 {
     printDebug("GetPDR: recordHandle -" + std::to_string(recordHandle));
     printDebug("GetPDR: nextRecordHandle -" + std::to_string(nextRecordHandle));
-    printDebug("GetPDR: transferOpFlag -" + std::to_string(transferOpFlag));
+    printDebug("GetPDR: transferFlag -" + std::to_string(transferFlag));
     printDebug("GetPDR: recordChangeNumber -" +
                std::to_string(recordChangeNumber));
     printDebug("GetPDR: nextDataTransferHandle -" +
                std::to_string(nextDataTransferHandle));
-    printDebug("GetPDR: transferComplete -" + std::to_string(transferComplete));
     utils::printVect("PDR:", pdrRecord);
 }
 
@@ -149,18 +148,16 @@ std::optional<pldm_pdr_repository_info>
 
 static bool handleGetPDRResp(pldm_tid_t tid, std::vector<uint8_t>& resp,
                              RecordHandle& nextRecordHandle,
-                             transfer_op_flag& transferOpFlag,
                              uint16_t& recordChangeNumber,
-                             DataTransferHandle& dataTransferHandle,
-                             bool& transferComplete,
-                             std::vector<uint8_t>& pdrRecord)
+                             DataTransferHandle& nextDataTransferHandle,
+                             uint8_t& transferFlag,
+                             std::vector<uint8_t>& pdrRecord,
+                             PartFailure& failure)
 {
     int rc;
     uint8_t completionCode{};
-    uint8_t transferFlag{};
     uint8_t transferCRC{};
     uint16_t recordDataLen{};
-    DataTransferHandle nextDataTransferHandle{};
     auto respMsgPtr = reinterpret_cast<struct pldm_msg*>(resp.data());
 
     // Get the number of recordData bytes in the response
@@ -170,120 +167,105 @@ static bool handleGetPDRResp(pldm_tid_t tid, std::vector<uint8_t>& resp,
                              &recordDataLen, nullptr, 0, &transferCRC);
     if (!validatePLDMRespDecode(tid, rc, completionCode, "GetPDR"))
     {
+        failure = isPartSizeError(rc, completionCode)
+                      ? PartFailure::partSize
+                      : PartFailure::invalidResponse;
         return false;
     }
 
-    std::vector<uint8_t> pdrData(recordDataLen, 0);
-    rc = decode_get_pdr_resp(
-        respMsgPtr, resp.size() - pldmMsgHdrSize, &completionCode,
-        &nextRecordHandle, &nextDataTransferHandle, &transferFlag,
-        &recordDataLen, pdrData.data(), pdrData.size(), &transferCRC);
+    // Decode the part straight into the end of the record
+    size_t offset = pdrRecord.size();
+    pdrRecord.resize(offset + recordDataLen);
+    rc = decode_get_pdr_resp(respMsgPtr, resp.size() - pldmMsgHdrSize,
+                             &completionCode, &nextRecordHandle,
+                             &nextDataTransferHandle, &transferFlag,
+                             &recordDataLen, pdrRecord.data() + offset,
+                             recordDataLen, &transferCRC);
 
     if (!validatePLDMRespDecode(tid, rc, completionCode, "GetPDR"))
     {
+        failure = isPartSizeError(rc, completionCode)
+                      ? PartFailure::partSize
+                      : PartFailure::invalidResponse;
         return false;
     }
 
-    pdrRecord.insert(pdrRecord.end(), pdrData.begin(), pdrData.end());
-    if (transferFlag == PLDM_START)
+    if (transferFlag == PLDM_START && pdrRecord.size() >= sizeof(pldm_pdr_hdr))
     {
         auto pdrHdr = reinterpret_cast<pldm_pdr_hdr*>(pdrRecord.data());
         recordChangeNumber = le16toh(pdrHdr->record_change_num);
     }
 
-    dataTransferHandle = nextDataTransferHandle;
-    if ((transferComplete =
-             (transferFlag == PLDM_END || transferFlag == PLDM_START_AND_END)))
+    if (transferFlag == PLDM_END)
     {
-        if (transferFlag == PLDM_END)
+        uint8_t calculatedCRC = crc8(pdrRecord.data(), pdrRecord.size());
+        if (calculatedCRC != transferCRC)
         {
-            uint8_t calculatedCRC = crc8(pdrRecord.data(), pdrRecord.size());
-            if (calculatedCRC != transferCRC)
-            {
-                phosphor::logging::log<phosphor::logging::level::ERR>(
-                    "PDR record CRC check failed");
-                return false;
-            }
+            phosphor::logging::log<phosphor::logging::level::ERR>(
+                "PDR record CRC check failed");
+            failure = PartFailure::invalidResponse;
+            return false;
         }
     }
-    else
-    {
-        transferOpFlag = PLDM_GET_NEXTPART;
-    }
     return true;
 }
 
+static uint16_t getPDRRequestCount(const pldm_tid_t tid)
+{
+    return static_cast<uint16_t>(
+        std::min<size_t>(getMaxTransferSize(tid) - PLDM_GET_PDR_MIN_RESP_BYTES,
+                         std::numeric_limits<uint16_t>::max()));
+}
+
 bool PDRManager::getDevicePDRRecord(boost::asio::yield_context yield,
                                     const RecordHandle recordHandle,
                                     RecordHandle& nextRecordHandle,
                                     std::vector<uint8_t>& pdrRecord)
 {
-    std::vector<uint8_t> req(pldmMsgHdrSize + PLDM_GET_PDR_REQ_BYTES);
-    auto reqMsgPtr = reinterpret_cast<pldm_msg*>(req.data());
-    constexpr size_t requestCount =
-        maxPLDMMessageLen - PLDM_GET_PDR_MIN_RESP_BYTES;
+    MultipartTransferLimits limits;
+    limits.maxLength = pdrRepoInfo.largest_record_size;
+    limits.maxParts = 100;
     bool transferComplete = false;
-    uint16_t recordChangeNumber = 0;
-    size_t multipartTransferLimit = 100;
-    transfer_op_flag transferOpFlag = PLDM_GET_FIRSTPART;
-    DataTransferHandle dataTransferHandle = 0x00;
+    bool firstPartReceived = false;
 
-    // Multipart PDR data transfer
     do
     {
-        int rc;
-        rc = encode_get_pdr_req(createInstanceId(_tid), recordHandle,
-                                dataTransferHandle, transferOpFlag,
-                                requestCount, recordChangeNumber, reqMsgPtr,
-                                PLDM_GET_PDR_REQ_BYTES);
-        if (!validatePLDMReqEncode(_tid, rc, "GetPDR"))
-        {
-            break;
-        }
-
-        std::vector<uint8_t> resp;
-        if (!sendReceivePldmMessage(yield, _tid, commandTimeout,
-                                    commandRetryCount, req, resp))
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "Failed to send or receive GetPDR request",
-                phosphor::logging::entry("TID=%d", _tid));
-            break;
-        }
-
-        bool ret = handleGetPDRResp(
-            _tid, resp, nextRecordHandle, transferOpFlag, recordChangeNumber,
-            dataTransferHandle, transferComplete, pdrRecord);
-        if (!ret)
-        {
-            // Discard the record if decode failed
-            phosphor::logging::log<phosphor::logging::level::WARNING>(
-                "handleGetRecordResp failed");
-            // Clear transferComplete if modified
-            transferComplete = false;
-            break;
-        }
-
-        // TODO: remove after code complete
-        printPDRResp(recordHandle, nextRecordHandle, transferOpFlag,
-                     recordChangeNumber, dataTransferHandle, transferComplete,
-                     pdrRecord);
-
-        // Limit the number of middle packets
-        // Discard the record if exceeeded.
-        if (pdrRecord.size() > pdrRepoInfo.largest_record_size ||
-            !(--multipartTransferLimit))
-        {
-            phosphor::logging::log<phosphor::logging::level::WARNING>(
-                "Max PDR record size limit reached",
-                phosphor::logging::entry("TID=%d", _tid),
-                phosphor::logging::entry("RECORD_HANDLE=%lu", recordHandle));
-            // Clear transferComplete to make sure the record is not getting
-            // added to the PDR repository
-            transferComplete = false;
-            break;
-        }
-    } while (!transferComplete);
+        uint16_t requestCount = getPDRRequestCount(_tid);
+        uint16_t recordChangeNumber = 0;
+        // Stays noResponse unless a response reaches the decoder
+        PartFailure failure = PartFailure::noResponse;
+        MultipartTransfer transfer(_tid, "GetPDR", PLDM_GET_PDR_REQ_BYTES,
+                                   limits, commandTimeout, commandRetryCount);
+        transferComplete = transfer.receive(
+            yield,
+            [&](const uint8_t instanceID,
+                const DataTransferHandle dataTransferHandle,
+                const uint8_t transferOpFlag, pldm_msg* reqMsgPtr) {
+                return encode_get_pdr_req(
+                    instanceID, recordHandle, dataTransferHandle,
+                    transferOpFlag, requestCount, recordChangeNumber,
+                    reqMsgPtr, PLDM_GET_PDR_REQ_BYTES);
+            },
+            [&](std::vector<uint8_t>& resp,
+                DataTransferHandle& nextDataTransferHandle,
+                uint8_t& transferFlag, std::vector<uint8_t>& buffer) {
+                bool ret = handleGetPDRResp(
+                    _tid, resp, nextRecordHandle, recordChangeNumber,
+                    nextDataTransferHandle, transferFlag, buffer, failure);
+                // TODO: remove after code complete
+                printPDRResp(recordHandle, nextRecordHandle, transferFlag,
+                             recordChangeNumber, nextDataTransferHandle,
+                             buffer);
+                return ret;
+            },
+            pdrRecord);
+
+        // A terminus not able to serve parts of the requested size rejects
+        // or drops the first part. Probe with smaller parts before giving up
+        // the record, but keep the size if the part failed for another reason.
+        firstPartReceived = transferComplete || transfer.getPartCount() != 0;
+    } while (!firstPartReceived && reduceMaxTransferSize(_tid, failure));
+    confirmMaxTransferSize(_tid, firstPartReceived);
 
     if (!transferComplete)
     {
@@ -386,6 +368,13 @@ bool PDRManager::constructPDRRepo(boost::asio::yield_context yield)
         return false;
     }
 
+    // Unchanged repository of a known terminus is restored from the cache
+    std::optional<UUID> uuid = pldm::base::getTerminusUUID(_tid);
+    if (uuid && restorePDRRepoFromCache(*uuid))
+    {
+        return true;
+    }
+
     std::unordered_map<RecordHandle, std::vector<uint8_t>> devicePDRs{};
     uint8_t noOfCommandTries = 3;
     while (noOfCommandTries--)
@@ -421,13 +410,46 @@ bool PDRManager::constructPDRRepo(boost::asio::yield_context yield)
         return false;
     }
 
+    if (uuid)
+    {
+        pdr_cache::store(*uuid, pdrRepoInfo, devicePDRs);
+    }
+
     phosphor::logging::log<phosphor::logging::level::INFO>(
         ("GetPDR success. Total number of records:" +
          std::to_string(noOfRecordsFetched))
             .c_str(),
         phosphor::logging::entry("TID=%d", _tid));
     return true;
-} // namespace platform
+}
+
+bool PDRManager::restorePDRRepoFromCache(const UUID& uuid)
+{
+    std::optional<DevicePDRs> devicePDRs = pdr_cache::load(uuid, pdrRepoInfo);
+    if (!devicePDRs)
+    {
+        return false;
+    }
+
+    if (addDevicePDRToRepo(*devicePDRs) &&
+        pldm_pdr_get_record_count(_pdrRepo.get()) == pdrRepoInfo.record_count)
+    {
+        phosphor::logging::log<phosphor::logging::level::INFO>(
+            ("PDR repository restored from cache. Total number of records:" +
+             std::to_string(pdrRepoInfo.record_count))
+                .c_str(),
+            phosphor::logging::entry("TID=%d", _tid));
+        return true;
+    }
+
+    phosphor::logging::log<phosphor::logging::level::WARNING>(
+        "Invalid PDR cache. Fetching PDRs from terminus",
+        phosphor::logging::entry("TID=%d", _tid));
+    pdr_cache::remove(uuid);
+    PDRRepo pdrRepo(pldm_pdr_init(), pldm_pdr_destroy);
+    _pdrRepo = std::move(pdrRepo);
+    return false;
+}
 
 static std::optional<std::string> getAuxName(const uint8_t nameStrCount,
                                              const size_t auxNamesLen,
@@ -1076,13 +1098,13 @@ static void populateStateSensor(DBusInterfacePtr& sensorIntf,
 
 void PDRManager::parseStateSensorPDR(std::vector<uint8_t>& pdrData)
 {
-    // Without composite sensor support there is only one instance of sensor
-    // possible states.
     // pldm_state_sensor_pdr holds a `uint8 possible_states[1]` which points to
     // state_sensor_possible_states. Subtract its size(1 byte) while calculating
     // total size.
-    if (pdrData.size() < sizeof(pldm_state_sensor_pdr) - sizeof(uint8_t) +
-                             sizeof(state_sensor_possible_states))
+    constexpr size_t possibleStatesOffset =
+        sizeof(pldm_state_sensor_pdr) - sizeof(uint8_t);
+    if (pdrData.size() <
+        possibleStatesOffset + sizeof(state_sensor_possible_states))
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
             "State Sensor PDR length invalid or sensor disabled",
@@ -1100,58 +1122,77 @@ void PDRManager::parseStateSensorPDR(std::vector<uint8_t>& pdrData)
 
     uint16_t sensorID = sensorPDR->sensor_id;
 
-    // TODO: Composite sensor support
-    if (sensorPDR->composite_sensor_count > 0x01)
+    // Max compositeSensorCount as per spec DSP0248 Table 81
+    constexpr uint8_t maxCompositeSensorCount = 0x08;
+    if (sensorPDR->composite_sensor_count < 0x01 ||
+        sensorPDR->composite_sensor_count > maxCompositeSensorCount)
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
-            "Composite state sensor not supported",
+            "Invalid composite sensor count in State Sensor PDR",
             phosphor::logging::entry("TID=%d", _tid),
             phosphor::logging::entry("SENSOR_ID=0x%x", sensorID),
             phosphor::logging::entry("COMPOSITE_SENSOR_COUNT=%d",
                                      sensorPDR->composite_sensor_count));
-    }
-
-    state_sensor_possible_states* possibleState =
-        reinterpret_cast<state_sensor_possible_states*>(
-            sensorPDR->possible_states);
-    LE16TOH(possibleState->state_set_id);
-
-    if (pdrData.size() < sizeof(pldm_state_sensor_pdr) - sizeof(uint8_t) +
-                             sizeof(state_sensor_possible_states) -
-                             sizeof(uint8_t) +
-                             possibleState->possible_states_size)
-    {
-        phosphor::logging::log<phosphor::logging::level::WARNING>(
-            "Invalid State Sensor PDR length",
-            phosphor::logging::entry("TID=%d", _tid));
         return;
     }
 
-    PossibleStates possibleStates;
-    possibleStates.stateSetID = possibleState->state_set_id;
-    // Max possibleStateSize as per spec DSP0248 Table 81
-    constexpr uint8_t maxPossibleStatesSize = 0x20;
-    int position = 0;
-    for (uint8_t count = 0; count < possibleState->possible_states_size &&
-                            count < maxPossibleStatesSize;
-         count++)
+    // Composite sensor carries one possible states field per sensor instance.
+    // All of them are read back by a single GetStateSensorReadings command.
+    std::vector<PossibleStates> possibleStatesList;
+    size_t offset = possibleStatesOffset;
+    for (uint8_t sensorIndex = 0;
+         sensorIndex < sensorPDR->composite_sensor_count; sensorIndex++)
     {
-        for (uint8_t bits = 0; bits < 8; bits++)
+        if (pdrData.size() < offset + sizeof(state_sensor_possible_states))
         {
-            if (possibleState->states[count].byte & (0x01 << bits))
+            phosphor::logging::log<phosphor::logging::level::WARNING>(
+                "Invalid State Sensor PDR length",
+                phosphor::logging::entry("TID=%d", _tid));
+            return;
+        }
+        state_sensor_possible_states* possibleState =
+            reinterpret_cast<state_sensor_possible_states*>(pdrData.data() +
+                                                            offset);
+        LE16TOH(possibleState->state_set_id);
+
+        size_t possibleStatesLen = sizeof(state_sensor_possible_states) -
+                                   sizeof(uint8_t) +
+                                   possibleState->possible_states_size;
+        if (pdrData.size() < offset + possibleStatesLen)
+        {
+            phosphor::logging::log<phosphor::logging::level::WARNING>(
+                "Invalid State Sensor PDR length",
+                phosphor::logging::entry("TID=%d", _tid));
+            return;
+        }
+
+        PossibleStates possibleStates;
+        possibleStates.stateSetID = possibleState->state_set_id;
+        // Max possibleStateSize as per spec DSP0248 Table 81
+        constexpr uint8_t maxPossibleStatesSize = 0x20;
+        int position = 0;
+        for (uint8_t count = 0; count < possibleState->possible_states_size &&
+                                count < maxPossibleStatesSize;
+             count++)
+        {
+            for (uint8_t bits = 0; bits < 8; bits++)
             {
-                possibleStates.possibleStateSetValues.emplace(position);
+                if (possibleState->states[count].byte & (0x01 << bits))
+                {
+                    possibleStates.possibleStateSetValues.emplace(position);
+                }
+                position++;
             }
-            position++;
         }
+        possibleStatesList.emplace_back(std::move(possibleStates));
+        offset += possibleStatesLen;
     }
 
     // Cache PDR for later use
     std::shared_ptr<StateSensorPDR> stateSensorPDR =
         std::make_shared<StateSensorPDR>();
     stateSensorPDR->stateSensorData = *sensorPDR;
-    // TODO: Multiple state sets in case of composite state sensor
-    stateSensorPDR->possibleStates.emplace_back(std::move(possibleStates));
+    stateSensorPDR->possibleStates = std::move(possibleStatesList);
     _stateSensorPDR.emplace(sensorID, std::move(stateSensorPDR));
 
     pldm_entity entity = {sensorPDR->entity_type, sensorPDR->entity_instance,
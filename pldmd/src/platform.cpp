@@ -15,51 +15,340 @@
  */
 #include "platform.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <phosphor-logging/log.hpp>
 
 namespace pldm
 {
 namespace platform
 {
-// TODO: Optimize poll interval
-static constexpr const int pollIntervalMillisec = 500;
-static constexpr const int pauseIntervalMillisec = 1;
+// Used when the PDR does not advertise a valid update interval
+static constexpr const std::chrono::milliseconds defaultPollInterval{1000};
+static constexpr const std::chrono::milliseconds minPollInterval{250};
+static constexpr const std::chrono::milliseconds maxPollInterval{60000};
+// Sensor reads allowed in flight towards one terminus
+static constexpr const size_t maxTerminusOutstandingRequests = 4;
 static Platform platform;
 
-bool Platform::induceAsyncDelay(boost::asio::yield_context yield, int delay)
+static const char* pauseReasonToString(const PollPauseReason reason)
+{
+    switch (reason)
+    {
+        case PollPauseReason::deviceInit:
+            return "DeviceInit";
+        case PollPauseReason::deviceRemoval:
+            return "DeviceRemoval";
+        case PollPauseReason::firmwareUpdate:
+            return "FirmwareUpdate";
+        case PollPauseReason::pdrRefresh:
+            return "PDRRefresh";
+        case PollPauseReason::dbusRequest:
+            return "DBusRequest";
+        case PollPauseReason::shutdown:
+            return "Shutdown";
+    }
+    return "Unknown";
+}
+
+// Paused poller waits on the sensor timer without expiry. There are no
+// wakeups till startSensorPolling() cancels the timer.
+void Platform::waitForResume(boost::asio::yield_context yield)
 {
     if (!sensorTimer)
     {
         throw std::runtime_error("Sensor poll timer not active");
     }
 
+    while (pauseDepth > 0)
+    {
+        boost::system::error_code ec;
+        sensorTimer->expires_at(PollClock::time_point::max());
+        sensorTimer->async_wait(yield[ec]);
+        if (ec && ec != boost::asio::error::operation_aborted)
+        {
+            throw std::runtime_error("Sensor poll timer failed");
+        }
+    }
+}
+
+static std::chrono::milliseconds getPollInterval(const float updateInterval)
+{
+    // Update interval in PDR is in seconds. Zero means not advertised
+    if (!std::isfinite(updateInterval) || updateInterval <= 0.0f)
+    {
+        return defaultPollInterval;
+    }
+    const float intervalMillisec = updateInterval * 1000.0f;
+    if (intervalMillisec < static_cast<float>(minPollInterval.count()))
+    {
+        return minPollInterval;
+    }
+    if (intervalMillisec > static_cast<float>(maxPollInterval.count()))
+    {
+        return maxPollInterval;
+    }
+    return std::chrono::milliseconds(
+        static_cast<std::chrono::milliseconds::rep>(intervalMillisec));
+}
+
+static bool isLaterDeadline(const SensorPollTask& lhs,
+                            const SensorPollTask& rhs)
+{
+    return lhs.deadline > rhs.deadline;
+}
+
+bool Platform::waitForDeadline(boost::asio::yield_context yield,
+                               boost::asio::steady_timer& timer,
+                               const PollClock::time_point deadline)
+{
+    if (deadline <= PollClock::now())
+    {
+        return true;
+    }
+
     boost::system::error_code ec;
-    sensorTimer->expires_after(boost::asio::chrono::milliseconds(delay));
-    sensorTimer->async_wait(yield[ec]);
+    timer.expires_at(deadline);
+    timer.async_wait(yield[ec]);
     if (ec == boost::asio::error::operation_aborted)
     {
         phosphor::logging::log<phosphor::logging::level::DEBUG>(
-            "Sensor poll timer aborted");
+            "Bus poll timer aborted");
         return false;
     }
     else if (ec)
     {
-        throw std::runtime_error("Sensor poll timer failed");
+        throw std::runtime_error("Bus poll timer failed");
     }
     return true;
 }
 
-// TODO: Dynamic sensor scanning
+bool Platform::pollSensor(boost::asio::yield_context yield,
+                          const SensorPollTask& task)
+{
+    if (task.isStateSensor)
+    {
+        auto it = task.terminus->stateSensors.find(task.sensorID);
+        if (it == task.terminus->stateSensors.end() ||
+            it->second->isSensorDisabled() || !it->second->sensorErrorCheck())
+        {
+            return false;
+        }
+        it->second->populateSensorValue(yield);
+        return true;
+    }
+
+    auto it = task.terminus->numericSensors.find(task.sensorID);
+    if (it == task.terminus->numericSensors.end() ||
+        it->second->isSensorDisabled() || !it->second->sensorErrorCheck())
+    {
+        return false;
+    }
+    it->second->populateSensorValue(yield);
+    return true;
+}
+
+// Up to maxTerminusOutstandingRequests of the sensors which are due are read in
+// parallel, so that the round trip latencies overlap.
+void Platform::pollTerminusSensors(boost::asio::yield_context yield,
+                                   const std::vector<SensorPollTask>& batch,
+                                   std::vector<bool>& activeSensors)
+{
+    activeSensors.assign(batch.size(), false);
+    auto readDone =
+        std::make_shared<boost::asio::steady_timer>(*getIoContext());
+    auto pendingReads = std::make_shared<size_t>(batch.size() - 1);
+
+    // A read failure must not unwind this frame while the parallel reads still
+    // refer the batch, thus every read is guarded the same way
+    auto readSensor = [this, &batch, &activeSensors](
+                          boost::asio::yield_context yieldRead, size_t index) {
+        try
+        {
+            activeSensors[index] = pollSensor(yieldRead, batch[index]);
+        }
+        catch (const std::exception& e)
+        {
+            phosphor::logging::log<phosphor::logging::level::ERR>(e.what());
+        }
+    };
+
+    for (size_t index = 1; index < batch.size(); index++)
+    {
+        boost::asio::spawn(
+            *getIoContext(),
+            [&readSensor, index, readDone,
+             pendingReads](boost::asio::yield_context yieldRead) {
+                readSensor(yieldRead, index);
+                if (--(*pendingReads) == 0)
+                {
+                    readDone->cancel();
+                }
+            });
+    }
+
+    readSensor(yield, 0);
+
+    // Parallel reads refer the batch, thus wait for all of them
+    while (*pendingReads > 0)
+    {
+        boost::system::error_code ec;
+        readDone->expires_at(PollClock::time_point::max());
+        readDone->async_wait(yield[ec]);
+    }
+}
+
+// Pop the sensor with the earliest deadline along with the other sensors of
+// the same terminus which are already due. This forms the read plan for one
+// iteration of the bus poller.
+static std::vector<SensorPollTask>
+    popTerminusBatch(std::vector<SensorPollTask>& tasks,
+                     const PollClock::time_point now)
+{
+    std::vector<SensorPollTask> batch;
+    std::pop_heap(tasks.begin(), tasks.end(), isLaterDeadline);
+    batch.emplace_back(std::move(tasks.back()));
+    tasks.pop_back();
+
+    const PollClock::time_point dueTime = std::max(now, batch[0].deadline);
+    auto it = tasks.begin();
+    while (it != tasks.end() && batch.size() < maxTerminusOutstandingRequests)
+    {
+        if (it->terminus == batch[0].terminus && it->deadline <= dueTime)
+        {
+            batch.emplace_back(std::move(*it));
+            it = tasks.erase(it);
+            continue;
+        }
+        ++it;
+    }
+    if (batch.size() > 1)
+    {
+        std::make_heap(tasks.begin(), tasks.end(), isLaterDeadline);
+    }
+    return batch;
+}
+
+// Sensors are polled in the order of their deadline. Next deadline is counted
+// from the completion of the reading, so an overloaded bus degrades to back
+// to back readings instead of building up a backlog.
+void Platform::pollBusSensors(boost::asio::yield_context yield,
+                              boost::asio::steady_timer& timer,
+                              std::vector<SensorPollTask> tasks)
+{
+    std::make_heap(tasks.begin(), tasks.end(), isLaterDeadline);
+    std::vector<bool> activeSensors;
+    while (!tasks.empty())
+    {
+        std::vector<SensorPollTask> batch =
+            popTerminusBatch(tasks, PollClock::now());
+
+        if (!waitForDeadline(yield, timer, batch[0].deadline) ||
+            stopSensorPoll)
+        {
+            return;
+        }
+
+        for (const SensorPollTask& task : batch)
+        {
+            auto staleness = PollClock::now() - task.deadline;
+            if (staleness > task.interval)
+            {
+                phosphor::logging::log<phosphor::logging::level::DEBUG>(
+                    "Sensor poll deadline missed",
+                    phosphor::logging::entry("SENSOR_ID=0x%0X", task.sensorID),
+                    phosphor::logging::entry(
+                        "DELAY_MS=%lld",
+                        static_cast<long long>(
+                            std::chrono::duration_cast<
+                                std::chrono::milliseconds>(staleness)
+                                .count())));
+            }
+        }
+
+        pollTerminusSensors(yield, batch, activeSensors);
+        if (stopSensorPoll)
+        {
+            return;
+        }
+
+        for (size_t index = 0; index < batch.size(); index++)
+        {
+            // Disabled or failed sensors are dropped till next poll session
+            if (!activeSensors[index])
+            {
+                continue;
+            }
+            SensorPollTask& task = batch[index];
+            task.deadline = PollClock::now() + task.interval;
+            tasks.push_back(std::move(task));
+            std::push_heap(tasks.begin(), tasks.end(), isLaterDeadline);
+        }
+    }
+}
+
+void Platform::spawnBusPoller(std::vector<SensorPollTask> tasks)
+{
+    auto timer = std::make_shared<boost::asio::steady_timer>(*getIoContext());
+    busPollTimers.emplace_back(timer);
+    activeBusPollers++;
+
+    boost::asio::spawn(
+        *getIoContext(), [this, timer, tasks{std::move(tasks)}](
+                             boost::asio::yield_context yield) mutable {
+            try
+            {
+                pollBusSensors(yield, *timer, std::move(tasks));
+            }
+            catch (const std::exception& e)
+            {
+                phosphor::logging::log<phosphor::logging::level::ERR>(
+                    e.what());
+            }
+
+            activeBusPollers--;
+            if (activeBusPollers == 0 && sensorTimer)
+            {
+                // Wake up the poll supervisor
+                sensorTimer->cancel();
+            }
+        });
+}
+
+void Platform::waitForBusPollers(boost::asio::yield_context yield)
+{
+    if (!sensorTimer)
+    {
+        throw std::runtime_error("Sensor poll timer not active");
+    }
+
+    while (activeBusPollers > 0)
+    {
+        boost::system::error_code ec;
+        sensorTimer->expires_at(PollClock::time_point::max());
+        sensorTimer->async_wait(yield[ec]);
+        if (ec && ec != boost::asio::error::operation_aborted)
+        {
+            throw std::runtime_error("Sensor poll timer failed");
+        }
+    }
+    busPollTimers.clear();
+}
+
 // As of today, PLDM is majorly used in Add-on-cards which is behind mux.
 // There can be M number of Add-on-cards and each one can have N
-// associated sensors. Which will result in higher number(M*N) of PLDM
-// message traffic through mux. In this case mux switching is a constraint.
-// Thus poll sensors sequentially.
+// associated sensors. Mux switching is a constraint only for the termini
+// sharing the same bus, thus run one poller per bus which reads the sensors
+// of its termini sequentially as per their deadlines. Pollers of different
+// buses run concurrently.
 void Platform::doPoll(boost::asio::yield_context yield)
 {
     isSensorPollRunning = false;
-    for (auto [tid, platformTerminus] : platforms)
+    std::map<std::optional<unsigned>, std::vector<SensorPollTask>> busTasks;
+    const PollClock::time_point now = PollClock::now();
+    for (auto const& [tid, platformTerminus] : platforms)
     {
+        std::vector<SensorPollTask>& tasks = busTasks[getTerminusBus(tid)];
         for (auto const& [sensorID, numericSensorHandler] :
              platformTerminus->numericSensors)
         {
@@ -71,17 +360,10 @@ void Platform::doPoll(boost::asio::yield_context yield)
             {
                 continue;
             }
-            isSensorPollRunning = true;
-
-            numericSensorHandler->populateSensorValue(yield);
-            if (!induceAsyncDelay(yield, pollIntervalMillisec))
-            {
-                return;
-            }
-            if (stopSensorPoll)
-            {
-                return;
-            }
+            tasks.push_back(
+                {now,
+                 getPollInterval(numericSensorHandler->getUpdateInterval()),
+                 platformTerminus, sensorID, false});
         }
         for (auto const& [sensorID, stateSensorHandler] :
              platformTerminus->stateSensors)
@@ -94,48 +376,49 @@ void Platform::doPoll(boost::asio::yield_context yield)
             {
                 continue;
             }
-            isSensorPollRunning = true;
+            // State sensor PDR does not carry an update interval
+            tasks.push_back(
+                {now, defaultPollInterval, platformTerminus, sensorID, true});
+        }
+    }
 
-            stateSensorHandler->populateSensorValue(yield);
-            if (!induceAsyncDelay(yield, pollIntervalMillisec))
-            {
-                return;
-            }
-            if (stopSensorPoll)
-            {
-                return;
-            }
+    for (auto& [bus, tasks] : busTasks)
+    {
+        if (tasks.empty())
+        {
+            continue;
         }
+        isSensorPollRunning = true;
+        spawnBusPoller(std::move(tasks));
     }
+
+    waitForBusPollers(yield);
 }
 
 // Sensor polling co-routine can have transactions in-flight when
 // stopSensorPolling() is called. Due to the same reason, there can be cases
 // where sensor polling loop will miss stopSensorPolling() function call if
 // startSensorPolling() is called before in-flight transactions time out.
-// Thus use seperate startSensorPoll and stopSensorPoll flag to synchronize
-// polling loop with caller.
+// Thus stopSensorPoll flag is cleared only by the polling loop when a new poll
+// session starts, while pauseDepth tells whether the session can start.
 void Platform::pollAllSensors()
 {
     boost::asio::spawn(
         *getIoContext(), [this](boost::asio::yield_context yield) {
             while (1)
             {
-                if (!startSensorPoll)
+                try
                 {
-                    try
-                    {
-                        induceAsyncDelay(yield, pauseIntervalMillisec);
-                        continue;
-                    }
-                    catch (const std::exception& e)
-                    {
-                        phosphor::logging::log<phosphor::logging::level::ERR>(
-                            e.what());
-                        return;
-                    }
+                    waitForResume(yield);
+                }
+                catch (const std::exception& e)
+                {
+                    phosphor::logging::log<phosphor::logging::level::ERR>(
+                        e.what());
+                    return;
                 }
 
+                stopSensorPoll = false;
                 do
                 {
                     try
@@ -157,14 +440,54 @@ void Platform::pollAllSensors()
                         return;
                     }
                 } while (!stopSensorPoll);
-                stopSensorPoll = false;
             }
         });
 }
 
-void Platform::startSensorPolling()
+void Platform::updatePauseProperties()
+{
+    if (!pausePollInterface)
+    {
+        return;
+    }
+
+    std::vector<std::string> reasons;
+    for (const auto& [reason, count] : pauseReasons)
+    {
+        if (count > 0)
+        {
+            reasons.emplace_back(pauseReasonToString(reason));
+        }
+    }
+    pausePollInterface->set_property("PauseDepth",
+                                     static_cast<uint32_t>(pauseDepth));
+    pausePollInterface->set_property("PauseReasons", reasons);
+}
+
+void Platform::startSensorPolling(const PollPauseReason reason)
 {
-    startSensorPoll = true;
+    auto it = pauseReasons.find(reason);
+    if (it == pauseReasons.end() || it->second == 0)
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "Sensor polling resume requested without matching pause",
+            phosphor::logging::entry("REASON=%s", pauseReasonToString(reason)));
+    }
+    else
+    {
+        it->second--;
+        pauseDepth--;
+        updatePauseProperties();
+    }
+
+    if (pauseDepth > 0)
+    {
+        phosphor::logging::log<phosphor::logging::level::DEBUG>(
+            "Sensor polling remains paused",
+            phosphor::logging::entry("REASON=%s", pauseReasonToString(reason)),
+            phosphor::logging::entry("DEPTH=%zu", pauseDepth));
+        return;
+    }
 
     if (!sensorTimer)
     {
@@ -174,27 +497,36 @@ void Platform::startSensorPolling()
     }
     else
     {
-        // This exit's the pause timer
+        // This exit's the pause wait
         sensorTimer->cancel();
     }
 
     phosphor::logging::log<phosphor::logging::level::INFO>(
-        "Sensor polling triggered");
+        "Sensor polling triggered",
+        phosphor::logging::entry("REASON=%s", pauseReasonToString(reason)));
 }
 
-void Platform::stopSensorPolling()
+void Platform::stopSensorPolling(const PollPauseReason reason)
 {
-    startSensorPoll = false;
+    pauseReasons[reason]++;
+    pauseDepth++;
     stopSensorPoll = true;
+    updatePauseProperties();
 
     if (sensorTimer)
     {
-        // This exit's the poll timer
+        // This exit's the poll timers
+        for (auto& timer : busPollTimers)
+        {
+            timer->cancel();
+        }
         sensorTimer->cancel();
     }
 
     phosphor::logging::log<phosphor::logging::level::INFO>(
-        "Sensor polling paused");
+        "Sensor polling paused",
+        phosphor::logging::entry("REASON=%s", pauseReasonToString(reason)),
+        phosphor::logging::entry("DEPTH=%zu", pauseDepth));
 }
 
 std::optional<UUID> getTerminusUID(boost::asio::yield_context yield,
@@ -235,8 +567,6 @@ std::optional<UUID> getTerminusUID(boost::asio::yield_context yield,
 
 void Platform::initializeSensorPollIntf()
 {
-    static std::unique_ptr<sdbusplus::asio::dbus_interface> pausePollInterface =
-        nullptr;
     if (pausePollInterface != nullptr)
     {
         phosphor::logging::log<phosphor::logging::level::DEBUG>(
@@ -247,18 +577,26 @@ void Platform::initializeSensorPollIntf()
     const char* objPath = "/xyz/openbmc_project/sensors";
     pausePollInterface =
         addUniqueInterface(objPath, "xyz.openbmc_project.PLDM.SensorPoll");
-    pausePollInterface->register_method("PauseSensorPoll",
-                                        [](const bool pause) {
-                                            if (pause)
-                                            {
-                                                pauseSensorPolling();
-                                            }
-                                            else
-                                            {
-                                                resumeSensorPolling();
-                                            }
-                                        });
+    pausePollInterface->register_method(
+        "PauseSensorPoll", [this](const bool pause) {
+            // Requests over D-Bus are not nested
+            auto it = pauseReasons.find(PollPauseReason::dbusRequest);
+            bool pausedByRequest = it != pauseReasons.end() && it->second > 0;
+            if (pause && !pausedByRequest)
+            {
+                pauseSensorPolling(PollPauseReason::dbusRequest);
+            }
+            else if (!pause)
+            {
+                resumeSensorPolling(PollPauseReason::dbusRequest);
+            }
+        });
+    pausePollInterface->register_property("PauseDepth",
+                                          static_cast<uint32_t>(pauseDepth));
+    pausePollInterface->register_property("PauseReasons",
+                                          std::vector<std::string>{});
     pausePollInterface->initialize();
+    updatePauseProperties();
 }
 
 void Platform::initializePlatformIntf()
@@ -278,9 +616,8 @@ void Platform::initializePlatformIntf()
     platformInterface->register_method(
         "RefreshPDR",
         [](boost::asio::yield_context yield, const pldm_tid_t tid) {
-            pauseSensorPolling();
+            SensorPollingPause pause(PollPauseReason::pdrRefresh);
             platformInit(yield, tid, {});
-            resumeSensorPolling();
         });
     platformInterface->initialize();
 }
@@ -361,25 +698,25 @@ bool Platform::deleteTerminus(const pldm_tid_t tid)
                 .c_str());
         return false;
     }
-    pauseSensorPolling();
+    pauseSensorPolling(PollPauseReason::deviceRemoval);
     platforms.erase(entry);
     phosphor::logging::log<phosphor::logging::level::INFO>(
         ("Platform Monitoring and Control resources deleted for TID " +
          std::to_string(tid))
             .c_str());
-    resumeSensorPolling();
+    resumeSensorPolling(PollPauseReason::deviceRemoval);
 
     return true;
 }
 
-void pauseSensorPolling()
+void pauseSensorPolling(const PollPauseReason reason)
 {
-    platform.stopSensorPolling();
+    platform.stopSensorPolling(reason);
 }
 
-void resumeSensorPolling()
+void resumeSensorPolling(const PollPauseReason reason)
 {
-    platform.startSensorPolling();
+    platform.startSensorPolling(reason);
 }
 
 bool platformInit(boost::asio::yield_context yield, const pldm_tid_t tid,
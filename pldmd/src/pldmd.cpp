@@ -48,6 +48,142 @@ void triggerDeviceDiscovery(const pldm_tid_t tid)
     }
 }
 
+static std::optional<unsigned> getEndpointBus(const mctpw_eid_t eid)
+{
+    if (!mctpWrapper)
+    {
+        return std::nullopt;
+    }
+    const mctpw::MCTPWrapper::EndpointMap& endpointMap =
+        mctpWrapper->getEndpointMap();
+    auto it = endpointMap.find(eid);
+    if (it == endpointMap.end())
+    {
+        return std::nullopt;
+    }
+    return it->second.first;
+}
+
+std::optional<unsigned> getTerminusBus(const pldm_tid_t tid)
+{
+    std::optional<mctpw_eid_t> eid = tidMapper.getMappedEID(tid);
+    if (!eid)
+    {
+        return std::nullopt;
+    }
+    return getEndpointBus(*eid);
+}
+
+/** @brief Slot for initializing a terminus, held for the whole init
+ *
+ * Construction suspends the coroutine until both the global and the per bus
+ * limit of concurrent initializations allow one more terminus.
+ */
+class InitSlot
+{
+  public:
+    InitSlot(boost::asio::yield_context yield, const mctpw_eid_t eid);
+    ~InitSlot();
+    InitSlot(const InitSlot&) = delete;
+    InitSlot& operator=(const InitSlot&) = delete;
+
+  private:
+    unsigned bus;
+};
+
+// Termini on the same bus share a mux, thus only one of them is initialized at
+// a time. Termini on different buses are initialized in parallel.
+constexpr size_t maxInitsPerBus = 1;
+constexpr size_t maxConcurrentInits = 8;
+// Endpoints with no known bus are serialized together
+constexpr unsigned unknownBus = std::numeric_limits<unsigned>::max();
+
+static size_t activeInits = 0;
+static std::unordered_map<unsigned, size_t> activeBusInits;
+static std::shared_ptr<boost::asio::steady_timer> initSlotTimer;
+
+InitSlot::InitSlot(boost::asio::yield_context yield, const mctpw_eid_t eid) :
+    bus(getEndpointBus(eid).value_or(unknownBus))
+{
+    if (!initSlotTimer)
+    {
+        // Never expires. Waiters are woken up by cancel when a slot is freed
+        initSlotTimer = std::make_shared<boost::asio::steady_timer>(
+            *getIoContext(), boost::asio::steady_timer::time_point::max());
+    }
+    while (activeInits >= maxConcurrentInits ||
+           activeBusInits[bus] >= maxInitsPerBus)
+    {
+        boost::system::error_code ec;
+        initSlotTimer->async_wait(yield[ec]);
+    }
+    ++activeInits;
+    ++activeBusInits[bus];
+}
+
+InitSlot::~InitSlot()
+{
+    --activeInits;
+    if (--activeBusInits[bus] == 0)
+    {
+        activeBusInits.erase(bus);
+    }
+    initSlotTimer->cancel();
+}
+
+static TransferSizes maxTransferSizes(maxPLDMMessageLen);
+
+static size_t getMediumTransferSize()
+{
+    if (mctpWrapper && mctpWrapper->config.bindingType ==
+                           mctpw::BindingType::mctpOverPcieVdm)
+    {
+        return maxPCIePLDMMessageLen;
+    }
+    return maxSMBusPLDMMessageLen;
+}
+
+size_t getMaxTransferSize(const pldm_tid_t tid)
+{
+    return maxTransferSizes.get(tid, getMediumTransferSize());
+}
+
+bool reduceMaxTransferSize(const pldm_tid_t tid, const PartFailure failure)
+{
+    if (!maxTransferSizes.reduce(tid, getMediumTransferSize(), failure))
+    {
+        return false;
+    }
+    phosphor::logging::log<phosphor::logging::level::INFO>(
+        "Reduced maximum transfer size",
+        phosphor::logging::entry("TID=%d", tid),
+        phosphor::logging::entry("SIZE=%zu", getMaxTransferSize(tid)));
+    return true;
+}
+
+void confirmMaxTransferSize(const pldm_tid_t tid, const bool succeeded)
+{
+    maxTransferSizes.confirm(tid, succeeded);
+}
+
+static void reportStartupTime(const std::chrono::milliseconds startupTime,
+                              const size_t terminusCount)
+{
+    phosphor::logging::log<phosphor::logging::level::INFO>(
+        "PLDM startup initialization complete",
+        phosphor::logging::entry("DURATION_MS=%lld",
+                                 static_cast<long long>(startupTime.count())),
+        phosphor::logging::entry("TERMINI=%zu", terminusCount));
+
+    static std::unique_ptr<sdbusplus::asio::dbus_interface> startupInterface =
+        addUniqueInterface(pldmPath, "xyz.openbmc_project.PLDM.Startup");
+    startupInterface->register_property(
+        "StartupTime", static_cast<uint64_t>(startupTime.count()));
+    startupInterface->register_property("TerminusCount",
+                                        utils::to_uint32(terminusCount));
+    startupInterface->initialize();
+}
+
 static bool validateReserveBW(const pldm_tid_t tid, const uint8_t pldmType)
 {
     return rsvBWActive && !(tid == reservedTID && pldmType == reservedPLDMType);
@@ -518,6 +654,8 @@ uint8_t createInstanceId(pldm_tid_t tid)
 
 void initDevice(const mctpw_eid_t eid, boost::asio::yield_context yield)
 {
+    pldm::InitSlot initSlot(yield, eid);
+
     phosphor::logging::log<phosphor::logging::level::INFO>(
         ("Initializing MCTP EID " + std::to_string(eid)).c_str());
 
@@ -575,6 +713,7 @@ void deleteDevice(const pldm_tid_t tid)
         pldm::platform::deleteMnCTerminus(tid);
     }
     pldm::base::deleteDeviceBaseInfo(tid);
+    pldm::maxTransferSizes.erase(tid);
 }
 
 // These are expected to be used only here, so declare them here
@@ -590,9 +729,9 @@ void onDeviceUpdate(void*, const mctpw::Event& evt,
     switch (evt.type)
     {
         case mctpw::Event::EventType::deviceAdded: {
-            pldm::platform::pauseSensorPolling();
+            pldm::platform::SensorPollingPause pause(
+                pldm::platform::PollPauseReason::deviceInit);
             initDevice(evt.eid, yield);
-            pldm::platform::resumeSensorPolling();
             break;
         }
         case mctpw::Event::EventType::deviceRemoved: {
@@ -641,7 +780,8 @@ int main(void)
     boost::asio::signal_set signals(*ioc, SIGINT, SIGTERM);
     signals.async_wait(
         [&ioc](const boost::system::error_code&, const int sigNum) {
-            pldm::platform::pauseSensorPolling();
+            pldm::platform::pauseSensorPolling(
+                pldm::platform::PollPauseReason::shutdown);
             pldm::TIDMapper::TIDMap tidMap = pldm::tidMapper.getTIDMap();
             for (auto& [tid, eid] : tidMap)
             {
@@ -670,15 +810,52 @@ int main(void)
         conn, config, onDeviceUpdate, pldm::msgRecvCallback);
 
     boost::asio::spawn(*ioc, [](boost::asio::yield_context yield) {
+        auto startTime = std::chrono::steady_clock::now();
         pldm::mctpWrapper->detectMctpEndpoints(yield);
         mctpw::MCTPWrapper::EndpointMap eidMap =
             pldm::mctpWrapper->getEndpointMap();
+
+        // Termini are initialized concurrently, bounded per bus by InitSlot
+        pldm::platform::pauseSensorPolling(
+            pldm::platform::PollPauseReason::deviceInit);
+        auto pendingInits = std::make_shared<size_t>(eidMap.size());
+        auto initDone = std::make_shared<boost::asio::steady_timer>(
+            *getIoContext(), boost::asio::steady_timer::time_point::max());
         for (auto& [eid, service] : eidMap)
         {
-            pldm::platform::pauseSensorPolling();
-            initDevice(eid, yield);
-            pldm::platform::resumeSensorPolling();
+            boost::asio::spawn(
+                *getIoContext(),
+                [eid = eid, pendingInits,
+                 initDone](boost::asio::yield_context initYield) {
+                    try
+                    {
+                        initDevice(eid, initYield);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        phosphor::logging::log<phosphor::logging::level::ERR>(
+                            "Terminus init failed",
+                            phosphor::logging::entry("EID=%d", eid),
+                            phosphor::logging::entry("ERROR=%s", e.what()));
+                    }
+                    if (--(*pendingInits) == 0)
+                    {
+                        initDone->cancel();
+                    }
+                });
+        }
+        if (*pendingInits != 0)
+        {
+            boost::system::error_code ec;
+            initDone->async_wait(yield[ec]);
         }
+        pldm::platform::resumeSensorPolling(
+            pldm::platform::PollPauseReason::deviceInit);
+
+        pldm::reportStartupTime(
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - startTime),
+            eidMap.size());
     });
 
     ioc->run();
@@ -49,13 +49,33 @@ void StateSensorHandler::setInitialProperties()
 
     sensorInterface =
         addUniqueInterface(path, "xyz.openbmc_project.Sensor.State");
-    // Composite sensors are not supported. Thus extract only first sensor
-    // states
+    // First instance of a composite sensor is exposed on the sensor path
     sensorInterface->register_property("StateSetID",
                                        _pdr->possibleStates[0].stateSetID);
     sensorInterface->register_property(
         "PossibleStates", _pdr->possibleStates[0].possibleStateSetValues);
 
+    // Rest of the composite sensor instances are exposed as
+    // <sensor path>_<index>
+    for (size_t index = 1; index < _pdr->possibleStates.size(); index++)
+    {
+        CompositeSensorState compositeState;
+        compositeState.sensorInterface =
+            addUniqueInterface(path + "_" + std::to_string(index),
+                               "xyz.openbmc_project.Sensor.State");
+        compositeState.sensorInterface->register_property(
+            "StateSetID", _pdr->possibleStates[index].stateSetID);
+        compositeState.sensorInterface->register_property(
+            "PossibleStates",
+            _pdr->possibleStates[index].possibleStateSetValues);
+        compositeState.sensorInterface->register_property(
+            "PreviousState", compositeState.previousStateReading);
+        compositeState.sensorInterface->register_property(
+            "CurrentState", compositeState.currentStateReading);
+        compositeState.sensorInterface->initialize();
+        compositeStates.emplace_back(std::move(compositeState));
+    }
+
     availableInterface = addUniqueInterface(
         path, "xyz.openbmc_project.State.Decorator.Availability");
 
@@ -112,6 +132,12 @@ void StateSensorHandler::markFunctional(bool isFunctional)
     else
     {
         updateState(PLDM_INVALID_VALUE, PLDM_INVALID_VALUE);
+        for (size_t index = 1; index <= compositeStates.size(); index++)
+        {
+            updateCompositeState(index, {PLDM_SENSOR_UNAVAILABLE,
+                                         PLDM_INVALID_VALUE, PLDM_INVALID_VALUE,
+                                         PLDM_INVALID_VALUE});
+        }
     }
 }
 
@@ -161,10 +187,12 @@ bool StateSensorHandler::sensorErrorCheck()
     return errCount < errorThreshold;
 }
 
-void StateSensorHandler::logStateChangeEvent(const uint8_t currentState,
+void StateSensorHandler::logStateChangeEvent(const size_t compositeIndex,
+                                             const uint8_t currentState,
                                              const uint8_t previousState)
 {
-    auto stateSetItr = stateSetMap.find(_pdr->possibleStates[0].stateSetID);
+    auto stateSetItr =
+        stateSetMap.find(_pdr->possibleStates[compositeIndex].stateSetID);
     if (stateSetItr == stateSetMap.end())
     {
         return;
@@ -189,10 +217,15 @@ void StateSensorHandler::logStateChangeEvent(const uint8_t currentState,
     StateSetValueInfo const& previousStateSetValueInfo =
         previousStateSetValueItr->second;
 
+    std::string sensorName = _name;
+    if (compositeIndex > 0)
+    {
+        sensorName += "_" + std::to_string(compositeIndex);
+    }
     std::string messageID =
         "OpenBMC.0.1." + std::string(currentStateSetValueInfo.redfishMessageID);
     std::string message =
-        std::string(stateSetName) + " of " + _name +
+        std::string(stateSetName) + " of " + sensorName +
         " state sensor changed from " +
         std::string(previousStateSetValueInfo.stateSetValueName) + " to " +
         std::string(currentStateSetValueInfo.stateSetValueName);
@@ -201,7 +234,7 @@ void StateSensorHandler::logStateChangeEvent(const uint8_t currentState,
         message.c_str(),
         phosphor::logging::entry("REDFISH_MESSAGE_ID=%s", messageID.c_str()),
         phosphor::logging::entry("REDFISH_MESSAGE_ARGS=%s,%s,%s,%s",
-                                 stateSetName, _name.c_str(),
+                                 stateSetName, sensorName.c_str(),
                                  previousStateSetValueInfo.stateSetValueName,
                                  currentStateSetValueInfo.stateSetValueName));
 }
@@ -230,7 +263,7 @@ void StateSensorHandler::updateState(const uint8_t currentState,
             (previousStateReading != previousState &&
              previousState != PLDM_INVALID_VALUE))
         {
-            logStateChangeEvent(currentState, previousState);
+            logStateChangeEvent(0, currentState, previousState);
         }
         sensorInterface->set_property("CurrentState", currentState);
         sensorInterface->set_property("PreviousState", previousState);
@@ -246,6 +279,39 @@ void StateSensorHandler::updateState(const uint8_t currentState,
     }
 }
 
+void StateSensorHandler::updateCompositeState(
+    const size_t compositeIndex, const get_sensor_state_field& stateReading)
+{
+    if (compositeIndex == 0 || compositeIndex > compositeStates.size())
+    {
+        return;
+    }
+    CompositeSensorState& compositeState = compositeStates[compositeIndex - 1];
+
+    uint8_t currentState = PLDM_INVALID_VALUE;
+    uint8_t previousState = PLDM_INVALID_VALUE;
+    if (stateReading.sensor_op_state == PLDM_SENSOR_ENABLED)
+    {
+        currentState = stateReading.present_state;
+        previousState = stateReading.previous_state;
+    }
+
+    // No state change event for the very first reading
+    if (compositeState.currentStateReading != PLDM_INVALID_VALUE &&
+        ((compositeState.currentStateReading != currentState &&
+          currentState != PLDM_INVALID_VALUE) ||
+         (compositeState.previousStateReading != previousState &&
+          previousState != PLDM_INVALID_VALUE)))
+    {
+        logStateChangeEvent(compositeIndex, currentState, previousState);
+    }
+    compositeState.sensorInterface->set_property("CurrentState", currentState);
+    compositeState.sensorInterface->set_property("PreviousState",
+                                                 previousState);
+    compositeState.currentStateReading = currentState;
+    compositeState.previousStateReading = previousState;
+}
+
 bool StateSensorHandler::handleSensorReading(
     get_sensor_state_field& stateReading)
 {
@@ -328,12 +394,15 @@ bool StateSensorHandler::setStateSensorEnables(boost::asio::yield_context yield)
     }
 
     int rc;
-    // TODO: PLDM events and composite sensor support
-    constexpr uint8_t compositeSensorCount = 1;
-    std::array<state_sensor_op_field, compositeSensorCount> opFields = {
-        {sensorOpState, PLDM_NO_EVENT_GENERATION}};
+    // TODO: PLDM events support
+    uint8_t compositeSensorCount =
+        static_cast<uint8_t>(_pdr->possibleStates.size());
+    std::vector<state_sensor_op_field> opFields(
+        compositeSensorCount, {sensorOpState, PLDM_NO_EVENT_GENERATION});
     std::vector<uint8_t> req(pldmMsgHdrSize +
-                             sizeof(pldm_set_state_sensor_enable_req));
+                             sizeof(pldm_set_state_sensor_enable_req) +
+                             (compositeSensorCount - 1) *
+                                 sizeof(state_sensor_op_field));
     pldm_msg* reqMsg = reinterpret_cast<pldm_msg*>(req.data());
 
     // TODO: Init state as per State Sensor Initialization PDR
@@ -381,7 +450,7 @@ bool StateSensorHandler::getStateSensorReadings(
     std::vector<uint8_t> req(pldmMsgHdrSize +
                              PLDM_GET_STATE_SENSOR_READINGS_REQ_BYTES);
     pldm_msg* reqMsg = reinterpret_cast<pldm_msg*>(req.data());
-    // PLDM events and composite sensor are not supported
+    // PLDM events are not supported
     constexpr bitfield8_t sensorRearm = {0x00};
     constexpr uint8_t reserved = 0x00;
 
@@ -404,9 +473,9 @@ bool StateSensorHandler::getStateSensorReadings(
     }
 
     uint8_t completionCode;
-    // Pass compositeSensorCount as 1 to indicate that only one sensor instance
-    // is supported
-    uint8_t compositeSensorCount = 1;
+    // One response carries the states of every composite sensor instance
+    uint8_t compositeSensorCount =
+        static_cast<uint8_t>(_pdr->possibleStates.size());
     constexpr size_t maxCompositeSensorCount = 0x08;
     std::array<get_sensor_state_field, maxCompositeSensorCount> stateField{};
     auto rspMsg = reinterpret_cast<pldm_msg*>(resp.data());
@@ -420,7 +489,19 @@ bool StateSensorHandler::getStateSensorReadings(
         return false;
     }
 
-    // Handle only first value. Composite sensor not supported.
+    if (compositeSensorCount != _pdr->possibleStates.size())
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "GetStateSensorReadings: Composite sensor count mismatch",
+            phosphor::logging::entry("SENSOR_ID=0x%0X", _sensorID),
+            phosphor::logging::entry("TID=%d", _tid),
+            phosphor::logging::entry("COUNT=%d", compositeSensorCount));
+    }
+
+    for (size_t index = 1; index < compositeSensorCount; index++)
+    {
+        updateCompositeState(index, stateField[index]);
+    }
     return handleSensorReading(stateField[0]);
 }
 
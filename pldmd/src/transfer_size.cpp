@@ -0,0 +1,86 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "transfer_size.hpp"
+
+#include <algorithm>
+
+namespace pldm
+{
+
+bool isPartSizeError(const int rc, const uint8_t completionCode)
+{
+    return rc == PLDM_ERROR_INVALID_LENGTH ||
+           completionCode == PLDM_ERROR_INVALID_LENGTH;
+}
+
+TransferSizes::TransferSizes(const size_t minSizeVal) : minSize(minSizeVal)
+{
+}
+
+size_t TransferSizes::get(const pldm_tid_t tid, const size_t initialSize) const
+{
+    auto it = sizes.find(tid);
+    if (it != sizes.end())
+    {
+        return it->second;
+    }
+    return initialSize;
+}
+
+bool TransferSizes::reduce(const pldm_tid_t tid, const size_t initialSize,
+                           const PartFailure failure)
+{
+    if (failure == PartFailure::invalidResponse ||
+        trialFallbacks.count(tid) != 0)
+    {
+        return false;
+    }
+    size_t size = get(tid, initialSize);
+    if (size <= minSize)
+    {
+        return false;
+    }
+    if (failure == PartFailure::noResponse)
+    {
+        trialFallbacks.emplace(tid, size);
+        sizes.insert_or_assign(tid, minSize);
+        return true;
+    }
+    sizes.insert_or_assign(tid, std::max(size / 2, minSize));
+    return true;
+}
+
+void TransferSizes::confirm(const pldm_tid_t tid, const bool succeeded)
+{
+    auto it = trialFallbacks.find(tid);
+    if (it == trialFallbacks.end())
+    {
+        return;
+    }
+    if (!succeeded)
+    {
+        sizes.insert_or_assign(tid, it->second);
+    }
+    trialFallbacks.erase(it);
+}
+
+void TransferSizes::erase(const pldm_tid_t tid)
+{
+    sizes.erase(tid);
+    trialFallbacks.erase(tid);
+}
+
+} // namespace pldm
@@ -0,0 +1,87 @@
+#include "transfer_size.hpp"
+
+#include <gtest/gtest.h>
+
+static constexpr size_t initialSize = 508;
+static constexpr size_t minSize = 60;
+static constexpr pldm_tid_t tid = 1;
+
+TEST(TransferSizesTest, StartsAtInitialSize)
+{
+    pldm::TransferSizes sizes(minSize);
+
+    EXPECT_EQ(sizes.get(tid, initialSize), initialSize);
+}
+
+TEST(TransferSizesTest, TimeoutRetriedAtMinimumKeepsIt)
+{
+    pldm::TransferSizes sizes(minSize);
+
+    EXPECT_TRUE(sizes.reduce(tid, initialSize, pldm::PartFailure::noResponse));
+    EXPECT_EQ(sizes.get(tid, initialSize), minSize);
+    sizes.confirm(tid, true);
+    EXPECT_EQ(sizes.get(tid, initialSize), minSize);
+}
+
+TEST(TransferSizesTest, TimeoutRetriedAtMinimumOnce)
+{
+    pldm::TransferSizes sizes(minSize);
+
+    ASSERT_TRUE(sizes.reduce(tid, initialSize, pldm::PartFailure::partSize));
+    EXPECT_TRUE(sizes.reduce(tid, initialSize, pldm::PartFailure::noResponse));
+    EXPECT_EQ(sizes.get(tid, initialSize), minSize);
+
+    // The retry failed as well, the terminus is not size limited after all
+    EXPECT_FALSE(
+        sizes.reduce(tid, initialSize, pldm::PartFailure::noResponse));
+    sizes.confirm(tid, false);
+    EXPECT_EQ(sizes.get(tid, initialSize), initialSize / 2);
+
+    // Nothing is on trial anymore
+    sizes.confirm(tid, true);
+    EXPECT_EQ(sizes.get(tid, initialSize), initialSize / 2);
+}
+
+TEST(TransferSizesTest, InvalidResponseKeepsSize)
+{
+    pldm::TransferSizes sizes(minSize);
+
+    EXPECT_FALSE(
+        sizes.reduce(tid, initialSize, pldm::PartFailure::invalidResponse));
+    EXPECT_EQ(sizes.get(tid, initialSize), initialSize);
+}
+
+TEST(TransferSizesTest, PartSizeFailureHalvesDownToMinimum)
+{
+    pldm::TransferSizes sizes(minSize);
+
+    EXPECT_TRUE(sizes.reduce(tid, initialSize, pldm::PartFailure::partSize));
+    EXPECT_EQ(sizes.get(tid, initialSize), initialSize / 2);
+    EXPECT_TRUE(sizes.reduce(tid, initialSize, pldm::PartFailure::partSize));
+    EXPECT_TRUE(sizes.reduce(tid, initialSize, pldm::PartFailure::partSize));
+    EXPECT_EQ(sizes.get(tid, initialSize), initialSize / 8);
+    EXPECT_TRUE(sizes.reduce(tid, initialSize, pldm::PartFailure::partSize));
+    EXPECT_EQ(sizes.get(tid, initialSize), minSize);
+    EXPECT_FALSE(sizes.reduce(tid, initialSize, pldm::PartFailure::partSize));
+    EXPECT_EQ(sizes.get(tid, initialSize), minSize);
+
+    // Other termini keep their own size
+    EXPECT_EQ(sizes.get(tid + 1, initialSize), initialSize);
+}
+
+TEST(TransferSizesTest, EraseForgetsNegotiatedSize)
+{
+    pldm::TransferSizes sizes(minSize);
+
+    ASSERT_TRUE(sizes.reduce(tid, initialSize, pldm::PartFailure::partSize));
+    sizes.erase(tid);
+    EXPECT_EQ(sizes.get(tid, initialSize), initialSize);
+}
+
+TEST(TransferSizesTest, ClassifiesPartSizeErrors)
+{
+    EXPECT_TRUE(pldm::isPartSizeError(PLDM_ERROR_INVALID_LENGTH, PLDM_SUCCESS));
+    EXPECT_TRUE(pldm::isPartSizeError(PLDM_SUCCESS, PLDM_ERROR_INVALID_LENGTH));
+    EXPECT_FALSE(pldm::isPartSizeError(PLDM_SUCCESS, PLDM_ERROR));
+    EXPECT_FALSE(pldm::isPartSizeError(PLDM_ERROR_INVALID_DATA, PLDM_SUCCESS));
+}